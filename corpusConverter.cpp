@@ -0,0 +1,120 @@
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "GetPixels.h"
+#include "ImageLoader.h"
+#include "ImageCorpus.h"
+using namespace csc450Lib_linalg_base;
+
+/**
+ * Converts a directory of face images, either the text dumps of
+ *  doc/facetext or the GIFs of doc/yalefaces (or PGM/PPM files), into a
+ *  binary ImageCorpus. Files are named subject<id><label>.<ext>; each
+ *  image is cropped to its centered height x height square, as
+ *  GetPixels::getPixelSquare does. Images are decoded by an ImageLoader
+ *
+ *  usage: corpus.out <input directory> <output file> [uint8]
+ */
+
+static bool endsWith(const string &s, const string &suffix) {
+    return s.size() >= suffix.size()
+        && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/**
+ * Reads the centered square of a text dump into square (resized to fit),
+ *  returns its side, or 0 on failure
+ */
+static int readTextSquare(const string &path, vector<float> &square) {
+    int width = 320, height = 243;
+    square.resize((size_t)height * height);
+    return GetPixels::readPixelSquare(path, square.data(), width, height)
+        ? height : 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        cout << "usage: " << argv[0]
+             << " <input directory> <output file> [uint8]\n";
+        return 1;
+    }
+    string dir = string(argv[1]) + "/";
+    PixelFormat format = (argc > 3 && string(argv[3]) == "uint8")
+        ? PIXEL_UINT8 : PIXEL_FLOAT32;
+    
+    // Image files, in name order so that corpora are reproducible. Text
+    //  dumps are used only when there are no images
+    vector<string> names;
+    for (const string &path : ImageLoader::list(dir))
+        names.push_back(path.substr(dir.size()));
+    bool text = names.empty();
+    if (text)
+        GetPixels::getdir(dir, names);
+    vector<string> files;
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i].compare(0, 7, "subject") == 0
+            && (!text || endsWith(names[i], ".txt")))
+            files.push_back(names[i]);
+    }
+    if (files.empty()) {
+        cout << "No images in " << dir << "\n";
+        return 1;
+    }
+    
+    // subject<id><label>.ext
+    vector<int> ids;
+    vector<string> labels;
+    for (size_t i = 0; i < files.size(); i++) {
+        size_t dot = files[i].rfind('.');
+        string stem = files[i].substr(7, dot - 7);
+        size_t digits = 0;
+        while (digits < stem.size() && isdigit(stem[digits]))
+            digits++;
+        ids.push_back(digits > 0 ? stoi(stem.substr(0, digits)) : 0);
+        labels.push_back(stem.substr(digits));
+    }
+    
+    try {
+        ImageCorpus *corpus = NULL;
+        if (text) {
+            vector<float> square;
+            for (size_t i = 0; i < files.size(); i++) {
+                int side = readTextSquare(dir + files[i], square);
+                if (corpus == NULL && side > 0)
+                    corpus = ImageCorpus::create(argv[2], side, side,
+                                                 ids, labels, format);
+                if (side == 0 || side != corpus->getWidth()) {
+                    cout << "Cannot read " << files[i] << "\n";
+                    delete corpus;
+                    return 1;
+                }
+                corpus->setImage((int)i, square.data());
+            }
+        } else {
+            vector<string> paths;
+            for (size_t i = 0; i < files.size(); i++)
+                paths.push_back(dir + files[i]);
+            ImageLoader loader;
+            loader.setCenterCrop(true);
+            loader.stream(paths, [&](int i, const ImageLoader::Image &image) {
+                if (corpus == NULL)
+                    corpus = ImageCorpus::create(argv[2], image.width,
+                                                 image.height, ids, labels,
+                                                 format);
+                if (image.width != corpus->getWidth()
+                    || image.height != corpus->getHeight())
+                    throw "Images differ in size";
+                corpus->setImage(i, image.floats());
+            });
+        }
+        cout << "Wrote " << files.size() << " images of "
+             << corpus->getWidth() << " x " << corpus->getHeight()
+             << " to " << argv[2] << "\n";
+        delete corpus;
+    } catch (const char *e) {
+        cout << e << "\n";
+        return 1;
+    }
+    return 0;
+}
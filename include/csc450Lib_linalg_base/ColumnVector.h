@@ -37,6 +37,12 @@ namespace csc450Lib_linalg_base {
          */
         ColumnVector(int nbRows);
         
+        /**
+         * Creates a column vector viewing existing storage, element i being
+         *  at data[i * ld]. The vector does not own the buffer
+         */
+        ColumnVector(int nbRows, float * data, int ld);
+        
         /**
          * Returns the value of the element at the position specified
          */
@@ -70,5 +76,13 @@ namespace csc450Lib_linalg_base {
          */
         float normInf(void) const;
     };
+    
+    inline float ColumnVector::get(int theRow) const {
+        return data[(size_t)theRow * ld];
+    }
+    
+    inline void ColumnVector::set(int theRow, float theVal) const {
+        data[(size_t)theRow * ld] = theVal;
+    }
 }
 #endif /* defined(____ColumnVector_included__) */
\ No newline at end of file
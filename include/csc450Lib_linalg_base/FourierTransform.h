@@ -0,0 +1,47 @@
+//
+//  FourierTransform.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____FourierTransform_included__
+#define ____FourierTransform_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <complex>
+
+namespace csc450Lib_linalg_base {
+
+    /**
+     * Radix-2 fast Fourier transforms, in double precision and in place.
+     *  Sizes must be powers of two. The inverse transforms are scaled by
+     *  1 / n, so that a forward then an inverse transform gives back the
+     *  input
+     */
+    class FourierTransform {
+    public:
+
+        /** Returns the smallest power of two that is at least n */
+        static int size(int n);
+
+        /** Transforms the n values of data, n a power of two */
+        static void transform(std::complex<double> *data, int n, bool inverse);
+
+        /**
+         * Transforms a rows x cols array, row after row, both sizes powers
+         *  of two. Rows, then columns, are shared out among the
+         *  TaskScheduler threads
+         */
+        static void transform2D(std::complex<double> *data, int rows, int cols,
+                                bool inverse);
+    };
+}
+#endif /* defined(____FourierTransform_included__) */
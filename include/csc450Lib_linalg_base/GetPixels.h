@@ -66,6 +66,19 @@ namespace csc450Lib_linalg_base {
         static float** getPixelSquare(string filename,
                                       int width = 320, int height = 243);
 
+		/*
+		*	Reads the centered height x height square of the given file into
+		*	dest, row after row
+		*	@param filename the path to the file to read
+		*	@param dest storage for height * height floats
+		*	@param width the width of the image
+		*	@param height the height of the image
+		*	return false if the file could not be read or holds fewer than
+		*	width * height values
+		*/
+        static bool readPixelSquare(string filename, float *dest,
+                                    int width = 320, int height = 243);
+
 		/*
 		*	Store the Pixel Data from a file into a 2D array of floats
 		*	@param filename the path to the file to get pixel data from
@@ -77,7 +90,8 @@ namespace csc450Lib_linalg_base {
                                       int width = 320, int height = 243);
         
 		/*
-		*	Gets all the files in the given directory and stores the names and paths to a vector
+		*	Gets all the files in the given directory and stores the names and paths to a vector,
+		*	sorted by name
 		*	@param dir the directory to search for files
 		*	@param files the vector to store all filenames into
 		*	return 0 if success, ANY if failure
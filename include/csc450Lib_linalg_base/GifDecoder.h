@@ -0,0 +1,59 @@
+//
+//  GifDecoder.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____GifDecoder_included__
+#define ____GifDecoder_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <stddef.h>
+#include <string>
+
+namespace csc450Lib_linalg_base {
+    
+    /**
+     * Minimal decoder for GIF87a/GIF89a files: reads the first image of the
+     *  file (LZW, interlaced or not) and maps its palette to gray levels
+     */
+    class GifDecoder {
+    public:
+        
+        /**
+         * Decodes the first image of a GIF file into 8-bit gray levels,
+         *  row after row
+         *
+         * @param filename
+         *          The path to the GIF file
+         *
+         * @param width
+         *          Receives the width of the image
+         *
+         * @param height
+         *          Receives the height of the image
+         *
+         * @return
+         *          A new[]-allocated array of width * height gray levels,
+         *          or NULL if the file could not be read or decoded
+         */
+        static unsigned char* decode(const std::string &filename,
+                                     int *width, int *height);
+        
+        /**
+         * Decodes the first image of a GIF file already read into memory,
+         *  as the other decode()
+         */
+        static unsigned char* decode(const unsigned char *file, size_t length,
+                                     int *width, int *height);
+    };
+}
+#endif /* defined(____GifDecoder_included__) */
@@ -0,0 +1,137 @@
+//
+//  ImageCorpus.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____ImageCorpus_included__
+#define ____ImageCorpus_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "Matrix.h"
+#include "ColumnVector.h"
+#include "PixelFormat.h"
+
+namespace csc450Lib_linalg_base {
+    
+    /**
+     * A gallery of equally sized gray images packed in one binary file and
+     *  memory-mapped. The file holds a 64-byte header (magic "EFCORPUS",
+     *  version, pixel format, width, height, number of images, label
+     *  length and offset of the pixels), then one 32-bit subject id and
+     *  one fixed-length label per image, then the pixels at a 64-byte
+     *  aligned offset. All fields are little-endian.
+     *
+     * Pixels are stored pixel-major: the value of pixel p in image i is at
+     *  index p * count + i. This is the row-major layout of the matrix
+     *  with one image per column, so for float corpora the mapping is the
+     *  training matrix and images are handed out as zero-copy column views
+     */
+    class ImageCorpus {
+    private:
+        /** Start of the mapping */
+        unsigned char *base;
+        
+        /** Length of the mapping in bytes */
+        size_t length;
+        
+        /** Whether the mapping is written back to the file */
+        bool writable;
+        
+        PixelFormat format;
+        int width;
+        int height;
+        int count;
+        int labelLength;
+        
+        /** Start of the subject ids */
+        int32_t *ids;
+        
+        /** Start of the labels */
+        char *labels;
+        
+        /** Start of the pixels */
+        unsigned char *pixels;
+        
+        ImageCorpus(void);
+        
+        /** Points the member arrays into the mapping */
+        void locate(size_t pixelOffset);
+        
+    public:
+        
+        /**
+         * Maps an existing corpus file. Throws if the file cannot be opened
+         *  or is not a corpus
+         */
+        ImageCorpus(const std::string &filename);
+        
+        /**
+         * Unmaps the file, flushing it first for corpora being written
+         */
+        ~ImageCorpus(void);
+        
+        /**
+         * Creates a corpus file for count = ids.size() images of the given
+         *  size, with their subject ids and labels (truncated to 31
+         *  characters), and maps it for writing with setImage()
+         */
+        static ImageCorpus* create(const std::string &filename,
+                                   int width, int height,
+                                   const std::vector<int> &ids,
+                                   const std::vector<std::string> &labels,
+                                   PixelFormat format = PIXEL_FLOAT32);
+        
+        /**
+         * Stores image i from width * height gray levels in [0, 1], row
+         *  after row
+         */
+        void setImage(int i, const float *values);
+        
+        /** Returns the number of images */
+        int size(void) const;
+        
+        /** Returns the width of the images */
+        int getWidth(void) const;
+        
+        /** Returns the height of the images */
+        int getHeight(void) const;
+        
+        /** Returns the storage format of the pixels */
+        PixelFormat getFormat(void) const;
+        
+        /** Returns the subject id of image i */
+        int getSubjectID(int i) const;
+        
+        /** Returns the label of image i */
+        std::string getLabel(int i) const;
+        
+        /**
+         * Returns the (width * height) x size() matrix of the images, one
+         *  per column. For float corpora this is a view of the mapping and
+         *  copies nothing (deleting it leaves the mapping alone, and it
+         *  must not outlive the corpus); byte corpora are converted into
+         *  a new matrix
+         */
+        Matrix* getImages(void) const;
+        
+        /**
+         * Returns image i as a column vector: a zero-copy view for float
+         *  corpora, a converted copy for byte corpora
+         */
+        ColumnVector* getImage(int i) const;
+    };
+}
+#endif /* defined(____ImageCorpus_included__) */
@@ -0,0 +1,154 @@
+//
+//  ImageLoader.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____ImageLoader_included__
+#define ____ImageLoader_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ImagePreprocessor.h"
+#include "Matrix.h"
+#include "PixelFormat.h"
+
+namespace csc450Lib_linalg_base {
+
+    /**
+     * Reads galleries of GIF, PGM and PPM images straight into face
+     *  vectors. Each decoded image goes through an ImagePreprocessor
+     *  (centered crop, resampling, histogram equalization, normalization),
+     *  whose single pass also converts the gray levels to the output format,
+     *  so no full-size float image is ever made.
+     *
+     * Files are read and decoded by a bounded pool of threads of its own,
+     *  which stays at most readAhead images ahead of the consumer. Images
+     *  are still delivered in the order of the file list
+     */
+    class ImageLoader {
+    public:
+
+        /**
+         * A decoded image: width * height values, row after row, as floats
+         *  in [0, 1] or as bytes holding round(255 * value)
+         */
+        struct Image {
+            int width;
+            int height;
+            PixelFormat format;
+            std::vector<unsigned char> data;
+
+            /** Returns the values of a PIXEL_FLOAT32 image */
+            const float* floats(void) const {
+                return (const float*)data.data();
+            }
+
+            /** Returns the values of a PIXEL_UINT8 image */
+            const unsigned char* bytes(void) const {
+                return data.data();
+            }
+        };
+
+    private:
+        /** Number of decoder threads */
+        int threads;
+
+        /** Most images decoded ahead of the consumer */
+        int readAhead;
+
+        /** Format of the delivered images */
+        PixelFormat format;
+
+        /** What is done to every decoded image */
+        ImagePreprocessor preprocessor;
+
+    public:
+
+        /**
+         * Builds a loader
+         *
+         * @param threads
+         *          Number of decoder threads; 0 uses one per hardware thread
+         *
+         * @param readAhead
+         *          Most images decoded but not yet consumed; 0 allows four
+         *          per thread
+         *
+         * @param format
+         *          Format of the delivered images
+         */
+        ImageLoader(int threads = 0, int readAhead = 0,
+                    PixelFormat format = PIXEL_FLOAT32);
+
+        /** Crops every image to its centered square (off by default) */
+        void setCenterCrop(bool centerCrop);
+
+        /** Averages factor x factor blocks into one pixel (1 by default) */
+        void setDownsample(int factor);
+
+        /**
+         * Replaces every preprocessing setting. Throws if the images would
+         *  be normalized but the format is PIXEL_UINT8
+         */
+        void setPreprocessor(const ImagePreprocessor &preprocessor);
+
+        /** Returns the preprocessing settings */
+        const ImagePreprocessor& getPreprocessor(void) const;
+
+        /**
+         * Returns the paths of the GIF, PGM and PPM files of a directory,
+         *  sorted by name so that galleries load in the same order on
+         *  every system. Throws if the directory cannot be read
+         */
+        static std::vector<std::string> list(const std::string &dir);
+
+        /**
+         * Decodes a GIF, PGM or PPM file already read into memory, picking
+         *  the decoder from its first bytes
+         *
+         * @return
+         *          A new[]-allocated array of width * height gray levels,
+         *          or NULL if the file could not be decoded
+         */
+        static unsigned char* decode(const unsigned char *file, size_t length,
+                                     int *width, int *height);
+
+        /**
+         * Reads, decodes and preprocesses one file on the calling thread
+         *
+         * @return
+         *          false if the file could not be read or decoded
+         */
+        bool read(const std::string &filename, Image &image) const;
+
+        /**
+         * Loads the files on the decoder threads and hands them to consumer
+         *  in list order, with their index. Throws if a file cannot be
+         *  read; an exception thrown by consumer stops the loading and is
+         *  passed on
+         */
+        void stream(const std::vector<std::string> &files,
+                    const std::function<void(int, const Image&)> &consumer) const;
+
+        /**
+         * Loads the files into a new (pixels x files) matrix, one image per
+         *  column, as floats whatever the format. The decoder threads
+         *  preprocess each image straight into its column. Throws if a file
+         *  cannot be read or the images differ in size
+         */
+        Matrix* load(const std::vector<std::string> &files) const;
+    };
+}
+#endif /* defined(____ImageLoader_included__) */
@@ -0,0 +1,117 @@
+//
+//  ImagePreprocessor.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____ImagePreprocessor_included__
+#define ____ImagePreprocessor_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <stddef.h>
+
+namespace csc450Lib_linalg_base {
+
+    /**
+     * Turns the 8-bit gray levels of a decoded image into the values of one
+     *  face vector, in a single pass that writes straight into its
+     *  destination (typically a column of the training matrix). In order,
+     *  the pass can
+     *
+     *  - crop the image to its centered square, as
+     *    GetPixels::getPixelSquare does,
+     *  - area-resample it, by an integer factor or to a given size,
+     *  - equalize its histogram, which evens out the leftlight and
+     *    rightlight pictures,
+     *  - normalize it to zero mean and unit variance.
+     *
+     * With every step off, values are the gray levels divided by 255. Rows
+     *  are resampled across as the output rows down need them, and only
+     *  the few an output row covers are kept, so no full-size float copy
+     *  of the image is made
+     */
+    class ImagePreprocessor {
+    private:
+        /** Whether images are cropped to their centered square */
+        bool centerCrop;
+
+        /** Box filter factor (1 keeps every pixel), when no size is set */
+        int downsample;
+
+        /** Output size, or 0 x 0 to use the downsampling factor */
+        int width;
+        int height;
+
+        /** Whether the histogram of the gray levels is equalized */
+        bool equalize;
+
+        /** Whether the values are shifted and scaled to mean 0, variance 1 */
+        bool normalize;
+
+    public:
+
+        /** Builds a preprocessor with every step off */
+        ImagePreprocessor(void);
+
+        /** Crops every image to its centered square (off by default) */
+        void setCenterCrop(bool centerCrop);
+
+        /**
+         * Averages factor x factor blocks into one pixel (1 by default).
+         *  Rows and columns left over at the bottom and right are dropped.
+         *  Clears any size set by setSize()
+         */
+        void setDownsample(int factor);
+
+        /**
+         * Area-resamples every (cropped) image to width x height, each
+         *  output pixel averaging the source area it covers; 0 x 0 goes
+         *  back to the downsampling factor
+         */
+        void setSize(int width, int height);
+
+        /** Equalizes the histogram of every image (off by default) */
+        void setEqualize(bool equalize);
+
+        /** Normalizes every image to zero mean, unit variance (off by default) */
+        void setNormalize(bool normalize);
+
+        /** Whether images are normalized, so no longer in [0, 1] */
+        bool normalizes(void) const;
+
+        /**
+         * Computes the size of the images made from width x height ones
+         *
+         * @return
+         *          false if the image is too small for the output to have
+         *          any pixel
+         */
+        bool outputSize(int width, int height, int *outWidth, int *outHeight) const;
+
+        /**
+         * Preprocesses width x height gray levels, row after row. Output
+         *  pixel p, row-major, goes to dest[p * stride]
+         */
+        void apply(const unsigned char *gray, int width, int height,
+                   float *dest, size_t stride) const;
+
+        /**
+         * Area-resamples a width x height image of floats, pixel p at
+         *  src[p * srcStride], to outWidth x outHeight, pixel p going to
+         *  dest[p * stride]. Used to bring face vectors already loaded
+         *  down to a coarser resolution
+         */
+        static void resample(const float *src, int width, int height,
+                             size_t srcStride, float *dest,
+                             int outWidth, int outHeight, size_t stride);
+    };
+}
+#endif /* defined(____ImagePreprocessor_included__) */
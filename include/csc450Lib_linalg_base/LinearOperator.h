@@ -0,0 +1,43 @@
+//
+//  LinearOperator.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____LinearOperator_included__
+#define ____LinearOperator_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include "Matrix.h"
+
+namespace csc450Lib_linalg_base {
+    
+    /**
+     * Defines the base class for a symmetric linear map y = M x which is
+     *  only known through its action on vectors, so that iterative solvers
+     *  can work without the matrix M ever being formed
+     */
+    class LinearOperator {
+    public:
+        
+        /// Nothing to release in the base class
+        virtual ~LinearOperator(void);
+        
+        /// Returns the dimension of the vectors the operator acts on
+        virtual int size(void) const = 0;
+        
+        /// Applies the operator to a block of vectors. x holds one vector
+        ///	per row (x->cols() == size()); row i of y receives the image
+        ///	of row i of x
+        virtual void apply(const Matrix *x, Matrix *y) const = 0;
+    };
+}
+#endif /* defined(____LinearOperator_included__) */
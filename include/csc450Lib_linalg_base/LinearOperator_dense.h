@@ -0,0 +1,42 @@
+//
+//  LinearOperator_dense.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____LinearOperator_dense_included__
+#define ____LinearOperator_dense_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include "LinearOperator.h"
+
+namespace csc450Lib_linalg_base {
+    
+    /**
+     * Subclass of LinearOperator which applies an explicit symmetric matrix
+     */
+    class LinearOperator_dense : public LinearOperator {
+    private:
+        
+        /// The symmetric matrix; not owned
+        const Matrix *m;
+        
+    public:
+        
+        /// Wraps the given symmetric matrix, which must outlive the operator
+        LinearOperator_dense(const Matrix *m);
+        
+        int size(void) const;
+        
+        void apply(const Matrix *x, Matrix *y) const;
+    };
+}
+#endif /* defined(____LinearOperator_dense_included__) */
@@ -0,0 +1,50 @@
+//
+//  LinearOperator_gram.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____LinearOperator_gram_included__
+#define ____LinearOperator_gram_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include "LinearOperator.h"
+
+namespace csc450Lib_linalg_base {
+    
+    /**
+     * Subclass of LinearOperator which applies the Gram matrix
+     *  transpose(A) * A of a (typically tall and skinny) matrix A as
+     *  transpose(A) * (A * x), without forming the Gram matrix
+     */
+    class LinearOperator_gram : public LinearOperator {
+    private:
+        
+        /// The matrix A; not owned
+        const Matrix *a;
+        
+        /// Scratch space for A * x, resized on demand
+        mutable Matrix *ax;
+        
+    public:
+        
+        /// Wraps the given matrix, which must outlive the operator
+        LinearOperator_gram(const Matrix *a);
+        
+        /// Releases the scratch space
+        ~LinearOperator_gram(void);
+        
+        int size(void) const;
+        
+        void apply(const Matrix *x, Matrix *y) const;
+    };
+}
+#endif /* defined(____LinearOperator_gram_included__) */
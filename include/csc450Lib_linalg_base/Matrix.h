@@ -24,9 +24,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <cmath>
+#include <algorithm>
 //#include "ColumnVector.h"
 using namespace std;
 
+/**
+ * Alignment, in bytes, of every buffer owned by a Matrix (one cache line,
+ *  and wide enough for AVX-512 loads)
+ */
+#define MATRIX_ALIGNMENT 64
+
 
 namespace csc450Lib_linalg_base {
     
@@ -42,9 +49,33 @@ namespace csc450Lib_linalg_base {
     class Matrix {
     protected:
         /**
-         * Two dimensional array to define the matrix
+         * Contiguous, row-major element buffer. Element (i, j) lives at
+         *  data[i * ld + j]. Owned buffers are aligned to MATRIX_ALIGNMENT
+         */
+        float * data;
+        
+        /**
+         * Leading dimension: the distance, in floats, between the starts of
+         *  two consecutive rows. At least nbCols; larger for views and for
+         *  matrices which have spare room to grow columns into
+         */
+        int ld;
+        
+        /**
+         * Number of rows the owned buffer has room for
+         */
+        int capRows;
+        
+        /**
+         * Whether this matrix owns (and must release) its buffer. Views
+         *  into another matrix do not
          */
-        float ** a;
+        bool owner;
+        
+        /**
+         * Row pointers handed out by getArray(), built on demand
+         */
+        mutable float ** rowPtrs;
         
         /**
          * Number of rows
@@ -56,6 +87,21 @@ namespace csc450Lib_linalg_base {
          */
         int nbCols;
         
+        /**
+         * Allocates an aligned buffer of n floats
+         */
+        static float* allocate(size_t n);
+        
+        /**
+         * Moves the elements into a new owned buffer of the given capacity
+         */
+        void reallocate(int newCapRows, int newLd);
+        
+        /**
+         * Drops the cached row pointers after the layout has changed
+         */
+        void invalidateRowPtrs(void);
+        
     public:
         
         /**
@@ -71,7 +117,9 @@ namespace csc450Lib_linalg_base {
          *          Number of columns
          *
          * @param a
-         *          The matrix
+         *          The matrix. The rows are copied into contiguous storage
+         *          and then released, since the matrix takes ownership of
+         *          them
          */
         Matrix(int nbRows, int nbCols, float ** a);
         
@@ -86,11 +134,36 @@ namespace csc450Lib_linalg_base {
          */
         Matrix(int nbRows, int nbCols);
         
+        /**
+         * Creates a view over existing storage. The matrix does not own the
+         *  buffer, so it must not outlive it, and cannot be resized
+         *
+         * @param nbRows
+         *          Number of rows
+         *
+         * @param nbCols
+         *          Number of columns
+         *
+         * @param data
+         *          Address of element (0, 0)
+         *
+         * @param ld
+         *          Distance, in floats, between two consecutive rows
+         */
+        Matrix(int nbRows, int nbCols, float * data, int ld);
+        
         /**
          * Destructor
          */
         ~Matrix();
         
+        /**
+         * Returns a view of the nbRows x nbCols block of matA whose top left
+         *  corner is at (theRow, theCol). No elements are copied
+         */
+        static Matrix* view(const Matrix *matA, int theRow, int theCol,
+                            int nbRows, int nbCols);
+        
         /**
          * Returns a new matrix, the transpose of the one received as parameter
          */
@@ -112,6 +185,37 @@ namespace csc450Lib_linalg_base {
         static  Matrix* multiply(const Matrix *matA,
                                  const Matrix *matB);
         
+        /**
+         * Multiplies the transpose of matA by matB, without forming the
+         *  transpose. Throws if matA and matB do not have the same number
+         *  of rows
+         */
+        static  Matrix* multiplyTransposeA(const Matrix *matA,
+                                           const Matrix *matB);
+        
+        /**
+         * Computes the Gram matrix transpose(matA) * matA. Only the upper
+         *  triangle is computed, then mirrored
+         */
+        static  Matrix* gram(const Matrix *matA);
+        
+        /**
+         * Computes the Gram matrix of matA given the Gram matrix of its
+         *  first previous->rows() columns, as after columns have been
+         *  appended with addColumn. Only the new columns are computed
+         */
+        static  Matrix* gram(const Matrix *matA,
+                             const Matrix *previous);
+        
+        /**
+         * Multiplies two matrices into an existing result matrix, without
+         *  allocating. The result must have the proper dimensions and must
+         *  not share storage with either operand
+         */
+        static void multiplyInto(const Matrix *matA,
+                                 const Matrix *matB,
+                                 Matrix *result);
+        
         /**
          * Multiplies two matrices If we had plenty of time we would do some
          *  data validation and exception handling. Here, if array a does not
@@ -120,6 +224,12 @@ namespace csc450Lib_linalg_base {
         static Matrix* multiply(float mult,
                                 const Matrix *mat);
         
+        /**
+         * Copies the elements of matA into an existing matrix of the same
+         *  dimensions
+         */
+        static void copyInto(const Matrix *matA, Matrix *result);
+        
         /**
          * Computes the outer product of two column vectors
          */
@@ -220,10 +330,38 @@ namespace csc450Lib_linalg_base {
         ColumnVector* getColumn(int theCol) const;
         
         /**
-         * Returns the two dimensional array defining this matrix
+         * Returns a view of the column at the position specified. No
+         *  elements are copied; the view aliases this matrix
+         *
+         * @param theCol
+         *          The column
+         *
+         * @return
+         *          A column vector sharing this matrix's storage
+         */
+        ColumnVector* columnView(int theCol) const;
+        
+        /**
+         * Returns row pointers into the contiguous storage. Kept for
+         *  compatibility; the pointers are invalidated by any resize
          */
         float** getArray() const;
         
+        /**
+         * Returns the address of element (0, 0)
+         */
+        float* getData() const;
+        
+        /**
+         * Returns the leading dimension (row stride) of the storage
+         */
+        int stride(void) const;
+        
+        /**
+         * Returns whether this matrix owns its storage
+         */
+        bool ownsData(void) const;
+        
         /**
          * Returns the value of the norm 1 for this matrix
          */
@@ -244,6 +382,17 @@ namespace csc450Lib_linalg_base {
          */
         void set(int theRow, int theCol, float theVal);
         
+        /**
+         * Multiplies every element of this matrix by mult
+         */
+        void scaleInPlace(float mult);
+        
+        /**
+         * Adds alpha times matX to this matrix (matX must have the same
+         *  dimensions)
+         */
+        void axpy(float alpha, const Matrix *matX);
+        
         /**
          * Adds the given row to the bottom of the matrix
          */
@@ -306,7 +455,8 @@ namespace csc450Lib_linalg_base {
         /**
          * Assigns new values to the elements of the matrix. If we had plenty
          *  of time we would do some data validation and exception handling.
-         *  Here, if array a does not have the proper dimensions, just quit
+         *  Here, if array a does not have the proper dimensions, just quit.
+         *  As with the constructor, the rows of a are copied then released
          */
         void setMatrix(float ** a);
         
@@ -323,6 +473,8 @@ namespace csc450Lib_linalg_base {
          *      a formatted console output would be produced by
          *          the parameters ("{", "}", ",", true) or the
          *          parameters ("", "", " \t", true)
+         *  The string is sized exactly and must be released with free().
+         *  To write large matrices, use a MatrixWriter on a stream instead
          */
         char* toString(const char* theBeginArrayStr,
                        const char* theEndArrayStr,
@@ -330,5 +482,13 @@ namespace csc450Lib_linalg_base {
                        bool theEolAtEor) const;
         
     };
+    
+    inline float Matrix::get(int theRow, int theCol) const {
+        return data[(size_t)theRow * ld + theCol];
+    }
+    
+    inline void Matrix::set(int theRow, int theCol, float theVal) {
+        data[(size_t)theRow * ld + theCol] = theVal;
+    }
 }
 #endif /* defined(____Matrix_included__) */
\ No newline at end of file
@@ -0,0 +1,36 @@
+//
+//  MatrixFormat.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____MatrixFormat_included__
+#define ____MatrixFormat_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+
+namespace csc450Lib_linalg_base {
+    /**
+     * Enumeration of the output formats of MatrixWriter
+     */
+    enum MatrixFormat {
+        /** Nested lists, {{a,b},{c,d}}, with exponents written *^ */
+        FORMAT_MATHEMATICA,
+        
+        /** One line per row, elements separated by commas */
+        FORMAT_CSV,
+        
+        /** The elements as raw 32-bit floats, row after row, in the
+         *  byte order of the machine */
+        FORMAT_BINARY
+    };
+}
+#endif /* defined(____MatrixFormat_included__) */
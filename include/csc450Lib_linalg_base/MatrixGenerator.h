@@ -223,6 +223,11 @@ namespace csc450Lib_linalg_base {
          *  matrix generators.
          */
         static void seed();
+        
+        /**
+         * Fills an existing matrix with random values, as getRandom does
+         */
+        static void randomize(Matrix *mat);
     };
 }
 #endif /* defined(____MatrixGenerator_included__) */
\ No newline at end of file
@@ -0,0 +1,146 @@
+//
+//  MatrixMultiplier.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____MatrixMultiplier_included__
+#define ____MatrixMultiplier_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <stdlib.h>
+
+namespace csc450Lib_linalg_base {
+
+    /**
+     * Utility class for the dense kernels behind Matrix::multiply. Works on
+     *  raw row-major storage (address of element (0, 0) plus leading
+     *  dimension) so that it can be used on whole matrices and views alike.
+     *
+     * Products are computed with a packed, cache-blocked GEMM: panels of A
+     *  and B are copied into contiguous buffers sized for the caches, then a
+     *  register-tiled micro-kernel sweeps them. The micro-kernel (AVX-512,
+     *  AVX2+FMA or portable C++) is picked once, at runtime, from what the
+     *  CPU supports
+     */
+    class MatrixMultiplier {
+    public:
+
+        /**
+         * Computes C = alpha * op(A) * op(B) + beta * C, where op(X) is X or
+         *  its transpose
+         *
+         * @param transA
+         *          Whether to use the transpose of A
+         *
+         * @param transB
+         *          Whether to use the transpose of B
+         *
+         * @param m
+         *          Number of rows of op(A) and C
+         *
+         * @param n
+         *          Number of columns of op(B) and C
+         *
+         * @param k
+         *          Number of columns of op(A) and rows of op(B)
+         *
+         * @param alpha
+         *          Scale factor of the product
+         *
+         * @param a
+         *          Storage of A, lda floats between rows
+         *
+         * @param b
+         *          Storage of B, ldb floats between rows
+         *
+         * @param beta
+         *          Scale factor of the previous contents of C. When zero, C
+         *          is not read
+         *
+         * @param c
+         *          Storage of C, ldc floats between rows
+         */
+        static void gemm(bool transA, bool transB,
+                         int m, int n, int k,
+                         float alpha,
+                         const float *a, int lda,
+                         const float *b, int ldb,
+                         float beta,
+                         float *c, int ldc);
+
+        /**
+         * Computes the upper triangle of C = alpha * transpose(A) * A +
+         *  beta * C, where A is k x n, by running the GEMM kernel over the
+         *  tiles on and above the diagonal, spread across threads. Entries
+         *  below the diagonal inside diagonal tiles may also be written;
+         *  call symmetrize() to get the full matrix
+         *
+         * @param n
+         *          Number of columns of A, and order of C
+         *
+         * @param k
+         *          Number of rows of A
+         *
+         * @param from
+         *          First column of C to compute. Columns before it are left
+         *          untouched, which lets a Gram matrix be extended when
+         *          columns are appended to A
+         */
+        static void syrk(int n, int k,
+                         float alpha,
+                         const float *a, int lda,
+                         float beta,
+                         float *c, int ldc,
+                         int from = 0);
+
+        /**
+         * Overwrites the m x n matrix B with the solution X of
+         *  op(T) * X = B, where T is an m x m triangular matrix and op(T) is
+         *  T or its transpose. The off-diagonal blocks of T are applied with
+         *  GEMM, splitting T in halves recursively, so many right-hand sides
+         *  are solved at the speed of a matrix product
+         *
+         * @param upper
+         *          Whether T is stored in the upper triangle (the lower one
+         *          otherwise). The other triangle is not read
+         *
+         * @param transT
+         *          Whether to use the transpose of T
+         *
+         * @param unitDiagonal
+         *          Whether the diagonal of T is taken to be all ones (and not
+         *          read)
+         */
+        static void trsm(bool upper, bool transT, bool unitDiagonal,
+                         int m, int n,
+                         const float *t, int ldt,
+                         float *b, int ldb);
+
+        /**
+         * Copies the upper triangle of the n x n matrix C onto its lower
+         *  triangle
+         */
+        static void symmetrize(int n, float *c, int ldc);
+
+        /**
+         * Computes the dot product of two contiguous arrays of n floats
+         */
+        static float dot(int n, const float *x, const float *y);
+
+        /**
+         * Returns the name of the micro-kernel in use ("avx512", "avx2" or
+         *  "generic")
+         */
+        static const char* kernelName(void);
+    };
+}
+#endif /* defined(____MatrixMultiplier_included__) */
@@ -0,0 +1,93 @@
+//
+//  MatrixWriter.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____MatrixWriter_included__
+#define ____MatrixWriter_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <ostream>
+#include <string>
+
+#include "Matrix.h"
+#include "MatrixFormat.h"
+
+namespace csc450Lib_linalg_base {
+    
+    /**
+     * Streaming serializer for matrices. Elements are formatted with
+     *  std::to_chars, which gives the shortest text that reads back to the
+     *  same float, into a fixed 64 KB chunk that is handed to the
+     *  destination whenever it fills up. Memory use is therefore bounded
+     *  whatever the size of the matrix, and every byte is written once.
+     *
+     * Besides the formats of MatrixFormat, a writer can be built from the
+     *  delimiters of Matrix::toString
+     */
+    class MatrixWriter {
+    private:
+        MatrixFormat format;
+        std::string beginArray;
+        std::string endArray;
+        std::string elementSeparator;
+        bool eolAtEndOfRow;
+        
+        /** Whether exponents are written *^ rather than e */
+        bool mathematicaExponents;
+        
+        /**
+         * Formats the matrix chunk by chunk, calling sink(context, bytes,
+         *  n) for each chunk
+         */
+        void emit(const Matrix *matrix,
+                  void (*sink)(void *context, const char *bytes, size_t n),
+                  void *context) const;
+        
+    public:
+        
+        /**
+         * Builds a writer for one of the standard formats
+         */
+        MatrixWriter(MatrixFormat format);
+        
+        /**
+         * Builds a text writer with the delimiters of Matrix::toString:
+         *  the matrix and each of its rows are wrapped in theBeginArrayStr
+         *  and theEndArrayStr, elements are separated by theElmtSepStr, and
+         *  rows by a newline when theEolAtEor, by theElmtSepStr otherwise
+         */
+        MatrixWriter(const char *theBeginArrayStr,
+                     const char *theEndArrayStr,
+                     const char *theElmtSepStr,
+                     bool theEolAtEor);
+        
+        /**
+         * Writes the matrix to out
+         */
+        void write(std::ostream &out, const Matrix *matrix) const;
+        
+        /**
+         * Writes the matrix into buffer, stopping after capacity bytes, and
+         *  returns the full length of the output (like snprintf, but
+         *  without a terminating zero). Call with capacity 0 to size the
+         *  buffer
+         */
+        size_t write(char *buffer, size_t capacity, const Matrix *matrix) const;
+        
+        /**
+         * Returns the length of the output for the matrix, in bytes
+         */
+        size_t length(const Matrix *matrix) const;
+    };
+}
+#endif /* defined(____MatrixWriter_included__) */
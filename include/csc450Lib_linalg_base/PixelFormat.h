@@ -0,0 +1,33 @@
+//
+//  PixelFormat.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____PixelFormat_included__
+#define ____PixelFormat_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+
+namespace csc450Lib_linalg_base {
+    /**
+     * Enumeration of the ways pixel values can be stored. Values are gray
+     *  levels in [0, 1] once loaded, whatever the storage
+     */
+    enum PixelFormat {
+        /** 32-bit floats, usable in place as matrix storage */
+        PIXEL_FLOAT32,
+        
+        /** Bytes holding round(255 * value), a quarter of the size */
+        PIXEL_UINT8
+    };
+}
+#endif /* defined(____PixelFormat_included__) */
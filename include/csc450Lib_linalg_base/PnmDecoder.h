@@ -0,0 +1,60 @@
+//
+//  PnmDecoder.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____PnmDecoder_included__
+#define ____PnmDecoder_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <stddef.h>
+#include <string>
+
+namespace csc450Lib_linalg_base {
+
+    /**
+     * Decoder for the Netpbm gray and color formats: PGM (P2 plain, P5 raw)
+     *  and PPM (P3 plain, P6 raw), 8 or 16 bits per sample. Colors are
+     *  mapped to gray levels with the same weights as GifDecoder, and
+     *  samples are rescaled from maxval to 255
+     */
+    class PnmDecoder {
+    public:
+
+        /**
+         * Decodes a PGM or PPM file into 8-bit gray levels, row after row
+         *
+         * @param filename
+         *          The path to the file
+         *
+         * @param width
+         *          Receives the width of the image
+         *
+         * @param height
+         *          Receives the height of the image
+         *
+         * @return
+         *          A new[]-allocated array of width * height gray levels,
+         *          or NULL if the file could not be read or decoded
+         */
+        static unsigned char* decode(const std::string &filename,
+                                     int *width, int *height);
+
+        /**
+         * Decodes a PGM or PPM file already read into memory, as the other
+         *  decode()
+         */
+        static unsigned char* decode(const unsigned char *file, size_t length,
+                                     int *width, int *height);
+    };
+}
+#endif /* defined(____PnmDecoder_included__) */
@@ -36,6 +36,12 @@ namespace csc450Lib_linalg_base {
          */
         RowVector(int nbCols);
         
+        /**
+         * Creates a row vector viewing existing storage. The vector does not
+         *  own the buffer
+         */
+        RowVector(int nbCols, float * data);
+        
         /**
          * Returns the value of the element at the position specified
          */
@@ -52,5 +58,13 @@ namespace csc450Lib_linalg_base {
         static const ColumnVector* transpose(const RowVector *matA);
         
     };
+    
+    inline float RowVector::get(int theCol) const {
+        return data[theCol];
+    }
+    
+    inline void RowVector::set(int theCol, float theVal) const {
+        data[theCol] = theVal;
+    }
 }
 #endif /* defined(____RowVector_included__) */
\ No newline at end of file
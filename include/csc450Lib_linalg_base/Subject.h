@@ -37,6 +37,7 @@ namespace csc450Lib_linalg_base {
 		/*
 		*	Constructor for the subject class
 		*	@param images A matrix of all the images that this subject owns
+		*	(typically a view of the training matrix), deleted with it
 		*	@param idnum the ID of the subject
 		*/
 		Subject(Matrix *images, int idnum);
@@ -0,0 +1,95 @@
+//
+//  TaskScheduler.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____TaskScheduler_included__
+#define ____TaskScheduler_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace csc450Lib_linalg_base {
+    
+    /**
+     * Small fork-join runtime shared by the whole library. A pool of
+     *  worker threads each owns a deque of tasks: a worker pushes and pops
+     *  at the back of its own deque and, when it runs dry, steals from the
+     *  front of another, where the largest pieces of work sit.
+     *
+     * parallelFor splits its range lazily: the running task halves its
+     *  range, pushes the upper half and keeps the lower one, until a piece
+     *  is no larger than the grain. The calling thread takes part, and
+     *  while it waits for the rest of its range it runs other tasks, so
+     *  loops may be nested freely.
+     *
+     * Exceptions thrown by a body are caught and the first one is
+     *  rethrown to the caller once every piece has finished
+     */
+    class TaskScheduler {
+    public:
+        
+        /**
+         * Sets the number of threads taking part in parallel loops,
+         *  including the caller. 0 picks the number of hardware threads.
+         *  Must not be called while a parallel loop is running
+         */
+        static void setThreads(int numThreads);
+        
+        /** Returns the number of threads taking part in parallel loops */
+        static int threads(void);
+        
+        /**
+         * Runs body(b, e) over disjoint subranges [b, e) covering
+         *  [begin, end), in parallel
+         *
+         * @param grain
+         *          Largest subrange that is not split further. 0 picks about
+         *          eight pieces per thread
+         */
+        static void parallelFor(int begin, int end, int grain,
+                                const std::function<void(int, int)> &body);
+        
+        /**
+         * Reduces [begin, end) in pieces of grain: map(b, e) computes the
+         *  value of a piece, and combine folds the values in piece order,
+         *  so the result does not depend on the number of threads
+         */
+        template <class T, class Map, class Combine>
+        static T parallelReduce(int begin, int end, int grain, T identity,
+                                Map map, Combine combine) {
+            if (end <= begin)
+                return identity;
+            if (grain <= 0)
+                grain = defaultGrain(end - begin);
+            int pieces = (end - begin + grain - 1) / grain;
+            std::vector<T> values(pieces, identity);
+            parallelFor(0, pieces, 1, [&](int p0, int p1) {
+                for (int p = p0; p < p1; p++)
+                    values[p] = map(begin + p * grain,
+                                    std::min(end, begin + (p + 1) * grain));
+            });
+            T result = identity;
+            for (int p = 0; p < pieces; p++)
+                result = combine(result, values[p]);
+            return result;
+        }
+        
+    private:
+        
+        /** About eight pieces per thread over count items */
+        static int defaultGrain(int count);
+    };
+}
+#endif /* defined(____TaskScheduler_included__) */
@@ -0,0 +1,37 @@
+//
+//  BasisFormat.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____BasisFormat_included__
+#define ____BasisFormat_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+
+namespace csc450Lib_linalg_eigensystems {
+    /**
+     * Enumeration of the ways a model file can store its eigenfaces.
+     *  Quantized formats keep one scale per eigenface, the largest
+     *  magnitude of its entries
+     */
+    enum BasisFormat {
+        /** 32-bit floats, usable in place as matrix storage */
+        BASIS_FLOAT32,
+        
+        /** IEEE half floats of value / scale, half the size */
+        BASIS_FLOAT16,
+        
+        /** Bytes holding round(127 * value / scale), a quarter of the size */
+        BASIS_INT8
+    };
+}
+#endif /* defined(____BasisFormat_included__) */
@@ -44,6 +44,19 @@ namespace csc450Lib_linalg_eigensystems {
         EigenSystem(const csc450Lib_linalg_base::Matrix *a,
                     const csc450Lib_linalg_base::Matrix *v,
                     const csc450Lib_linalg_base::ColumnVector *l);
+        
+		/* Builds an EigenSystem without keeping a copy of the matrix, as
+		*	when the matrix was only known through a LinearOperator
+		*/
+        EigenSystem(const csc450Lib_linalg_base::Matrix *v,
+                    const csc450Lib_linalg_base::ColumnVector *l);
+        
+		/* Releases the copies of the matrix, eigenvectors and eigenvalues:
+		*	the pointers handed out by getEigenVectors and getEigenValues
+		*	do not outlive the system
+		*/
+        ~EigenSystem(void);
+        
 		/* Return the EigenVectors of this EigenSystem
 		*	return the eigen vectors of this system
 		*/
@@ -0,0 +1,34 @@
+//
+//  EigenSystemMethod.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____EigenSystemMethod_included__
+#define ____EigenSystemMethod_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+
+namespace csc450Lib_linalg_eigensystems {
+    /**
+     * Enumeration of the algorithms an EigenSystemSolver can use
+     */
+    enum EigenSystemMethod {
+        /** Power iteration, Rayleigh refinement and deflation, one
+         *  eigenpair at a time. Works on any matrix with real eigenvalues */
+        POWER_ITERATION,
+        
+        /** Householder reduction to tridiagonal form followed by implicit
+         *  QL iteration. Symmetric matrices only; all eigenpairs at once */
+        SYMMETRIC_QR
+    };
+}
+#endif /* defined(____EigenSystemMethod_included__) */
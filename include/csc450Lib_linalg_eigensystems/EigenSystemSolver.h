@@ -23,7 +23,11 @@
 #include "ColumnVector.h"
 #include "RowVector.h"
 #include "EigenSystem.h"
+#include "EigenSystemWorkspace.h"
+#include "EigenSystemMethod.h"
 #include "LinearSolver_LU.h"
+#include "LinearSolver_LDLT.h"
+#include "LinearOperator.h"
 
 namespace csc450Lib_linalg_eigensystems {
     
@@ -35,12 +39,52 @@ namespace csc450Lib_linalg_eigensystems {
         
         const csc450Lib_linalg_base::Matrix *a;
         
+        /** Algorithm used by solve() */
+        EigenSystemMethod method;
+        
+        /**
+         * Reduces the symmetric n x n matrix held in w to tridiagonal form
+         *  with Householder reflections, replacing w with the accumulated
+         *  orthogonal transformation (one basis vector per row), d with
+         *  the diagonal and e with the subdiagonal (e[0] = 0)
+         */
+        static void tridiagonalize(int n, double *w, double *d, double *e);
+        
+        /**
+         * Diagonalizes the tridiagonal matrix (d, e) with implicitly
+         *  shifted QL iteration, applying the rotations to the rows of w.
+         *  On return d holds the eigenvalues and the rows of w the
+         *  eigenvectors
+         *
+         * @return
+         *          false if some eigenvalue failed to converge
+         */
+        static bool tridiagonalQL(int n, double *w, double *d, double *e);
+        
     public:
         
         EigenSystemSolver(void);
         EigenSystemSolver(const csc450Lib_linalg_base::Matrix *a);
+        EigenSystemSolver(const csc450Lib_linalg_base::Matrix *a,
+                          EigenSystemMethod method);
         ~EigenSystemSolver(void);
         
+        /**
+         * Orthonormalizes the rows of q in place (Gram-Schmidt, twice).
+         *  Rows which turn out to be linearly dependent are replaced by
+         *  random directions. Rows before from are taken to be orthonormal
+         *  already and are left untouched
+         */
+        static void orthonormalizeRows(csc450Lib_linalg_base::Matrix *q,
+                                       int from = 0);
+        
+		/**
+		* Calculates every eigenpair of the symmetric matrix a by reduction
+		*	to tridiagonal form and implicit QL iteration. Eigenvalues are
+		*	sorted in decreasing order, eigenvectors have unit norm 2
+		*/
+        static EigenSystem* symmetricQR(const csc450Lib_linalg_base::Matrix *a);
+        
 		/**
 		* Calculates an Eigensystem using power iteration
 		*/
@@ -55,6 +99,43 @@ namespace csc450Lib_linalg_eigensystems {
                                     const csc450Lib_linalg_base::ColumnVector *v,
                                     float l, int iterations, float tol);
        
+		/**
+		* Calculates the k largest eigenpairs of the symmetric matrix a
+		*	(see the LinearOperator version)
+		*/
+        static EigenSystem* solveTopK(const csc450Lib_linalg_base::Matrix *a,
+                                      int k, float tol);
+        
+		/**
+		* Calculates the k largest eigenpairs of a symmetric positive
+		*	semi-definite operator, known only through its action on
+		*	vectors, by randomized subspace iteration with Rayleigh-Ritz
+		*	projection. Iterates until the residual norm of each of the k
+		*	Ritz pairs falls below tol times the largest eigenvalue.
+		*	Eigenvalues are sorted in decreasing order, eigenvectors have
+		*	unit norm 2
+		*/
+        static EigenSystem* solveTopK(const csc450Lib_linalg_base::LinearOperator *op,
+                                      int k, float tol);
+        
+		/**
+		* Runs power iteration on a, starting from (and leaving the
+		*	eigenvector in) the workspace iterate. Returns the eigenvalue.
+		*	Nothing is allocated
+		*/
+        static float power(const csc450Lib_linalg_base::Matrix *a,
+                           EigenSystemWorkspace *workspace,
+                           int iterations, float tol);
+        
+		/**
+		* Refines the eigenpair (workspace iterate, l) of a with Rayleigh
+		*	Quotient Iteration, in place. Returns the refined eigenvalue.
+		*	Nothing is allocated
+		*/
+        static float rayleigh(const csc450Lib_linalg_base::Matrix *a,
+                              EigenSystemWorkspace *workspace,
+                              float l, int iterations, float tol);
+        
 		/**
 		* Calculates a deflated Matrix for the given EigenSystem
 		*/
@@ -62,6 +143,13 @@ namespace csc450Lib_linalg_eigensystems {
                                                       const csc450Lib_linalg_base::ColumnVector *v,
                                                       float l);
         
+		/**
+		* Deflates a in place by removing the given eigenpair
+		*/
+        static void deflateInPlace(csc450Lib_linalg_base::Matrix *a,
+                                   const csc450Lib_linalg_base::ColumnVector *v,
+                                   float l);
+        
         /**
          * Calculates the Eigensystem (for the given matrix)
          */
@@ -76,6 +164,16 @@ namespace csc450Lib_linalg_eigensystems {
          * Sets the Matrix
          */
         void setA(const csc450Lib_linalg_base::Matrix *a);
+        
+        /**
+         * Sets the algorithm used by solve()
+         */
+        void setMethod(EigenSystemMethod method);
+        
+        /**
+         * Returns the algorithm used by solve()
+         */
+        EigenSystemMethod getMethod(void) const;
     };
 }
 #endif /* defined(____EigenSystemSolver_included__) */
\ No newline at end of file
@@ -0,0 +1,83 @@
+//
+//  EigenSystemWorkspace.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____EigenSystemWorkspace_included__
+#define ____EigenSystemWorkspace_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include "Matrix.h"
+#include "ColumnVector.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Scratch storage for one eigensolve. Everything the power and Rayleigh
+     *  iterations need is allocated once, up front, so that the iterations
+     *  themselves run without touching the heap
+     */
+    class EigenSystemWorkspace {
+    private:
+        /** Order of the matrices being solved */
+        int size;
+        
+        /** Current iterate */
+        csc450Lib_linalg_base::ColumnVector *x;
+        
+        /** Product of the matrix with the current iterate */
+        csc450Lib_linalg_base::ColumnVector *y;
+        
+        /** Shifted matrix, factorized in place by Rayleigh iteration */
+        csc450Lib_linalg_base::Matrix *shifted;
+        
+        /** Deflated copy of the matrix being solved */
+        csc450Lib_linalg_base::Matrix *deflated;
+        
+        /** Row swaps of the factorization of the shifted matrix */
+        int *pivots;
+        
+        /** Off-diagonal of the 2 x 2 blocks of D, when the shifted matrix
+         *  is factorized by LinearSolver_LDLT */
+        float *offDiagonal;
+        
+    public:
+        
+        /**
+         * Allocates a workspace for matrices of the given order
+         */
+        EigenSystemWorkspace(int size);
+        ~EigenSystemWorkspace(void);
+        
+        /** Returns the order of the matrices this workspace is for */
+        int getSize(void) const;
+        
+        /** Returns the current iterate */
+        csc450Lib_linalg_base::ColumnVector* getX(void) const;
+        
+        /** Returns the scratch vector */
+        csc450Lib_linalg_base::ColumnVector* getY(void) const;
+        
+        /** Returns the scratch matrix for shifted systems */
+        csc450Lib_linalg_base::Matrix* getShifted(void) const;
+        
+        /** Returns the scratch matrix for deflation */
+        csc450Lib_linalg_base::Matrix* getDeflated(void) const;
+        
+        /** Returns the pivot array for the shifted matrix */
+        int* getPivots(void) const;
+        
+        /** Returns the off-diagonal array for a symmetric shifted matrix */
+        float* getOffDiagonal(void) const;
+    };
+}
+#endif /* defined(____EigenSystemWorkspace_included__) */
@@ -0,0 +1,88 @@
+//
+//  EigenfaceModel.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____EigenfaceModel_included__
+#define ____EigenfaceModel_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include "Matrix.h"
+#include "ColumnVector.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * A trained eigenface model: the average face, the k leading
+     *  eigenfaces (unit vectors, one per column), the matching eigenvalues
+     *  of transpose(A) * A and the number of images it was trained on.
+     *
+     * New images are folded in with update(), an incremental SVD with mean
+     *  correction (Ross et al., "Incremental Learning for Robust Visual
+     *  Tracking"). It costs O(N (k + b)^2) for b new images of N pixels,
+     *  independently of how many images the model has already seen, and is
+     *  exact when no eigenface is truncated
+     */
+    class EigenfaceModel {
+    private:
+        /** Number of images the model was trained on */
+        int count;
+        
+        /** The average face */
+        csc450Lib_linalg_base::ColumnVector *mean;
+        
+        /** The eigenfaces, one per column */
+        csc450Lib_linalg_base::Matrix *eigenfaces;
+        
+        /** Eigenvalues of transpose(A) * A, in decreasing order */
+        csc450Lib_linalg_base::ColumnVector *eigenvalues;
+        
+    public:
+        
+        /**
+         * Builds a model from copies of the given mean, eigenfaces and
+         *  eigenvalues, trained on count images
+         */
+        EigenfaceModel(const csc450Lib_linalg_base::ColumnVector *mean,
+                       const csc450Lib_linalg_base::Matrix *eigenfaces,
+                       const csc450Lib_linalg_base::ColumnVector *eigenvalues,
+                       int count);
+        ~EigenfaceModel(void);
+        
+        /**
+         * Trains a model on the given images (one per column), keeping at
+         *  most k eigenfaces
+         */
+        static EigenfaceModel* train(const csc450Lib_linalg_base::Matrix *images,
+                                     int k);
+        
+        /**
+         * Returns the model trained on this model's images plus the given
+         *  ones (one per column), keeping at most k eigenfaces
+         */
+        EigenfaceModel* update(const csc450Lib_linalg_base::Matrix *images,
+                               int k) const;
+        
+        /** Returns the number of images the model was trained on */
+        int getCount(void) const;
+        
+        /** Returns the average face */
+        csc450Lib_linalg_base::ColumnVector* getMean(void) const;
+        
+        /** Returns the eigenfaces, one per column */
+        csc450Lib_linalg_base::Matrix* getEigenfaces(void) const;
+        
+        /** Returns the eigenvalues of transpose(A) * A */
+        csc450Lib_linalg_base::ColumnVector* getEigenValues(void) const;
+    };
+}
+#endif /* defined(____EigenfaceModel_included__) */
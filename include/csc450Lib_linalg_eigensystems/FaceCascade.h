@@ -0,0 +1,165 @@
+//
+//  FaceCascade.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____FaceCascade_included__
+#define ____FaceCascade_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <cfloat>
+#include <vector>
+
+#include "Matrix.h"
+#include "ColumnVector.h"
+#include "Subject.h"
+#include "FaceProjector.h"
+
+namespace csc450Lib_linalg_eigensystems {
+
+    /**
+     * Coarse-to-fine FacialRecognizer. Besides the full-resolution
+     *  eigenfaces, the cascade keeps small eigenbases trained on the
+     *  subjects' images area-downsampled to, say, 32 x 32 and 64 x 64.
+     *
+     * A probe is downsampled and projected at the coarsest level first. If
+     *  it is further from that level's face space than the level's
+     *  threshold it is rejected as a non-face; otherwise only the subjects
+     *  whose class vectors are nearest at that level go on to the next
+     *  one. The full-resolution projection, by far the most expensive, is
+     *  only paid for probes that pass every coarse level, and only the
+     *  surviving subjects are scored there.
+     *
+     * Thresholds are distances from face space as returned by
+     *  distFromFaceSpace(), which can be used to calibrate them
+     */
+    class FaceCascade {
+    private:
+        /** One resolution of the cascade */
+        struct Level {
+            /** Size of the images at this level */
+            int width;
+            int height;
+
+            /** The eigenfaces and average face at this level */
+            const csc450Lib_linalg_base::Matrix *eigenfaces;
+            const csc450Lib_linalg_base::ColumnVector *averageFace;
+
+            /** Whether the eigenfaces and average face are owned */
+            bool owned;
+
+            /** Projection onto this level's eigenfaces */
+            FaceProjector *projector;
+
+            /** Class vectors, one row per subject */
+            csc450Lib_linalg_base::Matrix *classWeights;
+
+            /** Largest distance from face space of a face */
+            float threshold;
+
+            /** Number of subjects kept for the next level */
+            int candidates;
+        };
+
+        /** Full size of the images */
+        int width;
+        int height;
+
+        /** The subjects, in class order (not owned) */
+        std::vector<const csc450Lib_linalg_base::Subject*> subjects;
+
+        /** The levels, coarsest first; the last one is at full resolution */
+        std::vector<Level> levels;
+
+        /** Fills in the projector and class vectors of a level */
+        void enroll(int level);
+
+        /**
+         * Brings the probe down to every coarse level, in per-thread
+         *  buffers: one pass over the probe makes the finest, and each
+         *  coarser one is made from the next finer
+         */
+        const std::vector<std::vector<float> >& reduce(const csc450Lib_linalg_base::ColumnVector *probe) const;
+
+        /**
+         * Projects the probe, or its reduction, at a level, filling weights
+         *
+         * @return the distance from the level's face space
+         */
+        float project(int level, const csc450Lib_linalg_base::ColumnVector *probe,
+                      const std::vector<std::vector<float> > &reduced,
+                      float *weights) const;
+
+    public:
+
+        /**
+         * Builds a cascade of a single, full-resolution level, over the
+         *  given eigenfaces and average face of width x height images,
+         *  which must outlive it
+         *
+         * @param threshold
+         *          Largest distance from face space of a face at full
+         *          resolution
+         */
+        FaceCascade(int numSubjects,
+                    const csc450Lib_linalg_base::Subject *subjects[],
+                    const csc450Lib_linalg_base::Matrix *eigenfaces,
+                    const csc450Lib_linalg_base::ColumnVector *averageFace,
+                    int width, int height, float threshold = FLT_MAX);
+        ~FaceCascade(void);
+
+        /**
+         * Adds a coarse level: the subjects' images are area-downsampled to
+         *  width x height and k eigenfaces are trained on them
+         *
+         * @param threshold
+         *          Largest distance from face space of a face at this level
+         *
+         * @param candidates
+         *          Number of nearest subjects passed on to the next level
+         *
+         * @return the index of the new level, levels being kept coarsest
+         *          first
+         */
+        int addLevel(int width, int height, int k, float threshold,
+                     int candidates);
+
+        /** Returns the number of levels, the full-resolution one included */
+        int size(void) const;
+
+        /** Sets the largest distance from face space of a face at a level */
+        void setThreshold(int level, float threshold);
+
+        /** Returns the distance of the probe from the face space of a level */
+        float distFromFaceSpace(int level,
+                                const csc450Lib_linalg_base::ColumnVector *probe) const;
+
+        /**
+         * Recognizes a full-resolution probe
+         *
+         * @param distance
+         *          When not NULL, receives the distance of the probe to its
+         *          subject's class vector at full resolution
+         *
+         * @param level
+         *          When not NULL, receives the level at which the probe was
+         *          rejected, or size() - 1 when it was recognized
+         *
+         * @return the nearest subject, or NULL if the probe was rejected as
+         *          a non-face
+         */
+        const csc450Lib_linalg_base::Subject* recognize(const csc450Lib_linalg_base::ColumnVector *probe,
+                                                        float *distance = NULL,
+                                                        int *level = NULL) const;
+    };
+}
+#endif /* defined(____FaceCascade_included__) */
@@ -0,0 +1,130 @@
+//
+//  FaceDetector.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____FaceDetector_included__
+#define ____FaceDetector_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <complex>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Matrix.h"
+#include "ColumnVector.h"
+
+namespace csc450Lib_linalg_eigensystems {
+
+    /**
+     * Finds faces in full frames from the distance from face space at
+     *  every window position, the face map of Turk and Pentland. For the
+     *  window x at a position, with phi = x - psi and orthonormal
+     *  eigenfaces e_j,
+     *
+     *      |phi - E w|^2 = |x|^2 - 2 psi.x + |psi|^2 - sum_j (e_j.x - e_j.psi)^2
+     *
+     *  The products e_j.x and psi.x at every position are correlations of
+     *  the frame with the eigenfaces and the average face, computed all at
+     *  once with FFTs (two kernels per inverse transform, as the real and
+     *  imaginary parts). |x|^2 comes from an integral image of the squared
+     *  frame. The kernel spectra are cached for each transform size.
+     *
+     * The eigenfaces must be orthonormal, as the ones of an SVD or of an
+     *  EigenfaceModel are
+     */
+    class FaceDetector {
+    public:
+
+        /**
+         * A detected face, in the coordinates of the frame: the window's
+         *  top left corner, its size, and its distance from face space at
+         *  the scale it was found at
+         */
+        struct Detection {
+            int x;
+            int y;
+            int width;
+            int height;
+            float distance;
+            float scale;
+        };
+
+    private:
+        /** The eigenfaces, one per column (not owned) */
+        const csc450Lib_linalg_base::Matrix *eigenfaces;
+
+        /** The average face (not owned) */
+        const csc450Lib_linalg_base::ColumnVector *averageFace;
+
+        /** Size of the window, the size of the faces */
+        int width;
+        int height;
+
+        /** Weights of the average face, e_j.psi */
+        std::vector<double> averageWeights;
+
+        /** |psi|^2 */
+        double averageNorm;
+
+        /**
+         * Conjugate spectra of the kernels, two per array (the first in
+         *  the real part), for each transform size. The average face is
+         *  the last kernel
+         */
+        mutable std::map<std::pair<int, int>,
+                         std::vector<std::vector<std::complex<double> > > > spectra;
+
+        /** Guards spectra */
+        mutable std::mutex lock;
+
+        /** Returns the kernel spectra for a rows x cols transform */
+        const std::vector<std::vector<std::complex<double> > >& kernelSpectra(int rows,
+                                                                              int cols) const;
+
+    public:
+
+        /**
+         * Builds a detector of width x height faces over the given
+         *  eigenfaces and average face, which must outlive it
+         */
+        FaceDetector(const csc450Lib_linalg_base::Matrix *eigenfaces,
+                     const csc450Lib_linalg_base::ColumnVector *averageFace,
+                     int width, int height);
+
+        /**
+         * Returns the face map of a frame (one gray level per element): the
+         *  distance from face space of the window whose top left corner is
+         *  at each of the (rows - height + 1) x (cols - width + 1)
+         *  positions
+         */
+        csc450Lib_linalg_base::Matrix* faceMap(const csc450Lib_linalg_base::Matrix *frame) const;
+
+        /**
+         * Finds the faces of a frame. The frame is area-downsampled by each
+         *  scale (at most 1), and the local minima of each face map under
+         *  threshold are kept; overlapping detections are then suppressed,
+         *  nearest to face space first
+         *
+         * @param overlap
+         *          Largest share of the smaller of two kept detections
+         *          that the other may cover
+         */
+        std::vector<Detection> detect(const csc450Lib_linalg_base::Matrix *frame,
+                                      float threshold,
+                                      const std::vector<float> &scales,
+                                      float overlap = 0.3f) const;
+    };
+}
+#endif /* defined(____FaceDetector_included__) */
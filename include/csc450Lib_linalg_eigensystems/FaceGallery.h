@@ -0,0 +1,148 @@
+//
+//  FaceGallery.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____FaceGallery_included__
+#define ____FaceGallery_included__
+
+//=================================
+// forward declared dependencies
+namespace csc450Lib_linalg_eigensystems {
+    class NearestNeighborIndex;
+}
+
+//=================================
+// included dependencies
+#include <vector>
+
+#include "Matrix.h"
+#include "ColumnVector.h"
+#include "Subject.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Index of enrolled subjects for face recognition. Each subject is
+     *  projected onto the eigenfaces once, at enrollment, and its class
+     *  vector (the average weight vector of its images) is cached as a
+     *  column of a contiguous k x S matrix.
+     *
+     * Queries are answered in batches: B probes are centered and projected
+     *  with one GEMM, then scored against every class with a second one,
+     *  using |w - c|^2 = |w|^2 - 2 w.c + |c|^2. For large galleries a
+     *  NearestNeighborIndex can replace the second GEMM
+     */
+    class FaceGallery {
+    private:
+        /** The eigenfaces, one per column (not owned) */
+        const csc450Lib_linalg_base::Matrix *eigenfaces;
+        
+        /** The average face (not owned) */
+        const csc450Lib_linalg_base::ColumnVector *averageFace;
+        
+        /** Weights of the average face, subtracted from every projection */
+        csc450Lib_linalg_base::ColumnVector *averageWeights;
+        
+        /** Class vectors, one column per enrolled subject */
+        csc450Lib_linalg_base::Matrix *classWeights;
+        
+        /** Squared norms of the class vectors */
+        std::vector<float> classNorms;
+        
+        /** The enrolled subjects, in column order (not owned) */
+        std::vector<const csc450Lib_linalg_base::Subject*> subjects;
+        
+        /** Optional index over the class vectors (owned), NULL for exact scoring */
+        NearestNeighborIndex *index;
+        
+        /**
+         * Finds the nearest class of each of the count weight vectors in w
+         *  (k x count, ldw floats between rows), filling index and,
+         *  when not NULL, distance
+         */
+        void nearest(const float *w, int ldw, int count,
+                     int *index, float *distance) const;
+        
+    public:
+        
+        /**
+         * Builds an empty gallery over the given eigenfaces and average face,
+         *  which must outlive it
+         */
+        FaceGallery(const csc450Lib_linalg_base::Matrix *eigenfaces,
+                    const csc450Lib_linalg_base::ColumnVector *averageFace);
+        
+        /**
+         * Builds a gallery and enrolls the given subjects
+         */
+        FaceGallery(int numSubjects,
+                    const csc450Lib_linalg_base::Subject *subjects[],
+                    const csc450Lib_linalg_base::Matrix *eigenfaces,
+                    const csc450Lib_linalg_base::ColumnVector *averageFace);
+        ~FaceGallery(void);
+        
+        /**
+         * Projects the subject's images and caches its class vector.
+         *  Returns the index of the new class
+         */
+        int enroll(const csc450Lib_linalg_base::Subject *subject);
+        
+        /**
+         * Answers queries with the given empty index instead of scoring
+         *  every class. The enrolled class vectors are built into it, and
+         *  later enrollments are added; the gallery takes ownership
+         */
+        void useIndex(NearestNeighborIndex *index);
+        
+        /** Returns the number of enrolled subjects */
+        int size(void) const;
+        
+        /** Returns the number of eigenfaces, the length of a weight vector */
+        int dimension(void) const;
+        
+        /** Returns the subject of class index */
+        const csc450Lib_linalg_base::Subject* getSubject(int index) const;
+        
+        /** Returns the class index of the subject, or -1 if not enrolled */
+        int indexOf(const csc450Lib_linalg_base::Subject *subject) const;
+        
+        /** Returns the k x S matrix of class vectors */
+        const csc450Lib_linalg_base::Matrix* getClassWeights(void) const;
+        
+        /** Returns a copy of the class vector of class index */
+        csc450Lib_linalg_base::ColumnVector* getClassVector(int index) const;
+        
+        /**
+         * Returns the k x B weights of the B images (one per column)
+         */
+        csc450Lib_linalg_base::Matrix* project(const csc450Lib_linalg_base::Matrix *images) const;
+        
+        /**
+         * Returns the enrolled subject nearest to the probe, and its
+         *  distance in weight space when distance is not NULL
+         */
+        const csc450Lib_linalg_base::Subject* recognize(const csc450Lib_linalg_base::ColumnVector *probe,
+                                                        float *distance = NULL) const;
+        
+        /**
+         * Recognizes a batch of probes (one per column)
+         *
+         * @param matches
+         *          Receives the nearest subject of each probe
+         *
+         * @param distances
+         *          When not NULL, receives the distance of each probe to
+         *          its nearest class in weight space
+         */
+        void recognizeBatch(const csc450Lib_linalg_base::Matrix *probes,
+                            const csc450Lib_linalg_base::Subject **matches,
+                            float *distances = NULL) const;
+    };
+}
+#endif /* defined(____FaceGallery_included__) */
@@ -0,0 +1,81 @@
+//
+//  FaceProjector.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____FaceProjector_included__
+#define ____FaceProjector_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <vector>
+
+#include "Matrix.h"
+#include "ColumnVector.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Fused "center + project + reconstruct + residual" kernel for single
+     *  probes. The probe is streamed once: each pixel is centered, added to
+     *  the running weights w = transpose(E) * (x - psi) scaled by its row of
+     *  eigenfaces, and squared into |x - psi|^2. The distance from face
+     *  space then follows from
+     *
+     *      |phi - E w|^2 = |phi|^2 - 2 |w|^2 + transpose(w) * G * w
+     *
+     *  with G = transpose(E) * E cached at construction, so no
+     *  reconstruction is ever formed. When that difference cancels badly
+     *  (a probe very close to face space) the residual is recomputed with a
+     *  second, exact pass.
+     *
+     * Nothing is allocated per probe. The inner loop (AVX-512, AVX2+FMA or
+     *  portable C++) is picked once, at runtime, from what the CPU supports
+     */
+    class FaceProjector {
+    private:
+        /** The eigenfaces, one per column (not owned) */
+        const csc450Lib_linalg_base::Matrix *eigenfaces;
+        
+        /** The average face (not owned) */
+        const csc450Lib_linalg_base::ColumnVector *averageFace;
+        
+        /** transpose(E) * E, k x k */
+        std::vector<float> gram;
+        
+    public:
+        
+        /**
+         * Builds a projector over the given eigenfaces and average face,
+         *  which must outlive it
+         */
+        FaceProjector(const csc450Lib_linalg_base::Matrix *eigenfaces,
+                      const csc450Lib_linalg_base::ColumnVector *averageFace);
+        
+        /** Returns the number of eigenfaces, the length of a weight vector */
+        int dimension(void) const;
+        
+        /**
+         * Projects the image onto the eigenfaces
+         *
+         * @param image
+         *          The probe, as long as an eigenface
+         *
+         * @param weights
+         *          Receives the dimension() weights of the image
+         *
+         * @return the distance from face space, |phi - E w|
+         */
+        float project(const csc450Lib_linalg_base::ColumnVector *image,
+                      float *weights) const;
+    };
+}
+#endif /* defined(____FaceProjector_included__) */
@@ -0,0 +1,66 @@
+//
+//  FaceScorer.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____FaceScorer_included__
+#define ____FaceScorer_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include "ScoringMetric.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Defines the base class for the ways a FacialRecognizer can rank its
+     *  subjects. A scorer maps the eigenface weights of an image to a
+     *  feature vector (whitened, projected on Fisherfaces, ...), and
+     *  compares feature vectors with its ScoringMetric. The maps are
+     *  linear, so the features of a class vector are the class vector of
+     *  the features
+     */
+    class FaceScorer {
+    protected:
+        
+        /** Length of the weight vectors */
+        int inputs;
+        
+        /** Length of the feature vectors */
+        int outputs;
+        
+        /** How feature vectors are compared */
+        ScoringMetric metric;
+        
+        FaceScorer(int dimension, int features, ScoringMetric metric);
+        
+    public:
+        
+        /** Nothing to release in the base class */
+        virtual ~FaceScorer(void);
+        
+        /** Returns the number of eigenfaces, the length of a weight vector */
+        int dimension(void) const;
+        
+        /** Returns the length of a feature vector */
+        int features(void) const;
+        
+        /** Returns how feature vectors are compared */
+        ScoringMetric getMetric(void) const;
+        
+        /** Maps dimension() weights to features() features */
+        virtual void transform(const float *weights, float *features) const = 0;
+        
+        /** Returns the distance between two feature vectors, smaller nearer */
+        float distance(const float *a, const float *b) const;
+    };
+}
+#endif /* defined(____FaceScorer_included__) */
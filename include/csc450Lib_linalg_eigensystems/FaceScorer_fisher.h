@@ -0,0 +1,86 @@
+//
+//  FaceScorer_fisher.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____FaceScorer_fisher_included__
+#define ____FaceScorer_fisher_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include "Matrix.h"
+#include "ColumnVector.h"
+#include "Subject.h"
+#include "FaceScorer.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Subclass of FaceScorer which projects the eigenface weights on the
+     *  Fisherfaces (Belhumeur et al., "Eigenfaces vs. Fisherfaces"): linear
+     *  discriminant analysis run in eigenface space. With Sw and Sb the
+     *  within- and between-class scatter of the subjects' weights, the
+     *  features are transpose(V) * w for the leading solutions of
+     *
+     *      Sb v = lambda Sw v,    transpose(V) * Sw * V = I
+     *
+     *  At most numSubjects - 1 are meaningful, so the features are far
+     *  fewer than the eigenfaces, and being whitened for the within-class
+     *  scatter they are compared as they are
+     */
+    class FaceScorer_fisher : public FaceScorer {
+    private:
+        
+        /** The discriminant directions in eigenface space, one per column */
+        csc450Lib_linalg_base::Matrix *directions;
+        
+        FaceScorer_fisher(csc450Lib_linalg_base::Matrix *directions,
+                          ScoringMetric metric);
+        
+    public:
+        
+        ~FaceScorer_fisher(void);
+        
+        /**
+         * Trains a scorer on the subjects' images, projected on the given
+         *  eigenfaces and average face
+         *
+         * @param features
+         *          Number of Fisherfaces to keep, at most (and by default)
+         *          numSubjects - 1
+         *
+         * @param regularization
+         *          Added to the diagonal of Sw, as a fraction of its average
+         *          diagonal entry, so that it stays positive definite when a
+         *          subject has fewer images than there are eigenfaces
+         */
+        static FaceScorer_fisher* train(int numSubjects,
+                                        const csc450Lib_linalg_base::Subject *subjects[],
+                                        const csc450Lib_linalg_base::Matrix *eigenfaces,
+                                        const csc450Lib_linalg_base::ColumnVector *averageFace,
+                                        int features = 0,
+                                        ScoringMetric metric = SCORE_EUCLIDEAN,
+                                        float regularization = 1e-3f);
+        
+        /** Returns the discriminant directions in eigenface space */
+        const csc450Lib_linalg_base::Matrix* getDirections(void) const;
+        
+        /**
+         * Returns the Fisherfaces, eigenfaces * V, one per column, as
+         *  images. Their pixel products with a centered image give the
+         *  features directly
+         */
+        csc450Lib_linalg_base::Matrix* getFisherfaces(const csc450Lib_linalg_base::Matrix *eigenfaces) const;
+        
+        void transform(const float *weights, float *features) const;
+    };
+}
+#endif /* defined(____FaceScorer_fisher_included__) */
@@ -0,0 +1,37 @@
+//
+//  FaceScorer_pca.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____FaceScorer_pca_included__
+#define ____FaceScorer_pca_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include "FaceScorer.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Subclass of FaceScorer which compares the eigenface weights as they
+     *  are. With SCORE_EUCLIDEAN it ranks as a FacialRecognizer without a
+     *  scorer does
+     */
+    class FaceScorer_pca : public FaceScorer {
+    public:
+        
+        /** Builds a scorer of k weights */
+        FaceScorer_pca(int k, ScoringMetric metric = SCORE_EUCLIDEAN);
+        
+        void transform(const float *weights, float *features) const;
+    };
+}
+#endif /* defined(____FaceScorer_pca_included__) */
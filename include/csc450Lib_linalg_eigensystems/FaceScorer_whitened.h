@@ -0,0 +1,59 @@
+//
+//  FaceScorer_whitened.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____FaceScorer_whitened_included__
+#define ____FaceScorer_whitened_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <vector>
+
+#include "ColumnVector.h"
+#include "FaceScorer.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Subclass of FaceScorer which whitens the eigenface weights, dividing
+     *  each by the standard deviation of the training images along its
+     *  eigenface. The leading eigenfaces, mostly lighting, then no longer
+     *  outweigh the others: with SCORE_EUCLIDEAN the distance is the
+     *  Mahalanobis distance of the weights, with SCORE_COSINE the whitened
+     *  cosine
+     */
+    class FaceScorer_whitened : public FaceScorer {
+    private:
+        
+        /** 1 / standard deviation, per eigenface */
+        std::vector<float> scale;
+        
+    public:
+        
+        /**
+         * Builds a scorer from the eigenvalues of transpose(A) * A (as an
+         *  EigenfaceModel or the squared singular values of A give them),
+         *  one per eigenface
+         *
+         * @param regularization
+         *          Added to every eigenvalue, as a fraction of the largest,
+         *          so that the weakest eigenfaces (mostly noise) are not
+         *          blown up
+         */
+        FaceScorer_whitened(const csc450Lib_linalg_base::ColumnVector *eigenvalues,
+                            ScoringMetric metric = SCORE_EUCLIDEAN,
+                            float regularization = 1e-3f);
+        
+        void transform(const float *weights, float *features) const;
+    };
+}
+#endif /* defined(____FaceScorer_whitened_included__) */
@@ -24,6 +24,9 @@
 #include "RowVector.h"
 #include "EigenSystem.h"
 #include "Subject.h"
+#include "FaceGallery.h"
+#include "FaceProjector.h"
+#include "FaceScorer.h"
 
 namespace csc450Lib_linalg_eigensystems {
     
@@ -39,6 +42,27 @@ namespace csc450Lib_linalg_eigensystems {
         const csc450Lib_linalg_base::ColumnVector *averageFace;
         csc450Lib_linalg_base::ColumnVector *input;
         
+        /** Cached class vectors of the face classes */
+        FaceGallery *gallery;
+        
+        /** Fused projection of single probes */
+        FaceProjector *projector;
+        
+        /** How the subjects are ranked, NULL for distances between weights */
+        FaceScorer *scorer;
+        
+        /** Features of the class vectors under the scorer, one per row */
+        csc450Lib_linalg_base::Matrix *classFeatures;
+        
+        /**
+         * Scores the current input against every subject under the scorer,
+         *  returning the index of the nearest and its distance
+         */
+        int nearestClass(float *distance) const;
+        
+        /** Makes a copy of the given image the current input */
+        void setInput(const csc450Lib_linalg_base::ColumnVector *input);
+        
         csc450Lib_linalg_base::ColumnVector* getWeights(const csc450Lib_linalg_base::ColumnVector *input) const;
         
     public:
@@ -54,6 +78,16 @@ namespace csc450Lib_linalg_eigensystems {
                          const csc450Lib_linalg_base::ColumnVector *averageFace,
                          const csc450Lib_linalg_base::ColumnVector *input);
         ~FacialRecognizer(void);
+        
+        /**
+         * Ranks the subjects with the given scorer (taking ownership of
+         *  it), or by distance between eigenface weights when NULL. The
+         *  scorer must take as many weights as there are eigenfaces
+         */
+        void setScorer(FaceScorer *scorer);
+        
+        /** Returns the scorer the subjects are ranked with, or NULL */
+        const FaceScorer* getScorer(void) const;
 
 		/** Calculates the distance from the Face Space */
         float distFromFaceSpace(void) const;
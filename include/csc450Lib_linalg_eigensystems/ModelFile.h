@@ -0,0 +1,139 @@
+//
+//  ModelFile.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____ModelFile_included__
+#define ____ModelFile_included__
+
+//=================================
+// forward declared dependencies
+namespace csc450Lib_linalg_eigensystems {
+    class EigenfaceModel;
+    class FaceGallery;
+}
+
+//=================================
+// included dependencies
+#include <stdint.h>
+#include <string>
+
+#include "Matrix.h"
+#include "ColumnVector.h"
+#include "BasisFormat.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * A trained model saved in one binary file and memory-mapped on load,
+     *  so that a recognizer starts without parsing anything and processes
+     *  serving the same model share its pages.
+     *
+     * The file holds a 128-byte header (magic "EFMODEL", version, basis
+     *  format, image width and height, pixels per image N, number of
+     *  eigenfaces k, number of subjects S, number of training images and
+     *  the offset of each section), then, each at a 64-byte aligned
+     *  offset: the mean face (N floats), the eigenvalues (k floats), the
+     *  per-eigenface scales (k floats), the eigenfaces (N x k, pixel-major
+     *  like a Matrix, in the basis format), the subject ids (S 32-bit
+     *  ints) and the class vectors (k x S floats). All fields are
+     *  little-endian.
+     *
+     * Everything but a quantized basis is handed out as zero-copy views of
+     *  the mapping; a quantized basis is expanded to floats once, on load
+     */
+    class ModelFile {
+    private:
+        /** Start of the mapping */
+        unsigned char *base;
+        
+        /** Length of the mapping in bytes */
+        size_t length;
+        
+        BasisFormat format;
+        int width;
+        int height;
+        int imageCount;
+        
+        /** Subject ids, in class vector order */
+        const int32_t *ids;
+        
+        csc450Lib_linalg_base::ColumnVector *mean;
+        csc450Lib_linalg_base::ColumnVector *eigenvalues;
+        csc450Lib_linalg_base::Matrix *eigenfaces;
+        csc450Lib_linalg_base::Matrix *classWeights;
+        
+    public:
+        
+        /**
+         * Maps a model file. Throws if the file cannot be opened or is not
+         *  a model
+         */
+        ModelFile(const std::string &filename);
+        
+        /** Unmaps the file; the views handed out die with it */
+        ~ModelFile(void);
+        
+        /**
+         * Writes the model, and the class vectors and ids of the subjects
+         *  enrolled in gallery when it is not NULL, to filename
+         *
+         * @param width
+         *          Width of the images the model was trained on
+         *
+         * @param height
+         *          Height of the images; width * height must be the length
+         *          of the eigenfaces
+         *
+         * @param format
+         *          How to store the eigenfaces
+         */
+        static void save(const std::string &filename,
+                         const EigenfaceModel *model,
+                         const FaceGallery *gallery,
+                         int width, int height,
+                         BasisFormat format = BASIS_FLOAT32);
+        
+        /** Returns the storage format of the eigenfaces */
+        BasisFormat getFormat(void) const;
+        
+        /** Returns the width of the images */
+        int getWidth(void) const;
+        
+        /** Returns the height of the images */
+        int getHeight(void) const;
+        
+        /** Returns the number of images the model was trained on */
+        int getImageCount(void) const;
+        
+        /** Returns the number of eigenfaces */
+        int dimension(void) const;
+        
+        /** Returns the number of subjects */
+        int size(void) const;
+        
+        /** Returns the average face */
+        const csc450Lib_linalg_base::ColumnVector* getMean(void) const;
+        
+        /** Returns the eigenfaces, one per column */
+        const csc450Lib_linalg_base::Matrix* getEigenfaces(void) const;
+        
+        /** Returns the eigenvalues of transpose(A) * A */
+        const csc450Lib_linalg_base::ColumnVector* getEigenValues(void) const;
+        
+        /** Returns the k x S matrix of class vectors */
+        const csc450Lib_linalg_base::Matrix* getClassWeights(void) const;
+        
+        /** Returns the id of the subject of class index */
+        int getSubjectID(int index) const;
+        
+        /** Returns a new model holding copies of the stored one */
+        EigenfaceModel* getModel(void) const;
+    };
+}
+#endif /* defined(____ModelFile_included__) */
@@ -0,0 +1,104 @@
+//
+//  NearestNeighborIndex.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____NearestNeighborIndex_included__
+#define ____NearestNeighborIndex_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <iostream>
+#include <string>
+
+#include "Matrix.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Defines the base class for nearest-neighbour indexes over weight
+     *  vectors (squared L2 distance). Vectors get consecutive ids in the
+     *  order they are added, starting at 0
+     */
+    class NearestNeighborIndex {
+    public:
+        
+        /// Nothing to release in the base class
+        virtual ~NearestNeighborIndex(void);
+        
+        /// Returns the length of the indexed vectors
+        virtual int dimension(void) const = 0;
+        
+        /// Returns the number of indexed vectors
+        virtual int size(void) const = 0;
+        
+        /// Indexes the columns of vectors (dimension() x n). The default
+        ///	adds them one by one; indexes that need training override it
+        virtual void build(const csc450Lib_linalg_base::Matrix *vectors);
+        
+        /// Adds one vector of dimension() floats and returns its id
+        virtual int add(const float *vector) = 0;
+        
+        /// Finds (up to) the k nearest vectors to query, nearest first.
+        ///	Fills ids and, when not NULL, squared distances; returns how
+        ///	many were found
+        virtual int search(const float *query, int k,
+                           int *ids, float *distances) const = 0;
+        
+        /// Writes the index to a binary file, to be read back with load()
+        virtual void save(const std::string &filename) const = 0;
+        
+        /// Reads an index written by save(), whatever its kind. Throws if
+        ///	the file cannot be read
+        static NearestNeighborIndex* load(const std::string &filename);
+        
+        /// Returns the squared L2 distance between two vectors of length n
+        static inline float squaredDistance(int n, const float *x, const float *y) {
+            // Independent partial sums let the compiler vectorize the loop
+            float lanes[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+            int i = 0;
+            for (; i + 8 <= n; i += 8) {
+                for (int l = 0; l < 8; l++) {
+                    float d = x[i + l] - y[i + l];
+                    lanes[l] += d * d;
+                }
+            }
+            float sum = 0;
+            for (; i < n; i++)
+                sum += (x[i] - y[i]) * (x[i] - y[i]);
+            for (int l = 0; l < 8; l++)
+                sum += lanes[l];
+            return sum;
+        }
+        
+    protected:
+        
+        /// Writes the kind tag and the subclass data
+        virtual void write(std::ostream &out) const = 0;
+        
+        /// Opens filename and calls write() on it
+        void writeFile(const std::string &filename) const;
+        
+        /// Binary helpers for write() and the subclass readers
+        template <class T>
+        static void writeArray(std::ostream &out, const T *values, size_t n) {
+            out.write((const char*)values, n * sizeof(T));
+        }
+        
+        template <class T>
+        static void readArray(std::istream &in, T *values, size_t n) {
+            in.read((char*)values, n * sizeof(T));
+            if (!in)
+                throw "Truncated index file";
+        }
+    };
+}
+#endif /* defined(____NearestNeighborIndex_included__) */
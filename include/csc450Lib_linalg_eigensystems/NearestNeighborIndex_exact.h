@@ -0,0 +1,56 @@
+//
+//  NearestNeighborIndex_exact.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____NearestNeighborIndex_exact_included__
+#define ____NearestNeighborIndex_exact_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <vector>
+
+#include "NearestNeighborIndex.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Subclass of NearestNeighborIndex which scans every vector. Exact, and
+     *  the reference the approximate indexes are measured against
+     */
+    class NearestNeighborIndex_exact : public NearestNeighborIndex {
+    private:
+        
+        int dim;
+        
+        /// The vectors, one after the other
+        std::vector<float> vectors;
+        
+    protected:
+        
+        void write(std::ostream &out) const;
+        
+    public:
+        
+        /// Creates an empty index over vectors of the given dimension
+        NearestNeighborIndex_exact(int dimension);
+        
+        /// Reads the data written by write(), past the kind tag
+        static NearestNeighborIndex_exact* read(std::istream &in);
+        
+        int dimension(void) const;
+        int size(void) const;
+        int add(const float *vector);
+        int search(const float *query, int k, int *ids, float *distances) const;
+        void save(const std::string &filename) const;
+    };
+}
+#endif /* defined(____NearestNeighborIndex_exact_included__) */
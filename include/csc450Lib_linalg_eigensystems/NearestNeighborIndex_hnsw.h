@@ -0,0 +1,108 @@
+//
+//  NearestNeighborIndex_hnsw.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____NearestNeighborIndex_hnsw_included__
+#define ____NearestNeighborIndex_hnsw_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "NearestNeighborIndex.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Subclass of NearestNeighborIndex which implements a hierarchical
+     *  navigable small world graph (Malkov and Yashunin). Every vector is a
+     *  node of layer 0 and, with geometrically decreasing probability, of
+     *  the layers above; a search descends greedily from the single node
+     *  of the top layer, then runs a beam search of width efSearch on
+     *  layer 0. Neighbours are chosen with the diversity heuristic of the
+     *  paper. Searches on one index must not run concurrently with add()
+     */
+    class NearestNeighborIndex_hnsw : public NearestNeighborIndex {
+    private:
+        
+        int dim;
+        
+        /// Links per node on the upper layers; twice as many on layer 0
+        int m;
+        
+        /// Beam width while inserting
+        int efConstruction;
+        
+        /// Beam width while searching
+        int efSearch;
+        
+        /// Scale of the random layer assignment, 1 / ln(m)
+        double levelMult;
+        
+        /// Node the searches start from, and its layer
+        int entry;
+        int maxLevel;
+        
+        /// The vectors, one after the other
+        std::vector<float> vectors;
+        
+        /// neighbors[node][layer] lists the links of node on that layer
+        std::vector<std::vector<std::vector<int> > > neighbors;
+        
+        std::mt19937 generator;
+        
+        const float* vectorAt(int id) const;
+        
+        /// Walks layer to the node nearest to query, from ep
+        int greedy(const float *query, int ep, int layer) const;
+        
+        /// Beam search of width ef on layer, from ep. Returns
+        ///	(distance, id) pairs, nearest first
+        std::vector<std::pair<float, int> > searchLayer(const float *query,
+                                                        int ep, int ef,
+                                                        int layer) const;
+        
+        /// Picks at most count diverse neighbours among the candidates
+        ///	(sorted nearest first)
+        std::vector<int> selectNeighbors(const std::vector<std::pair<float, int> > &candidates,
+                                         int count) const;
+        
+        /// Prunes the links of node on layer back to the layer's limit
+        void shrink(int node, int layer);
+        
+    protected:
+        
+        void write(std::ostream &out) const;
+        
+    public:
+        
+        /// Creates an empty index over vectors of the given dimension
+        NearestNeighborIndex_hnsw(int dimension, int m = 16,
+                                  int efConstruction = 200);
+        
+        /// Reads the data written by write(), past the kind tag
+        static NearestNeighborIndex_hnsw* read(std::istream &in);
+        
+        /// Sets the beam width of searches (64 by default); wider is
+        ///	slower and more accurate
+        void setEfSearch(int efSearch);
+        
+        int dimension(void) const;
+        int size(void) const;
+        int add(const float *vector);
+        int search(const float *query, int k, int *ids, float *distances) const;
+        void save(const std::string &filename) const;
+    };
+}
+#endif /* defined(____NearestNeighborIndex_hnsw_included__) */
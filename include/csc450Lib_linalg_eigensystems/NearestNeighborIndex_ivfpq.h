@@ -0,0 +1,103 @@
+//
+//  NearestNeighborIndex_ivfpq.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____NearestNeighborIndex_ivfpq_included__
+#define ____NearestNeighborIndex_ivfpq_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <stdint.h>
+#include <vector>
+
+#include "NearestNeighborIndex.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Subclass of NearestNeighborIndex which implements an inverted file
+     *  with product quantization (Jegou et al.). A coarse k-means splits
+     *  the space into lists; the residual of each vector to its list
+     *  centroid is cut into sub-vectors, each stored as the byte index of
+     *  its nearest codeword. A search visits the nprobe nearest lists and
+     *  ranks their codes with per-query distance tables, so each candidate
+     *  costs one table lookup per sub-vector instead of a full distance.
+     *  Distances returned are the approximate (quantized) ones.
+     *
+     * The index must be trained before vectors are added; build() trains
+     *  on the vectors it is given, then adds them
+     */
+    class NearestNeighborIndex_ivfpq : public NearestNeighborIndex {
+    private:
+        
+        int dim;
+        
+        /// Number of coarse lists
+        int nlist;
+        
+        /// Number of sub-vectors, and their (padded) length
+        int msub;
+        int dsub;
+        
+        /// Codewords per sub-quantizer, at most 256
+        int ksub;
+        
+        /// Lists visited per search
+        int nprobe;
+        
+        int count;
+        bool trained;
+        
+        /// nlist x dim coarse centroids
+        std::vector<float> coarse;
+        
+        /// msub codebooks of ksub x dsub codewords
+        std::vector<float> codebooks;
+        
+        /// Ids and msub-byte codes of the vectors of each list
+        std::vector<std::vector<int> > listIds;
+        std::vector<std::vector<uint8_t> > listCodes;
+        
+        /// Returns the coarse list nearest to x
+        int assign(const float *x) const;
+        
+    protected:
+        
+        void write(std::ostream &out) const;
+        
+    public:
+        
+        /// Creates an untrained index over vectors of the given dimension
+        NearestNeighborIndex_ivfpq(int dimension, int nlist = 256,
+                                   int msub = 8);
+        
+        /// Reads the data written by write(), past the kind tag
+        static NearestNeighborIndex_ivfpq* read(std::istream &in);
+        
+        /// Sets the number of lists visited per search (8 by default)
+        void setNprobe(int nprobe);
+        
+        /// Learns the coarse centroids and the codebooks from the columns
+        ///	of vectors (dimension() x n)
+        void train(const csc450Lib_linalg_base::Matrix *vectors);
+        
+        /// Trains on the columns of vectors, then adds them
+        void build(const csc450Lib_linalg_base::Matrix *vectors);
+        
+        int dimension(void) const;
+        int size(void) const;
+        int add(const float *vector);
+        int search(const float *query, int k, int *ids, float *distances) const;
+        void save(const std::string &filename) const;
+    };
+}
+#endif /* defined(____NearestNeighborIndex_ivfpq_included__) */
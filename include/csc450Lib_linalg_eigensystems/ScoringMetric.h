@@ -0,0 +1,34 @@
+//
+//  ScoringMetric.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____ScoringMetric_included__
+#define ____ScoringMetric_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+
+namespace csc450Lib_linalg_eigensystems {
+    /**
+     * Enumeration of the ways a FaceScorer compares two feature vectors
+     */
+    enum ScoringMetric {
+        /** L2 distance. On whitened features, the Mahalanobis distance of
+         *  the weights */
+        SCORE_EUCLIDEAN,
+        
+        /** One minus the cosine of the angle between the vectors, blind to
+         *  their lengths and so to the overall contrast of the image */
+        SCORE_COSINE
+    };
+}
+#endif /* defined(____ScoringMetric_included__) */
@@ -0,0 +1,76 @@
+//
+//  SingularValueDecomposition.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____SingularValueDecomposition_included__
+#define ____SingularValueDecomposition_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include "Matrix.h"
+#include "ColumnVector.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Record of a thin singular value decomposition A = U * S * transpose(V)
+     *  of an m x n matrix, truncated to its numerical rank r: U is m x r
+     *  with orthonormal columns, S holds the r nonzero singular values in
+     *  decreasing order and V is n x r with orthonormal columns
+     */
+    class SingularValueDecomposition {
+    private:
+        /** Numerical rank of the decomposed matrix */
+        int rank;
+        
+        /** Left singular vectors, one per column */
+        csc450Lib_linalg_base::Matrix *u;
+        
+        /** Singular values, in decreasing order */
+        csc450Lib_linalg_base::ColumnVector *s;
+        
+        /** Right singular vectors, one per column */
+        csc450Lib_linalg_base::Matrix *v;
+        
+    public:
+        
+        /**
+         * Takes ownership of u, s and v
+         */
+        SingularValueDecomposition(csc450Lib_linalg_base::Matrix *u,
+                                   csc450Lib_linalg_base::ColumnVector *s,
+                                   csc450Lib_linalg_base::Matrix *v);
+        ~SingularValueDecomposition(void);
+        
+        /** Returns the numerical rank r */
+        int getRank(void) const;
+        
+        /** Returns the m x r matrix of left singular vectors */
+        csc450Lib_linalg_base::Matrix* getU(void) const;
+        
+        /** Returns the r singular values, in decreasing order */
+        csc450Lib_linalg_base::ColumnVector* getSingularValues(void) const;
+        
+        /** Returns the n x r matrix of right singular vectors */
+        csc450Lib_linalg_base::Matrix* getV(void) const;
+        
+        /** Returns the singular value at the given index */
+        float getSingularValue(int index) const;
+        
+        /** Returns a copy of the left singular vector at the given index */
+        csc450Lib_linalg_base::ColumnVector* getLeftSingularVector(int index) const;
+        
+        /** Returns a copy of the right singular vector at the given index */
+        csc450Lib_linalg_base::ColumnVector* getRightSingularVector(int index) const;
+    };
+}
+#endif /* defined(____SingularValueDecomposition_included__) */
@@ -0,0 +1,83 @@
+//
+//  SingularValueSolver.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____SingularValueSolver_included__
+#define ____SingularValueSolver_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include "Matrix.h"
+#include "ColumnVector.h"
+#include "SingularValueDecomposition.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Computes thin singular value decompositions, aimed at tall-skinny
+     *  matrices such as the centered face matrix A (one image per column).
+     *  The left singular vectors of A are the eigenfaces, and the squares
+     *  of its singular values the eigenvalues of transpose(A) * A, so this
+     *  trains the recognizer without forming the Gram matrix and squaring
+     *  its condition number.
+     *
+     * A (m x n, m >= n) is first reduced to its n x n triangular factor R
+     *  by Householder QR, then R is diagonalized by one-sided Jacobi
+     *  rotations in double precision, which gives S and V. The left
+     *  singular vectors follow from a single GEMM, U = A * V * inverse(S).
+     *  Both stages spread their independent rows (QR updates, disjoint
+     *  Jacobi pairs) across threads when they are large enough
+     */
+    class SingularValueSolver {
+    private:
+        
+        const csc450Lib_linalg_base::Matrix *a;
+        
+        /**
+         * Computes the R factor of the QR decomposition of the m x n
+         *  matrix whose columns are the n rows of x (m floats each, ldx
+         *  between rows). x is overwritten with the Householder vectors;
+         *  R is stored transposed in the n x n array w, so that row i of w
+         *  holds column i of R
+         */
+        static void triangularize(int m, int n, float *x, int ldx, double *w);
+        
+        /**
+         * Orthogonalizes the n rows of the n x n array w against each other
+         *  by one-sided Jacobi rotations, applying the same rotations to the
+         *  rows of v. Returns false when the sweeps do not converge
+         */
+        static bool jacobi(int n, double *w, double *v);
+        
+        /**
+         * Decomposes a, which must have at least as many rows as columns
+         */
+        static SingularValueDecomposition* tallSVD(const csc450Lib_linalg_base::Matrix *a);
+        
+    public:
+        
+        SingularValueSolver(const csc450Lib_linalg_base::Matrix *a);
+        
+        /**
+         * Returns the thin SVD of the matrix this solver was built with
+         */
+        const SingularValueDecomposition* solve(void) const;
+        
+        /**
+         * Returns the thin SVD of a, truncated to its numerical rank:
+         *  singular values below max(m, n) * FLT_EPSILON times the largest
+         *  one are dropped, along with their singular vectors
+         */
+        static SingularValueDecomposition* thinSVD(const csc450Lib_linalg_base::Matrix *a);
+    };
+}
+#endif /* defined(____SingularValueSolver_included__) */
@@ -0,0 +1,140 @@
+//
+//  StreamingPCA.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____StreamingPCA_included__
+#define ____StreamingPCA_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <string>
+#include <vector>
+
+#include "Matrix.h"
+#include "ColumnVector.h"
+#include "StreamingPCAMode.h"
+
+namespace csc450Lib_linalg_eigensystems {
+    
+    /**
+     * Trains eigenfaces from a list of image files without holding the
+     *  gallery in memory. Images are read in blocks whose size is derived
+     *  from a memory budget: the first pass accumulates the average face,
+     *  the following ones accumulate either the Gram matrix of the centered
+     *  images or a randomized sketch of their span (see StreamingPCAMode)
+     */
+    class StreamingPCA {
+    private:
+        /** Image files of the gallery */
+        std::vector<std::string> files;
+        
+        /** Width of the image files */
+        int width;
+        
+        /** Height of the image files, and side of the square kept */
+        int height;
+        
+        /** Number of pixels of an image vector */
+        int pixels;
+        
+        /** Peak number of bytes the trainer may allocate */
+        size_t memoryBudget;
+        
+        /** Second-pass strategy */
+        StreamingPCAMode mode;
+        
+        /** Extra sketch directions beyond the eigenfaces kept */
+        int oversampling;
+        
+        /** Extra passes of subspace iteration refining the sketch */
+        int powerIterations;
+        
+        /** Number of image files read so far */
+        long imagesRead;
+        
+        /** The average face */
+        csc450Lib_linalg_base::ColumnVector *mean;
+        
+        /** The eigenfaces, unit vectors, one per column */
+        csc450Lib_linalg_base::Matrix *eigenfaces;
+        
+        /** Eigenvalues of transpose(A) * A matching the eigenfaces */
+        csc450Lib_linalg_base::ColumnVector *eigenvalues;
+        
+        /**
+         * Reads count images starting at first into the rows of block,
+         *  subtracting the average face when center is true
+         */
+        void loadBlock(int first, int count,
+                       csc450Lib_linalg_base::Matrix *block, bool center);
+        
+        /**
+         * Returns how many images fit in a block when fixed bytes are
+         *  already spoken for and each image costs perImage bytes
+         */
+        int blockSize(size_t fixed, size_t perImage) const;
+        
+        void trainGram(int k);
+        void trainSketch(int k);
+        
+    public:
+        
+        /**
+         * @param files
+         *          Image files of the gallery
+         *
+         * @param memoryBudget
+         *          Peak number of bytes training may allocate
+         *
+         * @param mode
+         *          Second-pass strategy
+         */
+        StreamingPCA(const std::vector<std::string> &files,
+                     size_t memoryBudget,
+                     StreamingPCAMode mode = GRAM_TILES,
+                     int width = 320, int height = 243);
+        ~StreamingPCA(void);
+        
+        /**
+         * Sets the number of extra directions of the randomized sketch
+         *  (10 by default). More gives better accuracy for more memory
+         */
+        void setOversampling(int oversampling);
+        
+        /**
+         * Sets the number of subspace iterations refining the randomized
+         *  sketch (2 by default). Each costs one more pass over the images
+         *  and sharpens the eigenfaces when the spectrum decays slowly
+         */
+        void setPowerIterations(int powerIterations);
+        
+        /**
+         * Computes the average face and the k leading eigenfaces. Fewer
+         *  are kept when the centered images span less than k dimensions.
+         *  Throws when the budget cannot hold the mode's working set
+         */
+        void train(int k);
+        
+        /** Returns the average face */
+        csc450Lib_linalg_base::ColumnVector* getMean(void) const;
+        
+        /** Returns the eigenfaces, one per column */
+        csc450Lib_linalg_base::Matrix* getEigenfaces(void) const;
+        
+        /** Returns the eigenvalues of transpose(A) * A, in decreasing order */
+        csc450Lib_linalg_base::ColumnVector* getEigenValues(void) const;
+        
+        /** Returns the number of image files read by training */
+        long getImagesRead(void) const;
+    };
+}
+#endif /* defined(____StreamingPCA_included__) */
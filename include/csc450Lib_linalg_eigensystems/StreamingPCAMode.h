@@ -0,0 +1,42 @@
+//
+//  StreamingPCAMode.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____StreamingPCAMode_included__
+#define ____StreamingPCAMode_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+
+namespace csc450Lib_linalg_eigensystems {
+    /**
+     * Enumeration of the second-pass strategies of a StreamingPCA
+     */
+    enum StreamingPCAMode {
+        /** Accumulates the full M x M Gram matrix tile by tile, then streams
+         *  the images once more to form the eigenfaces. Exact, but needs
+         *  the Gram matrix to fit in the memory budget. The rest of the
+         *  budget caches a panel of images; with P equal panels the gallery
+         *  is read 1 + (P - 1) / 2 + 2 (P - 1) / P times: once when it fits
+         *  in the cache, 2.5 times for two panels, and growing with P, so
+         *  large galleries on small budgets belong to RANDOMIZED_SKETCH */
+        GRAM_TILES,
+        
+        /** Accumulates a randomized sketch of the range of A alongside the
+         *  mean, refines it by subspace iteration, then projects the images
+         *  onto it. Two passes plus one per refinement, and memory grows
+         *  with the number of eigenfaces kept rather than with the square
+         *  of the gallery size */
+        RANDOMIZED_SKETCH
+    };
+}
+#endif /* defined(____StreamingPCAMode_included__) */
@@ -0,0 +1,137 @@
+//
+//  LUFactorization.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____LUFactorization_included__
+#define ____LUFactorization_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include <vector>
+
+#include "Matrix.h"
+#include "ColumnVector.h"
+
+namespace csc450Lib_linalg_sle {
+
+    /**
+     * The LU factorization of a square matrix, with partial pivoting, kept
+     *  so that it can be reused. The O(n^3) factorization is done once, at
+     *  construction; every right-hand side after that costs O(n^2).
+     *
+     * Right-hand sides are solved together, as the columns of a matrix,
+     *  with blocked triangular solves (MatrixMultiplier::trsm), so solving
+     *  for many columns runs at the speed of a matrix product
+     */
+    class LUFactorization {
+    private:
+        /** The factorized matrix (not owned), for iterative refinement */
+        const csc450Lib_linalg_base::Matrix *a;
+
+        /** L below the diagonal (unit diagonal implied) and U on and above */
+        csc450Lib_linalg_base::Matrix *lu;
+
+        /** At step i, row i was swapped with row pivots[i] */
+        std::vector<int> pivots;
+
+        /** Whether a zero pivot was met */
+        bool singular;
+
+        /**
+         * Improves the solution x of A x = b with the given number of steps
+         *  of iterative refinement
+         */
+        void refine(const csc450Lib_linalg_base::Matrix *b,
+                    csc450Lib_linalg_base::Matrix *x, int steps) const;
+
+    public:
+
+        /**
+         * Factorizes the square matrix a, which is copied. It must outlive
+         *  the factorization only if refinement steps are asked of solve(),
+         *  or solveMixed() is used
+         */
+        LUFactorization(const csc450Lib_linalg_base::Matrix *a);
+
+        /** Releases the factors */
+        ~LUFactorization(void);
+
+        /** Returns the order of the factorized matrix */
+        int size(void) const;
+
+        /** Returns whether the matrix is singular (a zero pivot was met) */
+        bool isSingular(void) const;
+
+        /** Returns L and U, together in one matrix */
+        const csc450Lib_linalg_base::Matrix* getFactors(void) const;
+
+        /** Returns the row swaps, as produced by LinearSolver_LU::factorizeInPlace */
+        const int* getPivots(void) const;
+
+        /** Returns the determinant of the matrix, from the diagonal of U */
+        float determinant(void) const;
+
+        /**
+         * Overwrites every column of b (size() x r) with the solution of
+         *  A x = b. Nothing is allocated. Throws if the matrix is singular
+         */
+        void solveInPlace(csc450Lib_linalg_base::Matrix *b) const;
+
+        /**
+         * Solves A X = B for the columns of B
+         *
+         * @param refinementSteps
+         *          Steps of iterative refinement: each computes the residual
+         *          B - A X and solves for a correction with the same factors
+         */
+        csc450Lib_linalg_base::Matrix* solve(const csc450Lib_linalg_base::Matrix *b,
+                                             int refinementSteps = 0) const;
+
+        /** Solves A x = b, for a single right-hand side */
+        csc450Lib_linalg_base::ColumnVector* solve(const csc450Lib_linalg_base::ColumnVector *b,
+                                                   int refinementSteps = 0) const;
+
+        /**
+         * Mixed-precision solve of A x = b. The factors stay in single
+         *  precision, but the residual b - A x is computed, and x
+         *  accumulated, in double. Each step solves for a correction with
+         *  the float factors, until the normwise backward error
+         *
+         *      |b - A x| / (|A| |x| + |b|)     (infinity norms)
+         *
+         *  is at most tolerance. The error shrinks by about
+         *  cond(A) * 2^-24 per step, so x reaches double accuracy in a few
+         *  O(n^2) steps unless A is badly conditioned
+         *
+         * @param b
+         *          n doubles
+         *
+         * @param x
+         *          Receives the n doubles of the solution
+         *
+         * @param tolerance
+         *          Backward error to reach; 0 asks for sqrt(n) times the
+         *          double precision epsilon
+         *
+         * @return
+         *          the number of refinement steps taken, or -1 if the
+         *          tolerance was not met within maxSteps (x then holds the
+         *          last iterate)
+         */
+        int solveMixed(const double *b, double *x,
+                       double tolerance = 0, int maxSteps = 30) const;
+
+        /** Returns the inverse of the matrix, solving for the identity */
+        csc450Lib_linalg_base::Matrix* inverse(int refinementSteps = 0) const;
+    };
+}
+#endif /* defined(____LUFactorization_included__) */
@@ -0,0 +1,71 @@
+//
+//  LinearSolver_Cholesky.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____LinearSolver_Cholesky_included__
+#define ____LinearSolver_Cholesky_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include "LinearSolver.h"
+
+namespace csc450Lib_linalg_sle {
+
+    /**
+     * Subclass of LinearSolver for symmetric positive-definite systems,
+     *  such as Gram matrices. Factorizes A = transpose(U) * U, which takes
+     *  half the flops of LU and needs no pivoting
+     */
+    class LinearSolver_Cholesky : public LinearSolver {
+    public:
+
+        /**
+         * Factorizes the symmetric positive-definite matrix a in place into
+         *  the upper triangular U of A = transpose(U) * U. Only the upper
+         *  triangle of a is read; the strict lower triangle is zeroed.
+         *  Nothing is allocated.
+         *
+         * The factorization is recursive over halves of the matrix, so
+         *  nearly all the work is in TRSM and SYRK updates, which run in
+         *  parallel
+         *
+         * @return
+         *          false if a is not positive definite (a non-positive
+         *          pivot was met)
+         */
+        static bool factorizeInPlace(csc450Lib_linalg_base::Matrix *a);
+
+        /**
+         * Overwrites every column of b with the solution of A x = b, given
+         *  the factor produced by factorizeInPlace. Nothing is allocated
+         */
+        static void solveInPlace(const csc450Lib_linalg_base::Matrix *u,
+                                 csc450Lib_linalg_base::Matrix *b);
+
+        /**
+         * Solves the SLE (with the preset system matrix and right-side term)
+         */
+        const LinearSystemRecord* solve(void) const;
+
+        /**
+         * Solves the SLE (with the preset system matrix)
+         */
+        const LinearSystemRecord* solve(const csc450Lib_linalg_base::ColumnVector *b);
+
+        /**
+         * Solves the SLE
+         */
+        const LinearSystemRecord* solve(const csc450Lib_linalg_base::Matrix *a,
+                                        const csc450Lib_linalg_base::ColumnVector *b);
+    };
+}
+#endif /* defined(____LinearSolver_Cholesky_included__) */
@@ -0,0 +1,83 @@
+//
+//  LinearSolver_LDLT.h
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// include guard
+#ifndef ____LinearSolver_LDLT_included__
+#define ____LinearSolver_LDLT_included__
+
+//=================================
+// forward declared dependencies
+
+//=================================
+// included dependencies
+#include "LinearSolver.h"
+
+namespace csc450Lib_linalg_sle {
+
+    /**
+     * Subclass of LinearSolver for symmetric systems that may be
+     *  indefinite, such as shifted systems A - sigma I. Factorizes
+     *  P A transpose(P) = L D transpose(L) with Bunch-Kaufman pivoting,
+     *  where D is block diagonal with 1 x 1 and 2 x 2 blocks. Only the lower
+     *  triangle is factorized, so this takes half the flops of LU
+     */
+    class LinearSolver_LDLT : public LinearSolver {
+    public:
+
+        /**
+         * Factorizes the symmetric matrix a in place. Only the upper
+         *  triangle of a is read. On return its strict upper triangle holds
+         *  transpose(L) (unit diagonal implied, zero beside each 2 x 2
+         *  block) and its diagonal holds the diagonal of D; the strict lower
+         *  triangle is used as scratch.
+         *
+         * Columns are factorized in panels, each applied to the rest of the
+         *  matrix with one GEMM, which runs in parallel. The panel workspace
+         *  is kept per thread, so only the first call allocates
+         *
+         * @param pivots
+         *          n ints. At step i, row and column i were swapped with
+         *          row and column pivots[i]
+         *
+         * @param offDiagonal
+         *          n floats. offDiagonal[i] is the entry (i + 1, i) of D:
+         *          non-zero where a 2 x 2 block starts at i, zero elsewhere
+         *
+         * @return
+         *          false if a zero pivot was met (a is singular)
+         */
+        static bool factorizeInPlace(csc450Lib_linalg_base::Matrix *a,
+                                     int *pivots, float *offDiagonal);
+
+        /**
+         * Overwrites every column of b with the solution of A x = b, given
+         *  the factors produced by factorizeInPlace. Nothing is allocated
+         */
+        static void solveInPlace(const csc450Lib_linalg_base::Matrix *ldl,
+                                 const int *pivots, const float *offDiagonal,
+                                 csc450Lib_linalg_base::Matrix *b);
+
+        /**
+         * Solves the SLE (with the preset system matrix and right-side term)
+         */
+        const LinearSystemRecord* solve(void) const;
+
+        /**
+         * Solves the SLE (with the preset system matrix)
+         */
+        const LinearSystemRecord* solve(const csc450Lib_linalg_base::ColumnVector *b);
+
+        /**
+         * Solves the SLE
+         */
+        const LinearSystemRecord* solve(const csc450Lib_linalg_base::Matrix *a,
+                                        const csc450Lib_linalg_base::ColumnVector *b);
+    };
+}
+#endif /* defined(____LinearSolver_LDLT_included__) */
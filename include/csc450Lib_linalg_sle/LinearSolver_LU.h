@@ -27,44 +27,73 @@ namespace csc450Lib_linalg_sle {
     private:
         
         /**
-         * Factorize the given matrix into its lower and upper triangular
-         *  components, returned together in one matrix
+         * Whether solve() refines in mixed precision
          */
-        const csc450Lib_linalg_base::Matrix* factorize(const csc450Lib_linalg_base::Matrix *a) const;
+        bool mixedPrecision;
         
         /**
-         * Factorize the given matrix into its lower and upper triangular
-         *  components. Overwrites the original matrix with the components
-         *  together in one matrix. Returns an array of swapped indices
+         * Backward error mixed-precision refinement stops at (0 for the
+         *  default of LUFactorization::solveMixed)
          */
-        const int* partPivot(csc450Lib_linalg_base::Matrix *a) const;
+        double tolerance;
         
         /**
-         * Use backsubstitution to find x, given a column vector y and the
-         *  upper triangular component of A
+         * Most steps of mixed-precision refinement
          */
-        const csc450Lib_linalg_base::ColumnVector* backsubstitute(const csc450Lib_linalg_base::Matrix *u, const csc450Lib_linalg_base::ColumnVector *y) const;
+        int maxRefinements;
         
         /**
-         * Use forward substitution to find y, given a column vector b and the
-         *  lower triangular component of A
+         * Factorize the given matrix into its lower and upper triangular
+         *  components, returned together in one matrix
          */
-        const csc450Lib_linalg_base::ColumnVector* forwardsubstitute(const csc450Lib_linalg_base::Matrix *l, const csc450Lib_linalg_base::ColumnVector *b) const;
+        const csc450Lib_linalg_base::Matrix* factorize(const csc450Lib_linalg_base::Matrix *a) const;
+        
+    public:
         
         /**
-         * Find the error term in a solution, given A and b and the calculated x
+         * Builds a solver that refines its solutions in single precision
          */
-        const csc450Lib_linalg_base::ColumnVector* error(const csc450Lib_linalg_base::Matrix *a, const csc450Lib_linalg_base::ColumnVector *x, const csc450Lib_linalg_base::ColumnVector *b) const;
+        LinearSolver_LU(void);
         
         /**
-         * Improve the given solution using the given error term
+         * Turns mixed-precision refinement on or off. When on, solve()
+         *  factorizes in float but computes residuals in double (see
+         *  LUFactorization::solveMixed), refining until the backward error
+         *  is at most tolerance, and reports the number of steps in the
+         *  record. A system that does not converge within maxRefinements
+         *  steps is reported as ILL_CONDITIONED_MATRIX, with the last
+         *  iterate as its solution
          */
-        const csc450Lib_linalg_base::ColumnVector* improve(const csc450Lib_linalg_base::Matrix *lu, const csc450Lib_linalg_base::ColumnVector *x, const csc450Lib_linalg_base::ColumnVector *err) const;
+        void setMixedPrecision(bool enabled, double tolerance = 0,
+                               int maxRefinements = 30);
         
-    public:
+        /**
+         * Factorizes the square matrix a in place, with partial pivoting,
+         *  into a unit lower triangular L (below the diagonal) and an upper
+         *  triangular U (on and above it). At step i, row i was swapped with
+         *  row pivots[i]. Nothing is allocated.
+         *
+         * The factorization is recursive over halves of the columns, so
+         *  nearly all the work is in GEMM updates, which run in parallel
+         *
+         * @return
+         *          false if a zero pivot was met (a is singular)
+         */
+        static bool factorizeInPlace(csc450Lib_linalg_base::Matrix *a,
+                                     int *pivots);
+        
+        /**
+         * Overwrites b with the solution of A x = b, given the factors and
+         *  pivots produced by factorizeInPlace. Nothing is allocated
+         */
+        static void solveInPlace(const csc450Lib_linalg_base::Matrix *lu,
+                                 const int *pivots,
+                                 csc450Lib_linalg_base::ColumnVector *b);
         
         /**
-         * Solves the SLE (with the preset system matrix and right-side term)
+         * Solves the SLE (with the preset system matrix and right-side term).
+         *  Use LUFactorization directly to solve many right-hand sides with
+         *  one factorization
          */
         const LinearSystemRecord* solve(void) const;
         
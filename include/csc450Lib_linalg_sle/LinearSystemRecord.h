@@ -35,13 +35,19 @@ namespace csc450Lib_linalg_sle {
          */
         const csc450Lib_linalg_base::Matrix *theSol;
         
+        /**
+         * The number of steps of iterative refinement applied to the result
+         */
+        int theRefinements;
+        
     public:
         
         /**
          * Builds a new LinearSystemRecord object
          */
         LinearSystemRecord(const LinearSystemStatus theStatus,
-                           const csc450Lib_linalg_base::Matrix *theSol);
+                           const csc450Lib_linalg_base::Matrix *theSol,
+                           int theRefinements = 0);
         
         /**
          * Gives the solution to an SLE (a null reference 
@@ -53,6 +59,12 @@ namespace csc450Lib_linalg_sle {
          * Gives the status of an attempt to solve an SLE
          */
         const LinearSystemStatus getStatus() const;
+        
+        /**
+         * Gives the number of steps of iterative refinement that were
+         *  applied to the solution
+         */
+        int getRefinements() const;
     };
 }
 #endif /* defined(____LinearSystemRecord_included__) */
\ No newline at end of file
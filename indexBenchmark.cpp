@@ -0,0 +1,142 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include "Matrix.h"
+#include "NearestNeighborIndex.h"
+#include "NearestNeighborIndex_exact.h"
+#include "NearestNeighborIndex_hnsw.h"
+#include "NearestNeighborIndex_ivfpq.h"
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+/**
+ * Recall-versus-latency of the approximate nearest-neighbour indexes
+ *  against the exact scan, on synthetic eigenface weight vectors: clusters
+ *  (one per subject) whose spread decays along the eigenfaces the way the
+ *  eigenvalues do
+ *
+ *  usage: indexbench.out [number of vectors]
+ */
+
+static double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                         - start).count();
+}
+
+/**
+ * Fills the columns of weights with samples around the given centers
+ */
+static void sample(Matrix *weights, const Matrix *centers, std::mt19937 &gen) {
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::uniform_int_distribution<int> pick(0, centers->cols() - 1);
+    for (int j = 0; j < weights->cols(); j++) {
+        int c = pick(gen);
+        for (int i = 0; i < weights->rows(); i++)
+            weights->set(i, j, centers->get(i, c)
+                         + 0.3f * normal(gen) / (1 + 0.2f * i));
+    }
+}
+
+/**
+ * Runs every query, returning the average latency in microseconds and
+ *  the fraction of the true k nearest found
+ */
+static void measure(const char *name, const NearestNeighborIndex *index,
+                    const Matrix *queries, const std::vector<int> &truth,
+                    int k) {
+    int dim = queries->rows();
+    int nq = queries->cols();
+    std::vector<float> q(dim);
+    std::vector<int> ids(k);
+    long hits = 0;
+    double total = 0;
+    
+    for (int j = 0; j < nq; j++) {
+        for (int i = 0; i < dim; i++)
+            q[i] = queries->get(i, j);
+        std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+        int found = index->search(q.data(), k, ids.data(), NULL);
+        total += seconds(start);
+        
+        for (int a = 0; a < found; a++)
+            for (int b = 0; b < k; b++)
+                if (ids[a] == truth[(size_t)j * k + b])
+                    hits++;
+    }
+    cout << "\t" << name << "\t" << total / nq * 1e6 << " us/query\t"
+         << "recall@" << k << ": " << (double)hits / ((double)nq * k) << "\n";
+}
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? std::stoi(argv[1]) : 100000;
+    int dim = 40;
+    int subjects = std::max(1, n / 10);
+    int nq = 500;
+    int k = 10;
+    std::mt19937 gen(7);
+    
+    Matrix *centers = new Matrix(dim, subjects);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    for (int j = 0; j < subjects; j++)
+        for (int i = 0; i < dim; i++)
+            centers->set(i, j, normal(gen) / (1 + 0.2f * i));
+    Matrix *data = new Matrix(dim, n);
+    Matrix *queries = new Matrix(dim, nq);
+    sample(data, centers, gen);
+    sample(queries, centers, gen);
+    
+    cout << n << " vectors of dimension " << dim << ", " << nq
+         << " queries\n\n";
+    
+    // Ground truth from the exact scan
+    NearestNeighborIndex_exact exact(dim);
+    exact.build(data);
+    std::vector<int> truth((size_t)nq * k);
+    std::vector<float> q(dim);
+    for (int j = 0; j < nq; j++) {
+        for (int i = 0; i < dim; i++)
+            q[i] = queries->get(i, j);
+        exact.search(q.data(), k, &truth[(size_t)j * k], NULL);
+    }
+    cout << "exact scan\n";
+    measure("scan", &exact, queries, truth, k);
+    
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    NearestNeighborIndex_hnsw hnsw(dim, 16, 200);
+    hnsw.build(data);
+    cout << "\nHNSW, M = 16 (build " << seconds(start) << " s)\n";
+    int efs[] = { 16, 32, 64, 128, 256 };
+    for (int e = 0; e < 5; e++) {
+        hnsw.setEfSearch(efs[e]);
+        std::string name = "ef " + std::to_string(efs[e]);
+        measure(name.c_str(), &hnsw, queries, truth, k);
+    }
+    
+    start = std::chrono::steady_clock::now();
+    NearestNeighborIndex_ivfpq ivfpq(dim, 1024, 20);
+    ivfpq.build(data);
+    cout << "\nIVF-PQ, 1024 lists, 20 x 8-bit codes (build "
+         << seconds(start) << " s)\n";
+    int probes[] = { 1, 4, 16, 64 };
+    for (int p = 0; p < 4; p++) {
+        ivfpq.setNprobe(probes[p]);
+        std::string name = "nprobe " + std::to_string(probes[p]);
+        measure(name.c_str(), &ivfpq, queries, truth, k);
+    }
+    
+    // Serialization round trip
+    hnsw.setEfSearch(64);
+    hnsw.save("output/hnsw.index");
+    NearestNeighborIndex *loaded = NearestNeighborIndex::load("output/hnsw.index");
+    cout << "\nreloaded HNSW (ef 64)\n";
+    measure("ef 64", loaded, queries, truth, k);
+    delete loaded;
+    
+    delete centers;
+    delete data;
+    delete queries;
+    return 0;
+}
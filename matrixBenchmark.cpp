@@ -0,0 +1,362 @@
+#include <iostream>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include "Matrix.h"
+#include "ColumnVector.h"
+#include "MatrixGenerator.h"
+#include "MatrixMultiplier.h"
+#include "LinearSolver_LU.h"
+#include "LUFactorization.h"
+#include "LinearSolver_Cholesky.h"
+#include "LinearSolver_LDLT.h"
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_sle;
+
+/**
+ * The original i-j-k loop behind Matrix::multiply, kept as the reference
+ *  the blocked kernels are measured against
+ */
+static Matrix* naiveMultiply(const Matrix *matA, const Matrix *matB) {
+    Matrix * prod = new Matrix(matA->rows(), matB->cols());
+    for (int i = 0; i < matA->rows(); i++) {
+        for (int j = 0; j < matB->cols(); j++) {
+            float element = 0;
+            for (int k = 0; k < matA->cols(); k++) {
+                element += matA->get(i, k) * matB->get(k, j);
+            }
+            prod->set(i, j, element);
+        }
+    }
+    return prod;
+}
+
+/**
+ * Returns |A x - b| / |b| in double precision, x the solution of A x = b
+ *  computed from factors by solve (which overwrites its argument with x)
+ */
+template <class Solve>
+static double relativeResidual(const Matrix *a, Solve solve) {
+    int n = a->rows();
+    Matrix *x = MatrixGenerator::getRandom(n, 1);
+    std::vector<double> b(n);
+    for (int i = 0; i < n; i++)
+        b[i] = x->get(i, 0);
+    solve(x);
+    double residual = 0, norm = 0;
+    for (int i = 0; i < n; i++) {
+        double r = -b[i];
+        for (int j = 0; j < n; j++)
+            r += (double)a->get(i, j) * x->get(j, 0);
+        residual += r * r;
+        norm += b[i] * b[i];
+    }
+    delete x;
+    return std::sqrt(residual / norm);
+}
+
+/**
+ * Unblocked right-looking LU with partial pivoting, the reference the
+ *  recursive factorization is measured against
+ */
+static void naiveLU(Matrix *a, int *pivots) {
+    int n = a->rows();
+    for (int j = 0; j < n; j++) {
+        int p = j;
+        for (int i = j + 1; i < n; i++)
+            if (std::abs(a->get(i, j)) > std::abs(a->get(p, j)))
+                p = i;
+        pivots[j] = p;
+        a->swapRows(p, j);
+        float s = a->get(j, j) == 0 ? 0 : 1.0f / a->get(j, j);
+        for (int i = j + 1; i < n; i++) {
+            float lij = a->get(i, j) * s;
+            a->set(i, j, lij);
+            for (int k = j + 1; k < n; k++)
+                a->set(i, k, a->get(i, k) - lij * a->get(j, k));
+        }
+    }
+}
+
+static double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                         - start).count();
+}
+
+static float maxRelDiff(const Matrix *x, const Matrix *y) {
+    float diff = Matrix::subtract(x, y)->normInf();
+    float scale = y->normInf();
+    return scale == 0 ? diff : diff / scale;
+}
+
+static void report(const char *name, double flops, double tNaive,
+                   double tBlocked, float err) {
+    cout << name << "\n";
+    cout << "\tnaive:   " << tNaive << " s\t"
+         << flops / tNaive * 1e-9 << " GFLOP/s\n";
+    cout << "\tblocked: " << tBlocked << " s\t"
+         << flops / tBlocked * 1e-9 << " GFLOP/s\n";
+    cout << "\tspeedup: " << tNaive / tBlocked
+         << "\trelative difference: " << err << "\n";
+}
+
+int main() {
+    MatrixGenerator::seed();
+    cout << "GEMM micro-kernel: " << MatrixMultiplier::kernelName() << "\n\n";
+
+    int sizes[] = { 128, 256, 512, 1024 };
+    for (int s = 0; s < 4; s++) {
+        int n = sizes[s];
+        Matrix *a = MatrixGenerator::getRandom(n, n);
+        Matrix *b = MatrixGenerator::getRandom(n, n);
+
+        std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+        Matrix *c0 = naiveMultiply(a, b);
+        double tNaive = seconds(start);
+
+        start = std::chrono::steady_clock::now();
+        Matrix *c1 = Matrix::multiply(a, b);
+        double tBlocked = seconds(start);
+
+        string name = "A * B, " + to_string(n) + " x " + to_string(n);
+        report(name.c_str(), 2.0 * n * n * n, tNaive, tBlocked,
+               maxRelDiff(c1, c0));
+
+        delete a;
+        delete b;
+        delete c0;
+        delete c1;
+    }
+
+    // The eigenfaces Gram matrix: 243 x 243 pixel images, 40 of them
+    int pixels = 243 * 243;
+    int images = 40;
+    Matrix *a = MatrixGenerator::getRandom(pixels, images);
+
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    const Matrix *at = Matrix::transpose(a);
+    Matrix *l0 = naiveMultiply(at, a);
+    double tNaive = seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    Matrix *l1 = Matrix::multiplyTransposeA(a, a);
+    double tBlocked = seconds(start);
+
+    report("transpose(A) * A, A 59049 x 40", 2.0 * pixels * images * images,
+           tNaive, tBlocked, maxRelDiff(l1, l0));
+
+    delete a;
+    delete at;
+    delete l0;
+    delete l1;
+
+    // A larger gallery, where computing one triangle pays off
+    images = 2000;
+    a = MatrixGenerator::getRandom(20000, images);
+
+    start = std::chrono::steady_clock::now();
+    l0 = Matrix::multiplyTransposeA(a, a);
+    double tGemm = seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    l1 = Matrix::gram(a);
+    double tSyrk = seconds(start);
+
+    cout << "gram(A), A 20000 x 2000\n";
+    cout << "\tgemm: " << tGemm << " s\tsyrk: " << tSyrk << " s\t"
+         << "speedup: " << tGemm / tSyrk
+         << "\trelative difference: " << maxRelDiff(l1, l0) << "\n";
+
+    delete a;
+    delete l0;
+    delete l1;
+
+    // LU with partial pivoting
+    int luSizes[] = { 1000, 4000 };
+    for (int s = 0; s < 2; s++) {
+        int n = luSizes[s];
+        a = MatrixGenerator::getRandom(n, n);
+        int *pivots = new int[n];
+        double flops = 2.0 / 3.0 * n * (double)n * n;
+
+        Matrix *lu1 = Matrix::copyOf(a);
+        start = std::chrono::steady_clock::now();
+        LinearSolver_LU::factorizeInPlace(lu1, pivots);
+        double tRecursive = seconds(start);
+
+        string name = "LU, " + to_string(n) + " x " + to_string(n);
+        if (n <= 1000) {
+            Matrix *lu0 = Matrix::copyOf(a);
+            int *pivots0 = new int[n];
+            start = std::chrono::steady_clock::now();
+            naiveLU(lu0, pivots0);
+            tNaive = seconds(start);
+            report(name.c_str(), flops, tNaive, tRecursive,
+                   maxRelDiff(lu1, lu0));
+            delete lu0;
+            delete[] pivots0;
+        } else {
+            cout << name << "\n";
+            cout << "\tblocked: " << tRecursive << " s\t"
+                 << flops / tRecursive * 1e-9 << " GFLOP/s\n";
+        }
+
+        delete a;
+        delete lu1;
+        delete[] pivots;
+    }
+
+    // Many right-hand sides with one factorization: column by column
+    //  against blocked triangular solves
+    int n = 1000;
+    a = MatrixGenerator::getRandom(n, n);
+    Matrix *rhs = MatrixGenerator::getRandom(n, n);
+    LUFactorization lu(a);
+
+    Matrix *x0 = new Matrix(n, n);
+    ColumnVector *column = new ColumnVector(n);
+    start = std::chrono::steady_clock::now();
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++)
+            column->set(i, rhs->get(i, j));
+        LinearSolver_LU::solveInPlace(lu.getFactors(), lu.getPivots(), column);
+        for (int i = 0; i < n; i++)
+            x0->set(i, j, column->get(i));
+    }
+    tNaive = seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    Matrix *x1 = lu.solve(rhs);
+    tBlocked = seconds(start);
+
+    report("LU solve, 1000 x 1000, 1000 right-hand sides",
+           2.0 * n * (double)n * n, tNaive, tBlocked, maxRelDiff(x1, x0));
+
+    delete a;
+    delete rhs;
+    delete x0;
+    delete x1;
+    delete column;
+
+    // Symmetric systems: a positive-definite Gram matrix, and the same
+    //  shifted to be indefinite
+    n = 3000;
+    Matrix *g = MatrixGenerator::getRandom(n, n);
+    Matrix *spd = Matrix::gram(g);
+    for (int i = 0; i < n; i++)
+        spd->set(i, i, spd->get(i, i) + n);
+    int *pivots = new int[n];
+    float *offDiagonal = new float[n];
+
+    Matrix *f = Matrix::copyOf(spd);
+    start = std::chrono::steady_clock::now();
+    LinearSolver_LU::factorizeInPlace(f, pivots);
+    double tLU = seconds(start);
+
+    Matrix::copyInto(spd, f);
+    start = std::chrono::steady_clock::now();
+    LinearSolver_Cholesky::factorizeInPlace(f);
+    double tCholesky = seconds(start);
+
+    for (int i = 0; i < n; i++)
+        spd->set(i, i, spd->get(i, i) - 2 * n);
+    Matrix::copyInto(spd, f);
+    start = std::chrono::steady_clock::now();
+    LinearSolver_LDLT::factorizeInPlace(f, pivots, offDiagonal);
+    double tLDLT = seconds(start);
+
+    cout << "Symmetric factorizations, 3000 x 3000\n";
+    cout << "\tLU: " << tLU << " s\tCholesky: " << tCholesky
+         << " s\tLDLT: " << tLDLT << " s\n";
+
+    delete g;
+    delete spd;
+    delete f;
+    delete[] pivots;
+    delete[] offDiagonal;
+
+    // Residuals: Cholesky on positive-definite systems, and LDLT on
+    //  symmetric ones with a zero diagonal, where every pivot is a 2 x 2
+    //  block. Both must report the zero matrix singular
+    double worstCholesky = 0, worstLDLT = 0;
+    bool blocks = true;
+    int orders[] = { 1, 2, 3, 7, 64, 129, 300 };
+    for (int t = 0; t < 7; t++) {
+        n = orders[t];
+        pivots = new int[n];
+        offDiagonal = new float[n];
+        g = MatrixGenerator::getRandom(n, n);
+        Matrix *system = Matrix::gram(g);
+        for (int i = 0; i < n; i++)
+            system->set(i, i, system->get(i, i) + 1);
+        f = Matrix::copyOf(system);
+        if (!LinearSolver_Cholesky::factorizeInPlace(f))
+            worstCholesky = INFINITY;
+        worstCholesky = std::max(worstCholesky, relativeResidual(system, [&](Matrix *x) {
+            LinearSolver_Cholesky::solveInPlace(f, x);
+        }));
+        
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                system->set(i, j, i == j ? (n == 1 ? -1.0f : 0.0f)
+                            : g->get(std::min(i, j), std::max(i, j)) - 0.5f);
+        Matrix::copyInto(system, f);
+        if (!LinearSolver_LDLT::factorizeInPlace(f, pivots, offDiagonal))
+            worstLDLT = INFINITY;
+        bool block = n == 1;
+        for (int i = 0; i < n; i++)
+            block = block || offDiagonal[i] != 0;
+        blocks = blocks && block;
+        worstLDLT = std::max(worstLDLT, relativeResidual(system, [&](Matrix *x) {
+            LinearSolver_LDLT::solveInPlace(f, pivots, offDiagonal, x);
+        }));
+        
+        delete g;
+        delete system;
+        delete f;
+        delete[] pivots;
+        delete[] offDiagonal;
+    }
+    Matrix *zero = new Matrix(4, 4);
+    int zeroPivots[4];
+    float zeroOffDiagonal[4];
+    bool singular = !LinearSolver_LDLT::factorizeInPlace(zero, zeroPivots, zeroOffDiagonal);
+    delete zero;
+    zero = new Matrix(4, 4);
+    singular = singular && !LinearSolver_Cholesky::factorizeInPlace(zero);
+    delete zero;
+    bool passed = worstCholesky < 1e-2 && worstLDLT < 1e-2 && blocks && singular;
+    cout << "Symmetric solves, n = 1 to 300: " << (passed ? "ok" : "FAILED")
+         << "\n\tCholesky residual: " << worstCholesky
+         << "\tLDLT residual: " << worstLDLT
+         << "\t2 x 2 pivots: " << (blocks ? "yes" : "no")
+         << "\tzero matrix singular: " << (singular ? "yes" : "no") << "\n";
+
+    // Mixed precision: float factors, double residuals
+    n = 2000;
+    a = MatrixGenerator::getRandom(n, n);
+    std::vector<double> bd(n);
+    std::vector<double> xd(n);
+    for (int i = 0; i < n; i++)
+        bd[i] = (double)a->get(i, 0) + a->get(i, n - 1);
+
+    start = std::chrono::steady_clock::now();
+    LUFactorization mixed(a);
+    double tFactor = seconds(start);
+    start = std::chrono::steady_clock::now();
+    int steps = mixed.solveMixed(bd.data(), xd.data());
+    double tRefine = seconds(start);
+
+    // The exact solution is e_0 + e_(n-1)
+    double err = 0;
+    for (int i = 0; i < n; i++)
+        err = std::max(err, std::abs(xd[i] - (i == 0 || i == n - 1)));
+    cout << "Mixed-precision LU solve, 2000 x 2000\n";
+    cout << "\tfactorize: " << tFactor << " s\trefine: " << tRefine
+         << " s\tsteps: " << steps << "\terror: " << err << "\n";
+
+    delete a;
+    return 0;
+}
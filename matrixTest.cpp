@@ -1,5 +1,6 @@
 #include <iostream>
 #include <fstream>
+#include <chrono>
 #include <unistd.h>
 #include <tgmath.h>
 #include "Matrix.h"
@@ -10,149 +11,149 @@
 #include "MatrixGenerator.h"
 #include "EigenSystem.h"
 #include "EigenSystemSolver.h"
-#include "GetPixels.h"
+#include "SingularValueSolver.h"
+#include "ImageLoader.h"
 #include "Subject.h"
 #include "FacialRecognizer.h"
+#include "FaceCascade.h"
+#include "FaceDetector.h"
+#include "FaceScorer_whitened.h"
+#include "FaceScorer_fisher.h"
+#include "ImagePreprocessor.h"
+#include "TaskScheduler.h"
+#include "EigenfaceModel.h"
+#include "StreamingPCA.h"
+#include "GetPixels.h"
+#include "ModelFile.h"
+#include "MatrixWriter.h"
 using namespace csc450Lib_calc_base;
 using namespace csc450Lib_linalg_base;
 using namespace csc450Lib_linalg_sle;
 using namespace csc450Lib_linalg_eigensystems;
 
-int main() {
+int main(int argc, char **argv) {
     srand(time(NULL));
     string base = "/Users/Christopher/Desktop/CSC 450 Coursework/eigenfaces/";
     
-    string facedir = base + "doc/facetext/";
-    string file = "subject01.txt";
-    string path = facedir + file;
-    
-    vector<string> files = vector<string>();
-    GetPixels::getdir(facedir, files);
-    
-    files.erase(files.begin(),files.begin()+3);
-    
-    for (int i = 0; i < files.size(); i++) {
-        files[i] = facedir + files[i];
+    // --threads n runs the pipeline on n threads (0, the default, uses
+    //  every hardware thread); --base overrides the project directory;
+    //  --size n resamples the faces to n x n, --equalize equalizes their
+    //  histograms and --normalize gives them zero mean and unit variance
+    int threads = 0;
+    ImagePreprocessor preprocessor;
+    preprocessor.setCenterCrop(true);
+    for (int a = 1; a < argc; a++) {
+        string arg = argv[a];
+        if (arg == "--threads" && a + 1 < argc) {
+            threads = atoi(argv[++a]);
+        } else if (arg == "--base" && a + 1 < argc) {
+            base = string(argv[++a]) + "/";
+        } else if (arg == "--size" && a + 1 < argc) {
+            int size = atoi(argv[++a]);
+            preprocessor.setSize(size, size);
+        } else if (arg == "--equalize") {
+            preprocessor.setEqualize(true);
+        } else if (arg == "--normalize") {
+            preprocessor.setNormalize(true);
+        } else {
+            cout << "usage: " << argv[0] << " [--threads n] [--base dir]"
+                 << " [--size n] [--equalize] [--normalize]\n";
+            return 1;
+        }
     }
+    TaskScheduler::setThreads(threads);
+    cout << "Running on " << TaskScheduler::threads() << " threads\n";
+    
+    // Wall-clock time of each stage, to check how the pipeline scales
+    chrono::steady_clock::time_point lap = chrono::steady_clock::now();
+    auto stageTime = [&lap](const string &stage) {
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        cout << "\t[" << stage << ": "
+             << chrono::duration<double, milli>(now - lap).count() << " ms]\n";
+        lap = now;
+    };
+    
+    // The original GIFs, in name order
+    string facedir = base + "doc/yalefaces/";
+    vector<string> files = ImageLoader::list(facedir);
     
 	//images per person collected
 	int ipp = 11;
-	int subjectid = 0;
-	int count = 0;
-	int imagewidth = 320;
-	int imageheight = 243;
+    int numSubjects = files.size() / ipp;
 	//Create our Subjects
-    const Subject *subjects[files.size() / ipp];
+    const Subject *subjects[numSubjects];
 	
-	Matrix* temp;
-	//for every picture
+	//decode and preprocess every picture straight into its column, on the
+	//	loader threads; each subject is a view of its ipp columns
     cout << "Creating subjects";
-    int i = 0;
-	while (i <= files.size() && subjectid < files.size() / ipp) {
-
-		//if it is the first time running for this subject
-		if (count == 0) {
-			//then initialize the first column of their vector
-			float ** imagePix = GetPixels::getPixelSquare(files[i]);
-			Matrix* imageMat = new Matrix(imageheight, imageheight, imagePix);
-			ColumnVector *imageVect = Matrix::column(imageMat);
-			temp = Matrix::copyOf(imageVect);
-            count++;
-            i++;
-		}
-		else if (count >= ipp) { //else if we are done gathering data for the subject
-			//officially create the subject, reset counters
-			subjects[subjectid] = new Subject(Matrix::copyOf(temp), subjectid+1);
-            //if(subjectid >=subjects.size())
-			count = 0;
-			subjectid++;
-
-		}
-		else {
-			float ** imagePix = GetPixels::getPixelSquare(files[i]);
-			Matrix* imageMat = new Matrix(imageheight, imageheight, imagePix);
-			ColumnVector *imageVect = Matrix::column(imageMat);
-			temp->addColumn((ColumnVector*)Matrix::copyOf(imageVect));
-			count++;
-            i++;
-		}
-        if (i % (files.size()/5) == 0) {
-            cout << ".";
-            cout.flush();
-        }
-	}
-    delete temp;
-    temp = 0;
+    cout.flush();
+    files.resize(numSubjects * ipp);
+    ImageLoader loader(threads);
+    loader.setPreprocessor(preprocessor);
+    Matrix *faces = loader.load(files);
+    int numPixels = faces->rows();
+    for (int s = 0; s < numSubjects; s++)
+        subjects[s] = new Subject(Matrix::view(faces, 0, s * ipp, numPixels, ipp),
+                                  s + 1);
     cout << " Done.\n";
+    stageTime("decode and subjects");
     
 	//Put our pictures in random order
-    for (int i = 0; i < files.size(); i++) {
-        int rand = std::rand() % files.size();
-        string temp = files[i];
-        files[i] = files[rand];
-        files[rand] = temp;
+    vector<int> order(faces->cols());
+    for (int i = 0; i < order.size(); i++)
+        order[i] = i;
+    for (int i = 0; i < order.size(); i++) {
+        int rand = std::rand() % order.size();
+        int temp = order[i];
+        order[i] = order[rand];
+        order[rand] = temp;
     }
     
-    float** pixels = GetPixels::getPixelSquare(path);
-
-    Matrix* image = new Matrix(imageheight, imageheight, pixels);
-    ColumnVector *imagecol = Matrix::column(image);
-    
     /********************************************
      *              DECLARATIONS                *
      ********************************************/
     
     int numImages = files.size();
     numImages = 40;
-    int imageWidth = 243;
+    int imageWidth = (int)lround(sqrt((double)numPixels));
     
     // Seed the random matrix generator
     MatrixGenerator::seed();
     
-    Matrix *mat;
-    
     cout << "Loading images";
     
-    // Image vectors
-    ColumnVector *gamma[numImages];
-    for (int i = 0; i < numImages; i++) {
-        mat = new Matrix(imageWidth, imageWidth,
-                         GetPixels::getPixelSquare(files[i]));
-        gamma[i] = Matrix::column(mat);
-        if (i % (numImages/3)==0) {
-            cout << ".";
-            cout.flush();
+    // Matrix of image vectors, gathered from the decoded pictures
+    Matrix *gammas = new Matrix(numPixels, numImages);
+    TaskScheduler::parallelFor(0, numPixels, 0, [&](int p0, int p1) {
+        for (int p = p0; p < p1; p++) {
+            const float *face = faces->getData() + (size_t)p * faces->stride();
+            float *row = gammas->getData() + (size_t)p * gammas->stride();
+            for (int i = 0; i < numImages; i++)
+                row[i] = face[order[i]];
         }
-    }
+    });
     
     cout << " Done.\n";
     
-    // Matrix of image vectors
-    Matrix *gammas = gamma[0];
-    for (int i = 1; i < numImages; i++) {
-        gammas->addColumn(gamma[i]);
-    }
-    
     // The average face
     const ColumnVector *psi = gammas->averageColumn();
+    stageTime("images and mean");
     
     cout << "Creating A";
     // Matrix of differences between image vectors and the average face
-    Matrix *A = Matrix::subtract(gamma[0], psi);
-    ColumnVector *phi[numImages];
-    for (int i = 1; i < numImages; i++) {
-        phi[i] = (ColumnVector*)Matrix::subtract(gamma[i], psi);
-        A->addColumn(phi[i]);
-        if (i % (numImages/3)==0) {
-            cout << ".";
-            cout.flush();
+    Matrix *A = new Matrix(numPixels, numImages);
+    TaskScheduler::parallelFor(0, numPixels, 0, [&](int p0, int p1) {
+        for (int p = p0; p < p1; p++) {
+            const float *g = gammas->getData() + (size_t)p * gammas->stride();
+            float *row = A->getData() + (size_t)p * A->stride();
+            float mean = psi->get(p);
+            for (int i = 0; i < numImages; i++)
+                row[i] = g[i] - mean;
         }
-    }
+    });
     cout << " Done.\n\n";
     
-    Matrix *L = Matrix::multiply(Matrix::transpose(A), A);
-    Matrix *deflated = Matrix::copyOf(L);
-    ColumnVector *eigenvectors[numImages];
+    Matrix *L = Matrix::gram(A);
     ColumnVector *diffs[numImages];
     float eigenvalues[numImages];
     
@@ -161,28 +162,19 @@ int main() {
      ********************************************/
     
     
-    EigenSystemSolver *solver = new EigenSystemSolver(L);
+    EigenSystemSolver *solver = new EigenSystemSolver(L, SYMMETRIC_QR);
     const EigenSystem *system = solver->solve();
     
     cout << "Eigensystem solved\n";
+    stageTime("A, L and eigensystem");
     
-    ColumnVector *faces[numImages];
-    for (int l = 0; l < numImages; l++) {
-        faces[l] = new ColumnVector(imageWidth*imageWidth);
-        for (int j = 0; j < imageWidth*imageWidth; j++) {
-            faces[l]->set(j, 0);
-        }
-        for (int k = 0; k < numImages; k++) {
-            faces[l] = (ColumnVector*)Matrix::add(faces[l],Matrix::multiply(system->getEigenVector(l)->get(k), A->getColumn(k)));
-        }
-    }
-    
-    Matrix *eigenfaces = faces[0];
-    for (int i = 1; i < numImages; i++) {
-        eigenfaces->addColumn(faces[i]);
-    }
+    // The eigenfaces are the left singular vectors of A
+    SingularValueSolver *svdSolver = new SingularValueSolver(A);
+    const SingularValueDecomposition *svd = svdSolver->solve();
+    Matrix *eigenfaces = svd->getU();
     
     cout << "Eigenfaces calculated\n";
+    stageTime("eigenfaces");
     
     FacialRecognizer *recognizer = new FacialRecognizer(15,
                                                         subjects,
@@ -192,15 +184,298 @@ int main() {
     const Subject *recognizedSubject = recognizer->faceClass();
     cout << "\n\n\nRECOGNIZED SUBJECT AS SUBJECT " << recognizedSubject->getID() << "\n\n\n";
     
-    Matrix *diffmatrix = (ColumnVector*)Matrix::subtract(Matrix::multiply(L, system->getEigenVector(0)),Matrix::multiply(system->getEigenValue(0), system->getEigenVector(0)));
-    for (int i = 1; i < numImages; i++) {
-        diffs[i] = (ColumnVector*)Matrix::subtract(Matrix::multiply(L, system->getEigenVector(i)),Matrix::multiply(system->getEigenValue(i), system->getEigenVector(i)));
-    }
+    TaskScheduler::parallelFor(0, numImages, 1, [&](int b, int e) {
+        for (int i = b; i < e; i++) {
+            diffs[i] = (ColumnVector*)Matrix::subtract(Matrix::multiply(L, system->getEigenVector(i)),Matrix::multiply(system->getEigenValue(i), system->getEigenVector(i)));
+        }
+    });
+    Matrix *diffmatrix = diffs[0];
     for (int i = 1; i < numImages; i++) {
         diffmatrix->addColumn(diffs[i]);
     }
     
     cout << "Calculations complete\n";
+    stageTime("recognition and residuals");
+    
+    // Coarse-to-fine cascade: 32 x 32 and 64 x 64 eigenbases reject
+    //  background and prune the subjects before the full-resolution
+    //  projection. Every level, and the full-resolution baseline, has 20
+    //  eigenfaces of the gallery and a threshold a margin above the
+    //  furthest gallery face. Both are run on the gallery plus as many
+    //  background probes as a camera stream would see, and must name the
+    //  same subject for every face
+    if (imageWidth > 64) {
+        EigenfaceModel *fullModel = EigenfaceModel::train(faces, 20);
+        FaceCascade *full = new FaceCascade(15, subjects, fullModel->getEigenfaces(),
+                                            fullModel->getMean(), imageWidth, imageWidth);
+        FaceCascade *cascade = new FaceCascade(15, subjects, fullModel->getEigenfaces(),
+                                               fullModel->getMean(), imageWidth, imageWidth);
+        cascade->addLevel(32, 32, 20, FLT_MAX, 5);
+        cascade->addLevel(64, 64, 20, FLT_MAX, 2);
+        for (int l = 0; l < cascade->size(); l++) {
+            float furthest = 0;
+            for (int i = 0; i < faces->cols(); i++) {
+                ColumnVector *face = faces->columnView(i);
+                furthest = std::max(furthest, cascade->distFromFaceSpace(l, face));
+                delete face;
+            }
+            cascade->setThreshold(l, 1.25f * furthest);
+            if (l == cascade->size() - 1)
+                full->setThreshold(0, 1.25f * furthest);
+        }
+        // Background: smooth scenes, random 6 x 6 grids of gray levels
+        //  interpolated up to full size
+        int numBackground = 4 * faces->cols();
+        Matrix *background = new Matrix(numPixels, numBackground);
+        for (int b = 0; b < numBackground; b++) {
+            Matrix *grid = MatrixGenerator::getRandom(6, 6);
+            for (int y = 0; y < imageWidth; y++) {
+                float gy = 5.0f * y / (imageWidth - 1);
+                int y0 = std::min((int)gy, 4);
+                for (int x = 0; x < imageWidth; x++) {
+                    float gx = 5.0f * x / (imageWidth - 1);
+                    int x0 = std::min((int)gx, 4);
+                    float fy = gy - y0, fx = gx - x0;
+                    float top = (1 - fx) * grid->get(y0, x0) + fx * grid->get(y0, x0 + 1);
+                    float bottom = (1 - fx) * grid->get(y0 + 1, x0) + fx * grid->get(y0 + 1, x0 + 1);
+                    background->set(y * imageWidth + x, b, (1 - fy) * top + fy * bottom);
+                }
+            }
+            delete grid;
+        }
+        
+        int correct = 0, fullCorrect = 0, rejected = 0, fullRejected = 0;
+        int faceAgree = 0, backgroundAgree = 0;
+        double tCascade = 0, tFull = 0;
+        for (int i = 0; i < faces->cols() + numBackground; i++) {
+            // A contiguous probe, as a camera frame would be
+            ColumnVector *column = i < faces->cols() ? faces->columnView(i)
+                : background->columnView(i - faces->cols());
+            ColumnVector *probe = new ColumnVector(numPixels);
+            Matrix::copyInto(column, probe);
+            delete column;
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            const Subject *coarse = cascade->recognize(probe);
+            tCascade += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            start = chrono::steady_clock::now();
+            const Subject *exact = full->recognize(probe);
+            tFull += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            if (i < faces->cols()) {
+                correct += coarse != NULL && coarse->getID() == i / ipp + 1;
+                fullCorrect += exact != NULL && exact->getID() == i / ipp + 1;
+                faceAgree += coarse == exact;
+            } else {
+                rejected += coarse == NULL;
+                fullRejected += exact == NULL;
+                backgroundAgree += coarse == exact;
+            }
+            delete probe;
+        }
+        delete background;
+        delete cascade;
+        delete full;
+        delete fullModel;
+        cout << "Cascade: " << correct << " of " << faces->cols()
+             << " faces recognized, " << rejected << " of " << numBackground
+             << " background probes rejected, in " << tCascade << " ms\n";
+        cout << "Full resolution: " << fullCorrect << " of " << faces->cols()
+             << " faces recognized, " << fullRejected << " of " << numBackground
+             << " background probes rejected, in " << tFull << " ms\n";
+        bool agreed = faceAgree == faces->cols();
+        cout << "Cascade and full resolution agree on " << faceAgree << " of "
+             << faces->cols() << " faces and " << backgroundAgree << " of "
+             << numBackground << " background probes: "
+             << (agreed ? "ok" : "FAILED") << "\n";
+        if (!agreed)
+            return 1;
+        stageTime("cascade");
+    }
+    
+    // Sliding-window detection: a 48 x 48 eigenbasis, and a 240 x 320
+    //  frame holding one face at that size and one at twice it
+    if (imageWidth >= 96) {
+        int side = 48;
+        Matrix *small = new Matrix(side * side, faces->cols());
+        for (int i = 0; i < faces->cols(); i++)
+            ImagePreprocessor::resample(faces->getData() + i, imageWidth, imageWidth,
+                                        faces->stride(), small->getData() + i,
+                                        side, side, small->stride());
+        EigenfaceModel *detectorModel = EigenfaceModel::train(small, 20);
+        FaceDetector detector(detectorModel->getEigenfaces(),
+                              detectorModel->getMean(), side, side);
+        
+        Matrix *frame = new Matrix(240, 320);
+        for (int y = 0; y < frame->rows(); y++)
+            for (int x = 0; x < frame->cols(); x++)
+                frame->set(y, x, 0.4f + 0.2f * sin(x / 37.0f) * cos(y / 23.0f));
+        vector<float> big(4 * side * side);
+        ImagePreprocessor::resample(faces->getData() + 50, imageWidth, imageWidth,
+                                    faces->stride(), big.data(), 2 * side, 2 * side, 1);
+        for (int y = 0; y < side; y++)
+            for (int x = 0; x < side; x++)
+                frame->set(30 + y, 40 + x, small->get(y * side + x, 3));
+        for (int y = 0; y < 2 * side; y++)
+            for (int x = 0; x < 2 * side; x++)
+                frame->set(100 + y, 150 + x, big[y * 2 * side + x]);
+        
+        vector<float> scales = { 1.0f, 0.75f, 0.5f };
+        vector<FaceDetector::Detection> found = detector.detect(frame, 5.5f, scales);
+        cout << "Faces placed at 40,30 (48 x 48) and 150,100 (96 x 96), found at";
+        for (size_t d = 0; d < found.size(); d++)
+            cout << " " << found[d].x << "," << found[d].y << " (" << found[d].width
+                 << " x " << found[d].height << ")";
+        cout << "\n";
+        delete frame;
+        delete detectorModel;
+        delete small;
+        stageTime("detection");
+    }
+
+    // Scorers: half of each subject's pictures (alternate ones) train the
+    //  eigenfaces, the other half are recognized, ranking the subjects by
+    //  eigenface weights, by whitened weights (Mahalanobis distance and
+    //  cosine) and by Fisherfaces
+    {
+        int numTrain = (ipp + 1) / 2;
+        int numTest = ipp - numTrain;
+        Matrix *training = new Matrix(numPixels, numSubjects * numTrain);
+        for (int p = 0; p < numPixels; p++) {
+            const float *face = faces->getData() + (size_t)p * faces->stride();
+            float *row = training->getData() + (size_t)p * training->stride();
+            for (int s = 0; s < numSubjects; s++)
+                for (int j = 0; j < numTrain; j++)
+                    row[s * numTrain + j] = face[s * ipp + 2 * j];
+        }
+        const Subject *trainSubjects[numSubjects];
+        for (int s = 0; s < numSubjects; s++)
+            trainSubjects[s] = new Subject(Matrix::view(training, 0, s * numTrain,
+                                                        numPixels, numTrain), s + 1);
+        
+        const char *names[] = { "eigenfaces", "Mahalanobis", "whitened cosine",
+                                "Fisherfaces" };
+        int dimensions[] = { 5, 10, 20, 40, 75 };
+        for (int d = 0; d < 5 && dimensions[d] < training->cols(); d++) {
+            EigenfaceModel *model = EigenfaceModel::train(training, dimensions[d]);
+            FacialRecognizer scored(numSubjects, trainSubjects,
+                                    model->getEigenfaces(), model->getMean());
+            cout << "k = " << dimensions[d] << ":";
+            for (int m = 0; m < 4; m++) {
+                if (m == 1)
+                    scored.setScorer(new FaceScorer_whitened(model->getEigenValues()));
+                else if (m == 2)
+                    scored.setScorer(new FaceScorer_whitened(model->getEigenValues(),
+                                                             SCORE_COSINE));
+                else if (m == 3)
+                    scored.setScorer(FaceScorer_fisher::train(numSubjects, trainSubjects,
+                                                              model->getEigenfaces(),
+                                                              model->getMean()));
+                int correct = 0;
+                for (int s = 0; s < numSubjects; s++) {
+                    for (int j = 0; j < numTest; j++) {
+                        ColumnVector *probe = faces->columnView(s * ipp + 2 * j + 1);
+                        correct += scored.faceClass(probe)->getID() == s + 1;
+                        delete probe;
+                    }
+                }
+                cout << " " << names[m] << " " << correct << "/"
+                     << numSubjects * numTest;
+            }
+            cout << "\n";
+            delete model;
+        }
+        for (int s = 0; s < numSubjects; s++)
+            delete trainSubjects[s];
+        delete training;
+        stageTime("scorers");
+    }
+
+    // Streaming training on the text gallery, against the in-memory model:
+    //  a budget of a third of the gallery for the Gram tiles, and the
+    //  randomized sketch
+    {
+        vector<string> names, textFiles;
+        GetPixels::getdir(base + "doc/facetext/", names);
+        for (size_t f = 0; f < names.size(); f++)
+            if (names[f].size() > 4
+                && names[f].compare(names[f].size() - 4, 4, ".txt") == 0)
+                textFiles.push_back(base + "doc/facetext/" + names[f]);
+        int side = 243, k = 20;
+        Matrix *gallery = new Matrix(side * side, (int)textFiles.size());
+        vector<float> image(side * side);
+        for (size_t f = 0; f < textFiles.size(); f++) {
+            if (!GetPixels::readPixelSquare(textFiles[f], image.data()))
+                throw "Cannot read image";
+            for (int p = 0; p < side * side; p++)
+                gallery->set(p, (int)f, image[p]);
+        }
+        EigenfaceModel *reference = EigenfaceModel::train(gallery, k);
+        delete gallery;
+        
+        StreamingPCAMode modes[] = { GRAM_TILES, RANDOMIZED_SKETCH };
+        const char *modeNames[] = { "Gram tiles", "Randomized sketch" };
+        for (int mode = 0; mode < 2; mode++) {
+            StreamingPCA streaming(textFiles, 24 << 20, modes[mode]);
+            streaming.train(k);
+            float meanError = 0, valueError = 0, overlap = 1;
+            for (int p = 0; p < side * side; p++)
+                meanError = std::max(meanError, std::abs(streaming.getMean()->get(p)
+                                                         - reference->getMean()->get(p)));
+            for (int i = 0; i < k; i++) {
+                float expected = reference->getEigenValues()->get(i);
+                valueError = std::max(valueError,
+                                      std::abs(streaming.getEigenValues()->get(i) - expected)
+                                      / expected);
+                float dot = 0;
+                for (int p = 0; p < side * side; p++)
+                    dot += streaming.getEigenfaces()->get(p, i)
+                        * reference->getEigenfaces()->get(p, i);
+                overlap = std::min(overlap, std::abs(dot));
+            }
+            cout << modeNames[mode] << ": " << streaming.getImagesRead() << " image reads ("
+                 << (double)streaming.getImagesRead() / textFiles.size()
+                 << " passes), mean within " << meanError
+                 << ", eigenvalues within " << valueError
+                 << " relative, smallest eigenface overlap " << overlap << "\n";
+        }
+        delete reference;
+        stageTime("streaming training");
+    }
+
+    // Incremental training: a model of the first half of the gallery,
+    //  updated with the second half, against one trained on all of it.
+    //  No eigenface is truncated, so the two should agree
+    {
+        int total = faces->cols(), half = total / 2, compared = 20;
+        Matrix *first = Matrix::view(faces, 0, 0, numPixels, half);
+        Matrix *second = Matrix::view(faces, 0, half, numPixels, total - half);
+        EigenfaceModel *partial = EigenfaceModel::train(first, half);
+        EigenfaceModel *updated = partial->update(second, total);
+        EigenfaceModel *full = EigenfaceModel::train(faces, total);
+        float meanError = 0, valueError = 0, overlap = 1;
+        for (int p = 0; p < numPixels; p++)
+            meanError = std::max(meanError, std::abs(updated->getMean()->get(p)
+                                                     - full->getMean()->get(p)));
+        for (int i = 0; i < compared; i++) {
+            float expected = full->getEigenValues()->get(i);
+            valueError = std::max(valueError,
+                                  std::abs(updated->getEigenValues()->get(i) - expected)
+                                  / expected);
+            float dot = 0;
+            for (int p = 0; p < numPixels; p++)
+                dot += updated->getEigenfaces()->get(p, i) * full->getEigenfaces()->get(p, i);
+            overlap = std::min(overlap, std::abs(dot));
+        }
+        cout << "Update of " << half << " images with " << total - half
+             << ": mean within " << meanError << ", leading " << compared
+             << " eigenvalues within " << valueError
+             << " relative, smallest eigenface overlap " << overlap << "\n";
+        delete partial;
+        delete updated;
+        delete full;
+        delete first;
+        delete second;
+        stageTime("incremental training");
+    }
     
     /********************************************
      *          COMMAND LINE OUTPUT             *
@@ -241,27 +516,95 @@ int main() {
      *              WRITE TO FILE               *
      ********************************************/
     
-    ofstream myfile;
+    // Each file is formatted and written by its own task
     int mprime = 10;
-    Matrix *current;
+    vector<string> names;
+    vector<const Matrix*> sources;
+    vector<int> columns;
     for (int i = 0; i < mprime; i++) {
-        cout << "Saving output/eigenface" + to_string(i) + ".txt\n";
-        myfile.open ("output/eigenface" + to_string(i) + ".txt");
-        
-        current = Matrix::matrix(eigenfaces->getColumn(i), imageWidth);
-        myfile << current->toString("{","}",",",false);
-        
-        // Close file
-        myfile.close();
+        names.push_back("output/eigenface" + to_string(i) + ".txt");
+        sources.push_back(eigenfaces);
+        columns.push_back(i);
     }
     for (int i = 0; i < numImages; i++) {
-        cout << "Saving output/face" + to_string(i) + ".txt\n";
-        myfile.open ("output/face" + to_string(i) + ".txt");
-        
-        current = Matrix::matrix(gammas->getColumn(i), imageWidth);
-        myfile << current->toString("{","}",",",false);
+        names.push_back("output/face" + to_string(i) + ".txt");
+        sources.push_back(gammas);
+        columns.push_back(i);
+    }
+    for (int f = 0; f < names.size(); f++) {
+        cout << "Saving " + names[f] + "\n";
+    }
+    MatrixWriter writer(FORMAT_MATHEMATICA);
+    TaskScheduler::parallelFor(0, names.size(), 1, [&](int b, int e) {
+        for (int f = b; f < e; f++) {
+            ofstream myfile(names[f]);
+            
+            ColumnVector *column = sources[f]->getColumn(columns[f]);
+            Matrix *current = Matrix::matrix(column, imageWidth);
+            writer.write(myfile, current);
+            delete current;
+            delete column;
+            
+            // Close file
+            myfile.close();
+        }
+    });
+    
+    // Keep the trained model so that recognition can start without
+    //  retraining
+    ColumnVector *sigma = svd->getSingularValues();
+    ColumnVector *lambda = new ColumnVector(sigma->rows());
+    for (int i = 0; i < sigma->rows(); i++) {
+        lambda->set(i, sigma->get(i) * sigma->get(i));
+    }
+    EigenfaceModel *model = new EigenfaceModel(psi, eigenfaces, lambda, numImages);
+    FaceGallery *gallery = new FaceGallery(15, subjects, eigenfaces, psi);
+    cout << "Saving output/model.bin\n";
+    ModelFile::save("output/model.bin", model, gallery, imageWidth, imageWidth);
+    stageTime("output");
+    
+    // Save and load round trip in every basis format: everything but a
+    //  quantized basis comes back exactly, and a quantized eigenface stays
+    //  within half a step of its scale (2^-11 for halves, 1/254 for bytes)
+    BasisFormat formats[] = { BASIS_FLOAT32, BASIS_FLOAT16, BASIS_INT8 };
+    const char *formatNames[] = { "fp32", "fp16", "int8" };
+    float steps[] = { 0.0f, 1.0f / 2048, 1.0f / 254 };
+    for (int f = 0; f < 3; f++) {
+        ModelFile::save("output/roundtrip.bin", model, gallery, imageWidth,
+                        imageWidth, formats[f]);
+        ModelFile *loaded = new ModelFile("output/roundtrip.bin");
+        bool exact = loaded->getFormat() == formats[f]
+            && loaded->getWidth() == imageWidth && loaded->getHeight() == imageWidth
+            && loaded->getImageCount() == numImages
+            && loaded->dimension() == eigenfaces->cols() && loaded->size() == 15;
+        for (int p = 0; exact && p < numPixels; p++)
+            exact = loaded->getMean()->get(p) == psi->get(p);
+        for (int i = 0; exact && i < loaded->dimension(); i++)
+            exact = loaded->getEigenValues()->get(i) == lambda->get(i);
+        for (int c = 0; exact && c < loaded->size(); c++) {
+            exact = loaded->getSubjectID(c) == subjects[c]->getID();
+            for (int i = 0; exact && i < loaded->dimension(); i++)
+                exact = loaded->getClassWeights()->get(i, c)
+                    == gallery->getClassWeights()->get(i, c);
+        }
         
-        // Close file
-        myfile.close();
+        // Largest error of each eigenface, relative to its largest entry
+        float worst = 0;
+        for (int i = 0; i < eigenfaces->cols(); i++) {
+            float scale = 0, error = 0;
+            for (int p = 0; p < numPixels; p++) {
+                scale = std::max(scale, std::abs(eigenfaces->get(p, i)));
+                error = std::max(error, std::abs(loaded->getEigenfaces()->get(p, i)
+                                                 - eigenfaces->get(p, i)));
+            }
+            if (scale > 0)
+                worst = std::max(worst, error / scale);
+        }
+        bool passed = exact && worst <= steps[f] * 1.0001f;
+        cout << "Model round trip, " << formatNames[f] << ": "
+             << (passed ? "ok" : "FAILED") << ", basis within " << worst
+             << " of each eigenface's scale\n";
+        delete loaded;
     }
+    unlink("output/roundtrip.bin");
 }
\ No newline at end of file
@@ -12,37 +12,32 @@
 using namespace csc450Lib_linalg_base;
 
 ColumnVector::ColumnVector(int nbRows, const float * v) : Matrix(nbRows, 1) {
-    for (int i = 0; i < nbRows; i++)
-        this->a[i][0] = v[i];
+    memcpy(this->data, v, nbRows * sizeof(float));
 }
 
 ColumnVector::ColumnVector(int nbRows) : Matrix(nbRows, 1) {
 }
 
-float ColumnVector::get(int theRow) const {
-    return a[theRow][0];
+ColumnVector::ColumnVector(int nbRows, float * data, int ld)
+    : Matrix(nbRows, 1, data, ld) {
 }
 
 float ColumnVector::max() const {
-    float max = a[0][0];
+    float max = get(0);
     for (int i = 1; i< nbRows; i++)
-        if (a[i][0] > max)
-            max = a[i][0];
+        if (get(i) > max)
+            max = get(i);
     return max;
 }
 
 int ColumnVector::maxInd() const {
     int max = 0;
     for (int i = 1; i< nbRows; i++)
-        if (a[i][0] > a[max][0])
+        if (get(i) > get(max))
             max = i;
     return max;
 }
 
-void ColumnVector::set(int theRow, float theVal) const {
-    a[theRow][0] = theVal;
-}
-
 const RowVector* ColumnVector::transpose(const ColumnVector *matA) {
     RowVector* t = new RowVector(matA->rows());
     
@@ -57,7 +52,7 @@ float ColumnVector::norm1() const {
     float norm = 0;
     
     for (int i = 0; i < nbRows; i++) {
-        norm += std::abs(a[i][0]);
+        norm += std::abs(get(i));
     }
     
     return norm;
@@ -65,10 +60,10 @@ float ColumnVector::norm1() const {
 
 float ColumnVector::norm2() const {
     float norm = 0;
-    float current;
+    float current = 0;
     
     for (int i = 0; i < nbRows; i++) {
-        current += a[i][0] * a[i][0];
+        current += get(i) * get(i);
     }
     norm = std::sqrt(current);
     
@@ -80,7 +75,7 @@ float ColumnVector::normInf() const {
     float current;
     
     for (int i = 0; i < nbRows; i++) {
-        current = std::abs(a[i][0]);
+        current = std::abs(get(i));
         if (current > norm)
             norm = current;
     }
@@ -0,0 +1,94 @@
+//
+//  FourierTransform.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <cmath>
+#include <vector>
+
+#include "FourierTransform.h"
+#include "TaskScheduler.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+
+int FourierTransform::size(int n) {
+    int size = 1;
+    while (size < n)
+        size <<= 1;
+    return size;
+}
+
+void FourierTransform::transform(complex<double> *data, int n, bool inverse) {
+    if (n < 1 || (n & (n - 1)) != 0)
+        throw "Transform size must be a power of two";
+
+    // Bit-reversed order, then butterflies of doubling span
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(data[i], data[j]);
+    }
+    // Twiddles exp(-2 pi i k / size) of the largest transform so far; a
+    //  transform of n uses every (size / n)th. Each is computed directly,
+    //  not by repeated products, so that rounding does not build up
+    static thread_local vector<complex<double> > twiddles;
+    static thread_local int tableSize = 0;
+    if (n > tableSize) {
+        tableSize = n;
+        twiddles.resize(n / 2);
+        for (int k = 0; k < n / 2; k++)
+            twiddles[k] = polar(1.0, -2 * M_PI * k / n);
+    }
+    for (int span = 1; span < n; span <<= 1) {
+        int step = tableSize / (2 * span);
+        for (int k = 0; k < span; k++) {
+            double wr = twiddles[(size_t)k * step].real();
+            double wi = inverse ? -twiddles[(size_t)k * step].imag()
+                : twiddles[(size_t)k * step].imag();
+            for (int i = k; i < n; i += 2 * span) {
+                // Written out: operator* checks for infinities and NaNs
+                double xr = data[i + span].real();
+                double xi = data[i + span].imag();
+                complex<double> t(wr * xr - wi * xi, wr * xi + wi * xr);
+                data[i + span] = data[i] - t;
+                data[i] += t;
+            }
+        }
+    }
+    if (inverse) {
+        double scale = 1.0 / n;
+        for (int i = 0; i < n; i++)
+            data[i] *= scale;
+    }
+}
+
+void FourierTransform::transform2D(complex<double> *data, int rows, int cols,
+                                   bool inverse) {
+    TaskScheduler::parallelFor(0, rows, 8, [&](int r0, int r1) {
+        for (int r = r0; r < r1; r++)
+            transform(data + (size_t)r * cols, cols, inverse);
+    });
+
+    // Columns are gathered into a contiguous buffer, transformed, and
+    //  scattered back
+    TaskScheduler::parallelFor(0, cols, 8, [&](int c0, int c1) {
+        static thread_local vector<complex<double> > column;
+        column.resize(rows);
+        for (int c = c0; c < c1; c++) {
+            for (int r = 0; r < rows; r++)
+                column[r] = data[(size_t)r * cols + c];
+            transform(column.data(), rows, inverse);
+            for (int r = 0; r < rows; r++)
+                data[(size_t)r * cols + c] = column[r];
+        }
+    });
+}
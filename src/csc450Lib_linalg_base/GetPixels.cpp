@@ -6,6 +6,10 @@
 //
 //
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
 #include "GetPixels.h"
 using namespace csc450Lib_linalg_base;
 
@@ -72,9 +76,52 @@ float** GetPixels::getPixelSquare(string filename, int width, int height){
         }
     }
     
+    for (int i = 0; i < height; i++)
+        delete [] pixels[i];
+    delete [] pixels;
+    
     return square;
 }
 
+bool GetPixels::readPixelSquare(string filename, float *dest,
+                                int width, int height) {
+    // The whole file is read at once and parsed with strtof, several times
+    //  faster than extracting the values from the stream one by one. The
+    //  buffer is kept between calls
+    static thread_local vector<char> text;
+    FILE *input = fopen(filename.c_str(), "rb");
+    if (input == NULL)
+        return false;
+    text.clear();
+    char chunk[1 << 16];
+    size_t count;
+    while ((count = fread(chunk, 1, sizeof(chunk), input)) > 0)
+        text.insert(text.end(), chunk, chunk + count);
+    bool failed = ferror(input) != 0;
+    fclose(input);
+    if (failed)
+        return false;
+    text.push_back('\0');
+    
+    //keep the columns centered in the width, skip the margins
+    int minW = (width - height) / 2;
+    int maxW = (width - minW);
+    const char *cursor = text.data();
+    for (int i = 0; i < height; i++){
+        for (int j = 0; j < width; j++){
+            char *end;
+            float value = strtof(cursor, &end);
+            if (end == cursor)
+                return false;
+            cursor = end;
+            if (j >= minW && j < maxW)
+                dest[i * height + j - minW] = value;
+        }
+    }
+    
+    return true;
+}
+
 int GetPixels::getdir(string dir, vector<string> &files)
 {
     DIR *dp;
@@ -88,6 +135,10 @@ int GetPixels::getdir(string dir, vector<string> &files)
         files.push_back(string(dirp->d_name));
     }
     closedir(dp);
+    
+    // readdir order depends on the file system: sort so that every system
+    //  sees the same order
+    sort(files.begin(), files.end());
     return 0;
 }
 
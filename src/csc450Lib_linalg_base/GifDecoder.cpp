@@ -0,0 +1,252 @@
+//
+//  GifDecoder.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "GifDecoder.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+
+namespace {
+    
+    // Largest code of the GIF variant of LZW
+    const int MAX_CODES = 4096;
+    
+    /**
+     * Reads the LSB-first variable-width codes of the image data, whose
+     *  sub-blocks have already been concatenated
+     */
+    class CodeReader {
+    private:
+        const vector<unsigned char> &bytes;
+        size_t bit;
+        
+    public:
+        CodeReader(const vector<unsigned char> &bytes) : bytes(bytes), bit(0) {}
+        
+        /** Returns the next code, or -1 past the end of the data */
+        int read(int size) {
+            if (bit + size > bytes.size() * 8)
+                return -1;
+            
+            // A code of up to 12 bits spans at most 3 bytes
+            size_t byte = bit >> 3;
+            unsigned int window = bytes[byte];
+            if (byte + 1 < bytes.size())
+                window |= bytes[byte + 1] << 8;
+            if (byte + 2 < bytes.size())
+                window |= bytes[byte + 2] << 16;
+            int code = (window >> (bit & 7)) & ((1 << size) - 1);
+            bit += size;
+            return code;
+        }
+    };
+    
+    /**
+     * The most indices that bytes of LZW data can decode to. The i-th code
+     *  after a clear stands for at most i indices (each table entry is one
+     *  longer than an earlier string), and no string is longer than the
+     *  table
+     */
+    size_t maxDecodedLength(size_t bytes, int minCodeSize) {
+        size_t codes = bytes * 8 / (minCodeSize + 1);
+        if (codes <= (size_t)MAX_CODES)
+            return codes * (codes + 1) / 2;
+        return (size_t)MAX_CODES * (MAX_CODES + 1) / 2
+            + (codes - MAX_CODES) * MAX_CODES;
+    }
+    
+    /**
+     * Decodes the LZW stream into count palette indices. Returns false when
+     *  the stream is malformed
+     */
+    bool decompress(const vector<unsigned char> &data, int minCodeSize,
+                    unsigned char *out, size_t count) {
+        if (minCodeSize < 2 || minCodeSize > 11)
+            return false;
+        
+        int clear = 1 << minCodeSize;
+        int end = clear + 1;
+        int codeSize = minCodeSize + 1;
+        int next = clear + 2;
+        
+        vector<short> prefix(MAX_CODES);
+        vector<unsigned char> suffix(MAX_CODES);
+        vector<unsigned char> stack(MAX_CODES + 1);
+        for (int i = 0; i < clear; i++)
+            suffix[i] = (unsigned char)i;
+        
+        CodeReader reader(data);
+        size_t written = 0;
+        int prev = -1;
+        unsigned char first = 0;
+        
+        while (written < count) {
+            int code = reader.read(codeSize);
+            if (code < 0 || code == end)
+                break;
+            if (code == clear) {
+                codeSize = minCodeSize + 1;
+                next = clear + 2;
+                prev = -1;
+                continue;
+            }
+            if (prev < 0) {
+                if (code >= clear)
+                    return false;
+                out[written++] = (unsigned char)code;
+                first = (unsigned char)code;
+                prev = code;
+                continue;
+            }
+            
+            // Walk the string of the code back to its root, last byte first.
+            //  A code not yet in the table is prev's string plus its own
+            //  first byte
+            int depth = 0;
+            int current = code;
+            if (code > next)
+                return false;
+            if (code == next) {
+                stack[depth++] = first;
+                current = prev;
+            }
+            while (current >= clear) {
+                stack[depth++] = suffix[current];
+                current = prefix[current];
+            }
+            stack[depth++] = (unsigned char)current;
+            first = (unsigned char)current;
+            
+            while (depth > 0 && written < count)
+                out[written++] = stack[--depth];
+            
+            if (next < MAX_CODES) {
+                prefix[next] = (short)prev;
+                suffix[next] = first;
+                next++;
+                if (next == (1 << codeSize) && codeSize < 12)
+                    codeSize++;
+            }
+            prev = code;
+        }
+        return written == count;
+    }
+}
+
+unsigned char* GifDecoder::decode(const string &filename,
+                                  int *width, int *height) {
+    ifstream input(filename, ios::binary);
+    if (!input.good())
+        return NULL;
+    vector<unsigned char> file((istreambuf_iterator<char>(input)),
+                               istreambuf_iterator<char>());
+    input.close();
+    return decode(file.data(), file.size(), width, height);
+}
+
+unsigned char* GifDecoder::decode(const unsigned char *file, size_t length,
+                                  int *width, int *height) {
+    size_t pos = 13;
+    if (length < pos || file[0] != 'G' || file[1] != 'I' || file[2] != 'F')
+        return NULL;
+    
+    // Logical screen descriptor, then the global palette if any
+    unsigned char flags = file[10];
+    vector<unsigned char> palette;
+    if (flags & 0x80) {
+        size_t size = 3 * ((size_t)1 << ((flags & 7) + 1));
+        if (pos + size > length)
+            return NULL;
+        palette.assign(file + pos, file + pos + size);
+        pos += size;
+    }
+    
+    while (pos < length) {
+        unsigned char block = file[pos++];
+        
+        if (block == 0x21) {
+            // Extension: label, then sub-blocks up to a zero length
+            pos++;
+            while (pos < length && file[pos] != 0)
+                pos += file[pos] + 1;
+            pos++;
+            continue;
+        }
+        if (block != 0x2C)
+            return NULL;
+        
+        // Image descriptor
+        if (pos + 9 > length)
+            return NULL;
+        int w = file[pos + 4] | (file[pos + 5] << 8);
+        int h = file[pos + 6] | (file[pos + 7] << 8);
+        unsigned char imageFlags = file[pos + 8];
+        bool interlaced = (imageFlags & 0x40) != 0;
+        pos += 9;
+        if (imageFlags & 0x80) {
+            size_t size = 3 * ((size_t)1 << ((imageFlags & 7) + 1));
+            if (pos + size > length)
+                return NULL;
+            palette.assign(file + pos, file + pos + size);
+            pos += size;
+        }
+        if (palette.empty() || w <= 0 || h <= 0 || pos >= length)
+            return NULL;
+        
+        // Image data: code size, then sub-blocks up to a zero length
+        int minCodeSize = file[pos++];
+        vector<unsigned char> data;
+        while (pos < length && file[pos] != 0) {
+            size_t blockLength = file[pos++];
+            if (pos + blockLength > length)
+                return NULL;
+            data.insert(data.end(), file + pos, file + pos + blockLength);
+            pos += blockLength;
+        }
+        
+        // A descriptor can ask for 4 GB; refuse it unless the data could
+        //  actually decode to that many indices
+        if ((size_t)w * h > maxDecodedLength(data.size(), minCodeSize))
+            return NULL;
+        vector<unsigned char> indices((size_t)w * h);
+        if (!decompress(data, minCodeSize, indices.data(), indices.size()))
+            return NULL;
+        
+        // Map the palette to luminance, undoing the interlacing on the way
+        int colors = (int)palette.size() / 3;
+        unsigned char *pixels = new unsigned char[(size_t)w * h];
+        int startRow[] = { 0, 4, 2, 1 };
+        int stepRow[] = { 8, 8, 4, 2 };
+        int source = 0;
+        for (int pass = 0; pass < (interlaced ? 4 : 1); pass++) {
+            int row0 = interlaced ? startRow[pass] : 0;
+            int step = interlaced ? stepRow[pass] : 1;
+            for (int row = row0; row < h; row += step, source++) {
+                for (int col = 0; col < w; col++) {
+                    int index = indices[(size_t)source * w + col];
+                    if (index >= colors)
+                        index = 0;
+                    const unsigned char *rgb = &palette[3 * index];
+                    pixels[(size_t)row * w + col] = (unsigned char)
+                        ((299 * rgb[0] + 587 * rgb[1] + 114 * rgb[2] + 500) / 1000);
+                }
+            }
+        }
+        
+        *width = w;
+        *height = h;
+        return pixels;
+    }
+    return NULL;
+}
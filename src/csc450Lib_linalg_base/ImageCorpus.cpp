@@ -0,0 +1,260 @@
+//
+//  ImageCorpus.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <climits>
+#include <cmath>
+
+#include "ImageCorpus.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+
+namespace {
+    
+    const char MAGIC[8] = { 'E', 'F', 'C', 'O', 'R', 'P', 'U', 'S' };
+    const uint32_t VERSION = 1;
+    const int LABEL_LENGTH = 32;
+    const uint32_t MAX_LABEL_LENGTH = 4096;
+    
+    struct CorpusHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t count;
+        uint32_t labelLength;
+        uint64_t pixelOffset;
+        unsigned char reserved[24];
+    };
+    static_assert(sizeof(CorpusHeader) == 64, "corpus header must be 64 bytes");
+    
+    size_t pixelSize(PixelFormat format) {
+        return format == PIXEL_UINT8 ? 1 : sizeof(float);
+    }
+    
+    size_t alignUp(size_t offset) {
+        return (offset + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+    }
+}
+
+ImageCorpus::ImageCorpus(void) {
+    this->base = NULL;
+    this->length = 0;
+    this->writable = false;
+}
+
+ImageCorpus::ImageCorpus(const string &filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw "Cannot open corpus";
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CorpusHeader)) {
+        close(fd);
+        throw "Not an image corpus";
+    }
+    
+    // A private mapping lets the float views be written to (copy on write)
+    //  without ever touching the file
+    this->length = info.st_size;
+    this->writable = false;
+    void *p = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        throw "Cannot map corpus";
+    this->base = (unsigned char*)p;
+    
+    const CorpusHeader *header = (const CorpusHeader*)base;
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+        || header->version != VERSION
+        || header->format > PIXEL_UINT8) {
+        munmap(base, length);
+        throw "Not an image corpus";
+    }
+    if (header->width == 0 || header->height == 0
+        || header->width > INT_MAX || header->height > INT_MAX
+        || header->count > INT_MAX || header->labelLength == 0
+        || header->labelLength > MAX_LABEL_LENGTH
+        || (uint64_t)header->width * header->height > INT_MAX) {
+        munmap(base, length);
+        throw "Not an image corpus";
+    }
+    this->format = (PixelFormat)header->format;
+    this->width = header->width;
+    this->height = header->height;
+    this->count = header->count;
+    this->labelLength = header->labelLength;
+    
+    // The ids and labels follow the header and end before the pixels, and
+    //  the pixels end inside the mapping; written so that no product or sum
+    //  can wrap around, with float pixels on an element boundary
+    size_t mapped = length;
+    auto fits = [mapped](uint64_t offset, size_t n, size_t size) {
+        return offset <= mapped && n <= (mapped - offset) / size;
+    };
+    size_t labelOffset = sizeof(CorpusHeader) + (size_t)count * sizeof(int32_t);
+    size_t labelEnd = labelOffset + (size_t)count * labelLength;
+    if (!fits(sizeof(CorpusHeader), count, sizeof(int32_t))
+        || !fits(labelOffset, count, labelLength)
+        || header->pixelOffset < labelEnd
+        || header->pixelOffset % pixelSize(format) != 0
+        || !fits(header->pixelOffset, count,
+                 (size_t)width * height * pixelSize(format))) {
+        munmap(base, length);
+        throw "Truncated image corpus";
+    }
+    locate(header->pixelOffset);
+}
+
+ImageCorpus::~ImageCorpus(void) {
+    if (base != NULL) {
+        if (writable)
+            msync(base, length, MS_SYNC);
+        munmap(base, length);
+    }
+}
+
+void ImageCorpus::locate(size_t pixelOffset) {
+    this->ids = (int32_t*)(base + sizeof(CorpusHeader));
+    this->labels = (char*)(ids + count);
+    this->pixels = base + pixelOffset;
+}
+
+ImageCorpus* ImageCorpus::create(const string &filename,
+                                 int width, int height,
+                                 const vector<int> &ids,
+                                 const vector<string> &labels,
+                                 PixelFormat format) {
+    if (ids.size() != labels.size())
+        throw "Labels do not match ids";
+    int count = (int)ids.size();
+    size_t pixelOffset = alignUp(sizeof(CorpusHeader)
+                                 + count * (sizeof(int32_t) + LABEL_LENGTH));
+    size_t length = pixelOffset
+        + (size_t)width * height * count * pixelSize(format);
+    
+    int fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw "Cannot create corpus";
+    if (ftruncate(fd, length) != 0) {
+        close(fd);
+        throw "Cannot create corpus";
+    }
+    void *p = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        throw "Cannot map corpus";
+    
+    ImageCorpus *corpus = new ImageCorpus();
+    corpus->base = (unsigned char*)p;
+    corpus->length = length;
+    corpus->writable = true;
+    corpus->format = format;
+    corpus->width = width;
+    corpus->height = height;
+    corpus->count = count;
+    corpus->labelLength = LABEL_LENGTH;
+    
+    CorpusHeader *header = (CorpusHeader*)corpus->base;
+    memcpy(header->magic, MAGIC, sizeof(MAGIC));
+    header->version = VERSION;
+    header->format = format;
+    header->width = width;
+    header->height = height;
+    header->count = count;
+    header->labelLength = LABEL_LENGTH;
+    header->pixelOffset = pixelOffset;
+    
+    corpus->locate(pixelOffset);
+    for (int i = 0; i < count; i++) {
+        corpus->ids[i] = ids[i];
+        strncpy(corpus->labels + (size_t)i * LABEL_LENGTH, labels[i].c_str(),
+                LABEL_LENGTH - 1);
+    }
+    return corpus;
+}
+
+void ImageCorpus::setImage(int i, const float *values) {
+    if (!writable)
+        throw "Corpus is read-only";
+    if (i < 0 || i >= count)
+        throw "Index out of bounds";
+    
+    size_t numPixels = (size_t)width * height;
+    if (format == PIXEL_FLOAT32) {
+        float *plane = (float*)pixels + i;
+        for (size_t p = 0; p < numPixels; p++)
+            plane[p * count] = values[p];
+    } else {
+        unsigned char *plane = pixels + i;
+        for (size_t p = 0; p < numPixels; p++) {
+            float v = std::round(values[p] * 255);
+            plane[p * count] = (unsigned char)std::min(255.0f, std::max(0.0f, v));
+        }
+    }
+}
+
+int ImageCorpus::size(void) const {
+    return count;
+}
+
+int ImageCorpus::getWidth(void) const {
+    return width;
+}
+
+int ImageCorpus::getHeight(void) const {
+    return height;
+}
+
+PixelFormat ImageCorpus::getFormat(void) const {
+    return format;
+}
+
+int ImageCorpus::getSubjectID(int i) const {
+    return ids[i];
+}
+
+string ImageCorpus::getLabel(int i) const {
+    const char *label = labels + (size_t)i * labelLength;
+    return string(label, strnlen(label, labelLength));
+}
+
+Matrix* ImageCorpus::getImages(void) const {
+    int numPixels = width * height;
+    if (format == PIXEL_FLOAT32)
+        return new Matrix(numPixels, count, (float*)pixels, count);
+    
+    Matrix *images = new Matrix(numPixels, count);
+    for (int p = 0; p < numPixels; p++) {
+        const unsigned char *src = pixels + (size_t)p * count;
+        float *dst = images->getData() + (size_t)p * images->stride();
+        for (int i = 0; i < count; i++)
+            dst[i] = src[i] / 255.0f;
+    }
+    return images;
+}
+
+ColumnVector* ImageCorpus::getImage(int i) const {
+    if (i < 0 || i >= count)
+        throw "Index out of bounds";
+    int numPixels = width * height;
+    if (format == PIXEL_FLOAT32)
+        return new ColumnVector(numPixels, (float*)pixels + i, count);
+    
+    ColumnVector *image = new ColumnVector(numPixels);
+    for (int p = 0; p < numPixels; p++)
+        image->set(p, pixels[(size_t)p * count + i] / 255.0f);
+    return image;
+}
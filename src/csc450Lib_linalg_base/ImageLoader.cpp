@@ -0,0 +1,286 @@
+//
+//  ImageLoader.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <ctype.h>
+#include <dirent.h>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "ImageLoader.h"
+#include "GifDecoder.h"
+#include "PnmDecoder.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+
+namespace {
+
+    /** Whether name ends with one of the image extensions, in any case */
+    bool isImageFile(const string &name) {
+        size_t dot = name.rfind('.');
+        if (dot == string::npos || name[0] == '.')
+            return false;
+        string ext = name.substr(dot + 1);
+        for (size_t i = 0; i < ext.size(); i++)
+            ext[i] = (char)tolower(ext[i]);
+        return ext == "gif" || ext == "pgm" || ext == "ppm" || ext == "pnm";
+    }
+
+    /** Reads a whole file into buffer; returns false if it cannot be read */
+    bool readFile(const string &filename, vector<unsigned char> &buffer) {
+        ifstream input(filename, ios::binary | ios::ate);
+        if (!input.good())
+            return false;
+        streamsize size = input.tellg();
+        if (size < 0)
+            return false;
+        buffer.resize((size_t)size);
+        input.seekg(0);
+        return (bool)input.read((char*)buffer.data(), size);
+    }
+
+    /**
+     * Reads and decodes a file into a new[]-allocated array of gray levels,
+     *  or NULL. The file buffer is reused by every image a thread reads
+     */
+    unsigned char* readGray(const string &filename, int *width, int *height) {
+        static thread_local vector<unsigned char> buffer;
+        if (!readFile(filename, buffer))
+            return NULL;
+        return ImageLoader::decode(buffer.data(), buffer.size(), width, height);
+    }
+}
+
+ImageLoader::ImageLoader(int threads, int readAhead, PixelFormat format) {
+    if (threads <= 0)
+        threads = max(1, (int)thread::hardware_concurrency());
+    this->threads = threads;
+    this->readAhead = readAhead > 0 ? readAhead : 4 * threads;
+    this->format = format;
+}
+
+void ImageLoader::setCenterCrop(bool centerCrop) {
+    preprocessor.setCenterCrop(centerCrop);
+}
+
+void ImageLoader::setDownsample(int factor) {
+    preprocessor.setDownsample(factor);
+}
+
+void ImageLoader::setPreprocessor(const ImagePreprocessor &preprocessor) {
+    if (preprocessor.normalizes() && format == PIXEL_UINT8)
+        throw "Normalized images need PIXEL_FLOAT32";
+    this->preprocessor = preprocessor;
+}
+
+const ImagePreprocessor& ImageLoader::getPreprocessor(void) const {
+    return preprocessor;
+}
+
+vector<string> ImageLoader::list(const string &dir) {
+    DIR *dp = opendir(dir.c_str());
+    if (dp == NULL)
+        throw "Could not open directory";
+    vector<string> names;
+    struct dirent *entry;
+    while ((entry = readdir(dp)) != NULL) {
+        if (isImageFile(entry->d_name))
+            names.push_back(entry->d_name);
+    }
+    closedir(dp);
+    sort(names.begin(), names.end());
+
+    string prefix = dir;
+    if (!prefix.empty() && prefix[prefix.size() - 1] != '/')
+        prefix += "/";
+    for (size_t i = 0; i < names.size(); i++)
+        names[i] = prefix + names[i];
+    return names;
+}
+
+unsigned char* ImageLoader::decode(const unsigned char *file, size_t length,
+                                   int *width, int *height) {
+    if (length >= 3 && file[0] == 'G' && file[1] == 'I' && file[2] == 'F')
+        return GifDecoder::decode(file, length, width, height);
+    if (length >= 2 && file[0] == 'P')
+        return PnmDecoder::decode(file, length, width, height);
+    return NULL;
+}
+
+bool ImageLoader::read(const string &filename, Image &image) const {
+    int w, h;
+    unsigned char *gray = readGray(filename, &w, &h);
+    if (gray == NULL)
+        return false;
+    int ow, oh;
+    if (!preprocessor.outputSize(w, h, &ow, &oh)) {
+        delete [] gray;
+        return false;
+    }
+
+    image.width = ow;
+    image.height = oh;
+    image.format = format;
+    size_t pixels = (size_t)ow * oh;
+    if (format == PIXEL_FLOAT32) {
+        image.data.resize(pixels * sizeof(float));
+        preprocessor.apply(gray, w, h, (float*)image.data.data(), 1);
+    } else {
+        static thread_local vector<float> values;
+        values.resize(pixels);
+        preprocessor.apply(gray, w, h, values.data(), 1);
+        image.data.resize(pixels);
+        for (size_t p = 0; p < pixels; p++)
+            image.data[p] = (unsigned char)lround(min(max(values[p], 0.0f), 1.0f) * 255);
+    }
+    delete [] gray;
+    return true;
+}
+
+void ImageLoader::stream(const vector<string> &files,
+                         const function<void(int, const Image&)> &consumer) const {
+    int n = (int)files.size();
+    if (n == 0)
+        return;
+
+    // Slot i % window holds image i from its decoding to its consumption
+    int window = min(readAhead, n);
+    vector<Image> slots(window);
+    vector<int> state(window, 0);    // 0 free, 1 ready, 2 failed
+    mutex lock;
+    condition_variable changed;
+    int next = 0;
+    int consumed = 0;
+    bool stop = false;
+
+    auto work = [&]() {
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            changed.wait(guard, [&]() {
+                return stop || next >= n || next < consumed + window;
+            });
+            if (stop || next >= n)
+                return;
+            int i = next++;
+            guard.unlock();
+
+            Image image;
+            bool ok;
+            try {
+                ok = read(files[i], image);
+            } catch (...) {
+                ok = false;
+            }
+
+            guard.lock();
+            slots[i % window] = std::move(image);
+            state[i % window] = ok ? 1 : 2;
+            changed.notify_all();
+        }
+    };
+
+    vector<thread> pool;
+    for (int t = 0; t < min(threads, n); t++)
+        pool.push_back(thread(work));
+
+    auto finish = [&]() {
+        {
+            lock_guard<mutex> guard(lock);
+            stop = true;
+        }
+        changed.notify_all();
+        for (size_t t = 0; t < pool.size(); t++)
+            pool[t].join();
+    };
+
+    try {
+        for (int i = 0; i < n; i++) {
+            Image image;
+            {
+                unique_lock<mutex> guard(lock);
+                changed.wait(guard, [&]() { return state[i % window] != 0; });
+                if (state[i % window] == 2)
+                    throw "Could not read image";
+                image = std::move(slots[i % window]);
+                state[i % window] = 0;
+                consumed = i + 1;
+            }
+            changed.notify_all();
+            consumer(i, image);
+        }
+    } catch (...) {
+        finish();
+        throw;
+    }
+    finish();
+}
+
+Matrix* ImageLoader::load(const vector<string> &files) const {
+    int count = (int)files.size();
+    if (count == 0)
+        return new Matrix(0, 0);
+
+    // The first image sets the size of the columns
+    int w, h, ow, oh;
+    unsigned char *gray = readGray(files[0], &w, &h);
+    if (gray == NULL)
+        throw "Could not read image";
+    if (!preprocessor.outputSize(w, h, &ow, &oh)) {
+        delete [] gray;
+        throw "Image is too small";
+    }
+    Matrix *images = new Matrix(ow * oh, count);
+    float *d = images->getData();
+    size_t ld = images->stride();
+    preprocessor.apply(gray, w, h, d, ld);
+    delete [] gray;
+
+    // The others are shared out as the threads become free. A worker must
+    //  not let an exception escape (a bad file would terminate the process),
+    //  so any failure is reported through error, as in stream()
+    atomic<int> next(1);
+    atomic<const char*> error(NULL);
+    auto work = [&]() {
+        int i;
+        while (error.load() == NULL && (i = next++) < count) {
+            int iw, ih, iow, ioh;
+            unsigned char *gray = NULL;
+            try {
+                gray = readGray(files[i], &iw, &ih);
+                if (gray == NULL)
+                    error = "Could not read image";
+                else if (!preprocessor.outputSize(iw, ih, &iow, &ioh)
+                         || iow != ow || ioh != oh)
+                    error = "Images differ in size";
+                else
+                    preprocessor.apply(gray, iw, ih, d + i, ld);
+            } catch (...) {
+                error = "Could not read image";
+            }
+            delete [] gray;
+        }
+    };
+    vector<thread> pool;
+    for (int t = 0; t < min(threads, count - 1); t++)
+        pool.push_back(thread(work));
+    for (size_t t = 0; t < pool.size(); t++)
+        pool[t].join();
+
+    if (error.load() != NULL) {
+        delete images;
+        throw error.load();
+    }
+    return images;
+}
@@ -0,0 +1,247 @@
+//
+//  ImagePreprocessor.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ImagePreprocessor.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+
+namespace {
+
+    /**
+     * The source pixels averaged into each output pixel along one axis:
+     *  output o covers [o * scale, (o + 1) * scale) and takes count[o]
+     *  pixels from first[o], weighted by how much of each it covers.
+     *  Pixels past limit (from rounding) are left out
+     */
+    struct Footprint {
+        vector<int> first;
+        vector<int> count;
+        vector<int> offset;
+        vector<float> weights;
+
+        Footprint(int outputs, double scale, int limit) {
+            for (int o = 0; o < outputs; o++) {
+                double lo = o * scale;
+                double hi = (o + 1) * scale;
+                int i0 = (int)floor(lo);
+                int i1 = min((int)ceil(hi), limit);
+                first.push_back(i0);
+                count.push_back(i1 - i0);
+                offset.push_back((int)weights.size());
+                for (int i = i0; i < i1; i++)
+                    weights.push_back((float)(min(hi, i + 1.0) - max(lo, (double)i)));
+            }
+        }
+    };
+
+    /**
+     * Combines horizontally resampled rows (ow values each) down the
+     *  columns, writing output pixel p to dest[p * stride] divided by area.
+     *  horizontal(y, row) resamples source row y into row; only the window
+     *  of rows the current output row covers is kept, each source row
+     *  being resampled once
+     */
+    template <class Horizontal>
+    void verticalPass(Horizontal horizontal, int ow, const Footprint &down,
+                      float area, float *dest, size_t stride) {
+        int window = 1;
+        for (size_t oy = 0; oy < down.count.size(); oy++)
+            window = max(window, down.count[oy]);
+        static thread_local vector<float> rows;
+        static thread_local vector<float> sums;
+        rows.resize((size_t)window * ow);
+        sums.resize(ow);
+        int next = 0;
+        for (int oy = 0; oy < (int)down.first.size(); oy++) {
+            // Source rows only move forward, so the rows computed here
+            //  replace ones no later output row covers
+            int first = down.first[oy];
+            int last = first + down.count[oy];
+            for (next = max(next, first); next < last; next++)
+                horizontal(next, rows.data() + (size_t)(next % window) * ow);
+            
+            const float *w = down.weights.data() + down.offset[oy];
+            std::fill(sums.begin(), sums.end(), 0.0f);
+            for (int k = 0; k < down.count[oy]; k++) {
+                const float *row = rows.data() + (size_t)((first + k) % window) * ow;
+                for (int ox = 0; ox < ow; ox++)
+                    sums[ox] += w[k] * row[ox];
+            }
+            float *d = dest + (size_t)oy * ow * stride;
+            for (int ox = 0; ox < ow; ox++)
+                d[ox * stride] = sums[ox] / area;
+        }
+    }
+}
+
+ImagePreprocessor::ImagePreprocessor(void) {
+    this->centerCrop = false;
+    this->downsample = 1;
+    this->width = 0;
+    this->height = 0;
+    this->equalize = false;
+    this->normalize = false;
+}
+
+void ImagePreprocessor::setCenterCrop(bool centerCrop) {
+    this->centerCrop = centerCrop;
+}
+
+void ImagePreprocessor::setDownsample(int factor) {
+    if (factor < 1)
+        throw "Downsampling factor must be positive";
+    this->downsample = factor;
+    this->width = 0;
+    this->height = 0;
+}
+
+void ImagePreprocessor::setSize(int width, int height) {
+    if (width < 0 || height < 0 || (width == 0) != (height == 0))
+        throw "Image size must be positive";
+    this->width = width;
+    this->height = height;
+}
+
+void ImagePreprocessor::setEqualize(bool equalize) {
+    this->equalize = equalize;
+}
+
+void ImagePreprocessor::setNormalize(bool normalize) {
+    this->normalize = normalize;
+}
+
+bool ImagePreprocessor::normalizes(void) const {
+    return normalize;
+}
+
+bool ImagePreprocessor::outputSize(int width, int height,
+                                   int *outWidth, int *outHeight) const {
+    if (centerCrop)
+        width = height = min(width, height);
+    if (this->width > 0) {
+        *outWidth = this->width;
+        *outHeight = this->height;
+    } else {
+        *outWidth = width / downsample;
+        *outHeight = height / downsample;
+    }
+    return width > 0 && height > 0 && *outWidth > 0 && *outHeight > 0;
+}
+
+void ImagePreprocessor::apply(const unsigned char *gray, int width, int height,
+                              float *dest, size_t stride) const {
+    int ow, oh;
+    if (!outputSize(width, height, &ow, &oh))
+        throw "Image is too small";
+
+    // Source window: the crop, less what a whole factor leaves over
+    int x0 = 0, y0 = 0, cw = width, ch = height;
+    if (centerCrop) {
+        int side = min(width, height);
+        x0 = (width - side) / 2;
+        y0 = (height - side) / 2;
+        cw = ch = side;
+    }
+    double sx, sy;
+    if (this->width > 0) {
+        sx = (double)cw / ow;
+        sy = (double)ch / oh;
+    } else {
+        sx = sy = downsample;
+        cw = ow * downsample;
+        ch = oh * downsample;
+    }
+    Footprint across(ow, sx, cw);
+    Footprint down(oh, sy, ch);
+
+    // Gray level to value, through the equalized histogram if asked
+    float level[256];
+    if (equalize) {
+        size_t histogram[256] = { 0 };
+        for (int y = 0; y < ch; y++) {
+            const unsigned char *src = gray + (size_t)(y0 + y) * width + x0;
+            for (int x = 0; x < cw; x++)
+                histogram[src[x]]++;
+        }
+        size_t total = (size_t)cw * ch;
+        size_t cdf = 0;
+        size_t lowest = 0;
+        for (int v = 0; v < 256; v++) {
+            cdf += histogram[v];
+            if (lowest == 0)
+                lowest = cdf;
+            level[v] = total == lowest ? v
+                : (float)(255.0 * (double)(cdf - lowest) / (double)(total - lowest));
+        }
+    } else {
+        for (int v = 0; v < 256; v++)
+            level[v] = v;
+    }
+
+    // Horizontal pass, one row of ow values per source row, fed to the
+    //  vertical pass straight into dest, dividing by the area covered
+    auto horizontal = [&](int y, float *row) {
+        const unsigned char *src = gray + (size_t)(y0 + y) * width + x0;
+        for (int ox = 0; ox < ow; ox++) {
+            const float *w = across.weights.data() + across.offset[ox];
+            const unsigned char *s = src + across.first[ox];
+            float sum = 0;
+            for (int k = 0; k < across.count[ox]; k++)
+                sum += w[k] * level[s[k]];
+            row[ox] = sum;
+        }
+    };
+    verticalPass(horizontal, ow, down, 255.0f * (float)(sx * sy), dest, stride);
+
+    if (normalize) {
+        size_t n = (size_t)ow * oh;
+        double mean = 0;
+        double squares = 0;
+        for (size_t p = 0; p < n; p++) {
+            mean += dest[p * stride];
+            squares += (double)dest[p * stride] * dest[p * stride];
+        }
+        mean /= n;
+        double variance = squares / n - mean * mean;
+        float shift = (float)mean;
+        float factor = variance > 0 ? (float)(1.0 / sqrt(variance)) : 1.0f;
+        for (size_t p = 0; p < n; p++)
+            dest[p * stride] = (dest[p * stride] - shift) * factor;
+    }
+}
+
+void ImagePreprocessor::resample(const float *src, int width, int height,
+                                 size_t srcStride, float *dest,
+                                 int outWidth, int outHeight, size_t stride) {
+    if (width < 1 || height < 1 || outWidth < 1 || outHeight < 1)
+        throw "Image size must be positive";
+    double sx = (double)width / outWidth;
+    double sy = (double)height / outHeight;
+    Footprint across(outWidth, sx, width);
+    Footprint down(outHeight, sy, height);
+
+    auto horizontal = [&](int y, float *row) {
+        const float *line = src + (size_t)y * width * srcStride;
+        for (int ox = 0; ox < outWidth; ox++) {
+            const float *w = across.weights.data() + across.offset[ox];
+            const float *s = line + (size_t)across.first[ox] * srcStride;
+            float sum = 0;
+            for (int k = 0; k < across.count[ox]; k++)
+                sum += w[k] * s[k * srcStride];
+            row[ox] = sum;
+        }
+    };
+    verticalPass(horizontal, outWidth, down, (float)(sx * sy), dest, stride);
+}
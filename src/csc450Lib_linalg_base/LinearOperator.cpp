@@ -0,0 +1,12 @@
+//
+//  LinearOperator.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+#include "LinearOperator.h"
+using namespace csc450Lib_linalg_base;
+
+LinearOperator::~LinearOperator(void) {}
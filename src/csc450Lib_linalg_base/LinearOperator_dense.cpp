@@ -0,0 +1,31 @@
+//
+//  LinearOperator_dense.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+#include "LinearOperator_dense.h"
+#include "MatrixMultiplier.h"
+using namespace csc450Lib_linalg_base;
+
+LinearOperator_dense::LinearOperator_dense(const Matrix *m) {
+    this->m = m;
+}
+
+int LinearOperator_dense::size(void) const {
+    return m->rows();
+}
+
+void LinearOperator_dense::apply(const Matrix *x, Matrix *y) const {
+    if (x->cols() != m->rows() || y->rows() != x->rows() ||
+        y->cols() != m->rows())
+        throw "Matrices do not match";
+    
+    // Rows of y are transpose(M * x_i) = transpose(x_i) * M, M symmetric
+    MatrixMultiplier::gemm(false, false, x->rows(), m->cols(), m->rows(),
+                           1.0f, x->getData(), x->stride(),
+                           m->getData(), m->stride(),
+                           0.0f, y->getData(), y->stride());
+}
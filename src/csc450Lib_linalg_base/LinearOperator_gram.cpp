@@ -0,0 +1,45 @@
+//
+//  LinearOperator_gram.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+#include "LinearOperator_gram.h"
+#include "MatrixMultiplier.h"
+using namespace csc450Lib_linalg_base;
+
+LinearOperator_gram::LinearOperator_gram(const Matrix *a) {
+    this->a = a;
+    this->ax = NULL;
+}
+
+LinearOperator_gram::~LinearOperator_gram(void) {
+    delete ax;
+}
+
+int LinearOperator_gram::size(void) const {
+    return a->cols();
+}
+
+void LinearOperator_gram::apply(const Matrix *x, Matrix *y) const {
+    if (x->cols() != a->cols() || y->rows() != x->rows() ||
+        y->cols() != a->cols())
+        throw "Matrices do not match";
+    
+    if (ax == NULL || ax->cols() != x->rows()) {
+        delete ax;
+        ax = new Matrix(a->rows(), x->rows());
+    }
+    
+    // ax = A * transpose(x), then y = transpose(ax) * A
+    MatrixMultiplier::gemm(false, true, a->rows(), x->rows(), a->cols(),
+                           1.0f, a->getData(), a->stride(),
+                           x->getData(), x->stride(),
+                           0.0f, ax->getData(), ax->stride());
+    MatrixMultiplier::gemm(true, false, x->rows(), a->cols(), a->rows(),
+                           1.0f, ax->getData(), ax->stride(),
+                           a->getData(), a->stride(),
+                           0.0f, y->getData(), y->stride());
+}
@@ -8,39 +8,110 @@
 
 #include "ColumnVector.h"
 #include "RowVector.h"
+#include "MatrixMultiplier.h"
+#include "TaskScheduler.h"
+#include "MatrixWriter.h"
 
 using namespace std;
 using namespace csc450Lib_linalg_base;
 
+float* Matrix::allocate(size_t n) {
+    void *p = NULL;
+    if (posix_memalign(&p, MATRIX_ALIGNMENT, (n > 0 ? n : 1) * sizeof(float)))
+        throw "Out of memory";
+    return (float*)p;
+}
+
 Matrix::Matrix(int nbRows, int nbCols, float ** a) {
     this->nbRows = nbRows;
     this->nbCols = nbCols;
-    this->a = a;
+    this->ld = nbCols;
+    this->capRows = nbRows;
+    this->owner = true;
+    this->rowPtrs = NULL;
+    this->data = allocate((size_t)nbRows * nbCols);
+    setMatrix(a);
 }
 
 Matrix::Matrix(int nbRows, const int nbCols) {
     this->nbRows = nbRows;
     this->nbCols = nbCols;
-    this->a = new float*[nbRows];
-    for (int i = 0; i < nbRows; i++)
-        a[i] = new float[nbCols];
+    this->ld = nbCols;
+    this->capRows = nbRows;
+    this->owner = true;
+    this->rowPtrs = NULL;
+    this->data = allocate((size_t)nbRows * nbCols);
+    memset(data, 0, (size_t)nbRows * nbCols * sizeof(float));
+}
+
+Matrix::Matrix(int nbRows, int nbCols, float * data, int ld) {
+    this->nbRows = nbRows;
+    this->nbCols = nbCols;
+    this->ld = ld;
+    this->capRows = nbRows;
+    this->owner = false;
+    this->rowPtrs = NULL;
+    this->data = data;
 }
 
 Matrix::~Matrix() {
-    for (int i = 0; i < nbRows; i++)
-        delete [] a[i];
-    delete[] a;
+    if (owner)
+        free(data);
+    delete [] rowPtrs;
     
+    this->data = NULL;
+    this->rowPtrs = NULL;
     this->nbRows = 0;
     this->nbCols = 0;
 }
 
+void Matrix::reallocate(int newCapRows, int newLd) {
+    if (!owner)
+        throw "Cannot resize a matrix view";
+    
+    float *newData = allocate((size_t)newCapRows * newLd);
+    for (int i = 0; i < nbRows; i++)
+        memcpy(newData + (size_t)i * newLd, data + (size_t)i * ld,
+               nbCols * sizeof(float));
+    free(data);
+    
+    data = newData;
+    ld = newLd;
+    capRows = newCapRows;
+    invalidateRowPtrs();
+}
+
+void Matrix::invalidateRowPtrs(void) {
+    delete [] rowPtrs;
+    rowPtrs = NULL;
+}
+
+Matrix* Matrix::view(const Matrix *matA, int theRow, int theCol,
+                     int nbRows, int nbCols) {
+    if (theRow < 0 || theCol < 0 ||
+        theRow + nbRows > matA->rows() || theCol + nbCols > matA->cols())
+        throw "View out of range";
+    
+    return new Matrix(nbRows, nbCols,
+                      matA->data + (size_t)theRow * matA->ld + theCol,
+                      matA->ld);
+}
+
 const Matrix* Matrix::transpose(const Matrix *matA) {
     Matrix* t = new Matrix(matA->cols(), matA->rows());
     
-    for (int i = 0; i < matA->rows(); i++) {
-        for (int j = 0; j < matA->cols(); j++) {
-            t->set(j, i, matA->get(i, j));
+    // Walk in tiles so that both the reads and the writes stay in cache
+    const int tile = 32;
+    for (int ii = 0; ii < matA->rows(); ii += tile) {
+        int imax = std::min(ii + tile, matA->rows());
+        for (int jj = 0; jj < matA->cols(); jj += tile) {
+            int jmax = std::min(jj + tile, matA->cols());
+            for (int i = ii; i < imax; i++) {
+                const float *src = matA->data + (size_t)i * matA->ld;
+                for (int j = jj; j < jmax; j++) {
+                    t->data[(size_t)j * t->ld + i] = src[j];
+                }
+            }
         }
     }
     
@@ -54,8 +125,11 @@ Matrix* Matrix::add(const Matrix *matA,
     
     Matrix * sum = new Matrix(matA->rows(), matA->cols());
     for (int i = 0; i < matA->rows(); i++) {
+        const float *ra = matA->data + (size_t)i * matA->ld;
+        const float *rb = matB->data + (size_t)i * matB->ld;
+        float *rs = sum->data + (size_t)i * sum->ld;
         for (int j = 0; j < matA->cols(); j++) {
-            sum->set(i, j, matA->get(i, j) + matB->get(i, j));
+            rs[j] = ra[j] + rb[j];
         }
     }
     
@@ -68,31 +142,95 @@ Matrix* Matrix::multiply(const Matrix *matA,
         throw "Matrices do not match";
     
     Matrix * prod = new Matrix(matA->rows(), matB->cols());
-    for (int i = 0; i < matA->rows(); i++) {
-        for (int j = 0; j < matB->cols(); j++) {
-            float element = 0;
-            for (int k = 0; k < matA->cols(); k++) {
-                element += matA->get(i, k) * matB->get(k, j);
-            }
-            prod->set(i, j, element);
-        }
-    }
+    MatrixMultiplier::gemm(false, false,
+                           matA->rows(), matB->cols(), matA->cols(),
+                           1.0f, matA->data, matA->ld, matB->data, matB->ld,
+                           0.0f, prod->data, prod->ld);
+    
+    return prod;
+    
+}
+
+Matrix* Matrix::multiplyTransposeA(const Matrix *matA,
+                                   const Matrix *matB) {
+    if (matA->rows() != matB->rows())
+        throw "Matrices do not match";
+    
+    Matrix * prod = new Matrix(matA->cols(), matB->cols());
+    MatrixMultiplier::gemm(true, false,
+                           matA->cols(), matB->cols(), matA->rows(),
+                           1.0f, matA->data, matA->ld, matB->data, matB->ld,
+                           0.0f, prod->data, prod->ld);
     
     return prod;
+}
+
+void Matrix::multiplyInto(const Matrix *matA,
+                          const Matrix *matB,
+                          Matrix *result) {
+    if (matA->cols() != matB->rows() ||
+        result->rows() != matA->rows() || result->cols() != matB->cols())
+        throw "Matrices do not match";
     
+    MatrixMultiplier::gemm(false, false,
+                           matA->rows(), matB->cols(), matA->cols(),
+                           1.0f, matA->data, matA->ld, matB->data, matB->ld,
+                           0.0f, result->data, result->ld);
+}
+
+Matrix* Matrix::gram(const Matrix *matA) {
+    int n = matA->cols();
+    Matrix * g = new Matrix(n, n);
+    MatrixMultiplier::syrk(n, matA->rows(), 1.0f, matA->data, matA->ld,
+                           0.0f, g->data, g->ld);
+    MatrixMultiplier::symmetrize(n, g->data, g->ld);
+    
+    return g;
+}
+
+Matrix* Matrix::gram(const Matrix *matA,
+                     const Matrix *previous) {
+    int n = matA->cols();
+    int p = previous->rows();
+    if (previous->cols() != p || p > n)
+        throw "Matrices do not match";
+    
+    Matrix * g = new Matrix(n, n);
+    for (int i = 0; i < p; i++)
+        memcpy(g->data + (size_t)i * g->ld,
+               previous->data + (size_t)i * previous->ld,
+               p * sizeof(float));
+    MatrixMultiplier::syrk(n, matA->rows(), 1.0f, matA->data, matA->ld,
+                           0.0f, g->data, g->ld, p);
+    MatrixMultiplier::symmetrize(n, g->data, g->ld);
+    
+    return g;
 }
 
 Matrix* Matrix::multiply(float mult,
                          const Matrix *mat) {
     Matrix * prod = new Matrix(mat->rows(), mat->cols());
     for (int i = 0; i < mat->rows(); i++) {
+        const float *src = mat->data + (size_t)i * mat->ld;
+        float *dst = prod->data + (size_t)i * prod->ld;
         for (int j = 0; j < mat->cols(); j++) {
-            prod->set(i, j, mult * mat->get(i,j));
+            dst[j] = mult * src[j];
         }
     }
     return prod;
 }
 
+void Matrix::copyInto(const Matrix *matA, Matrix *result) {
+    if (matA->cols() != result->cols() || matA->rows() != result->rows())
+        throw "Matrices do not match";
+    
+    for (int i = 0; i < matA->rows(); i++) {
+        memcpy(result->data + (size_t)i * result->ld,
+               matA->data + (size_t)i * matA->ld,
+               matA->cols() * sizeof(float));
+    }
+}
+
 const Matrix* Matrix::outerProduct(const ColumnVector *u,
                                    const ColumnVector *v) {
     Matrix * oProd = new Matrix(u->rows(),v->rows());
@@ -113,8 +251,11 @@ Matrix* Matrix::subtract(const Matrix *matA,
     
     Matrix * diff = new Matrix(matA->rows(), matA->cols());
     for (int i = 0; i < matA->rows(); i++) {
+        const float *ra = matA->data + (size_t)i * matA->ld;
+        const float *rb = matB->data + (size_t)i * matB->ld;
+        float *rd = diff->data + (size_t)i * diff->ld;
         for (int j = 0; j < matA->cols(); j++) {
-            diff->set(i, j, matA->get(i, j) - matB->get(i, j));
+            rd[j] = ra[j] - rb[j];
         }
     }
     
@@ -138,9 +279,14 @@ ColumnVector* Matrix::subtract(const ColumnVector *matA,
 
 Matrix* Matrix::copyOf(const Matrix *matA) {
     Matrix *copy = new Matrix(matA->rows(), matA->cols());
-    for (int i = 0; i < matA->rows(); i++) {
-        for (int j = 0; j < matA->cols(); j++) {
-            copy->set(i, j, matA->get(i, j));
+    if (matA->ld == matA->cols()) {
+        memcpy(copy->data, matA->data,
+               (size_t)matA->rows() * matA->cols() * sizeof(float));
+    } else {
+        for (int i = 0; i < matA->rows(); i++) {
+            memcpy(copy->data + (size_t)i * copy->ld,
+                   matA->data + (size_t)i * matA->ld,
+                   matA->cols() * sizeof(float));
         }
     }
     return copy;
@@ -149,9 +295,9 @@ Matrix* Matrix::copyOf(const Matrix *matA) {
 ColumnVector* Matrix::column(const Matrix *matA) {
     ColumnVector *column = new ColumnVector(matA->rows() * matA->cols());
     for (int i = 0; i < matA->rows(); i++) {
-        for (int j = 0; j < matA->cols(); j++) {
-            column->set(i * matA->cols() + j, matA->get(i, j));
-        }
+        memcpy(column->data + (size_t)i * matA->cols(),
+               matA->data + (size_t)i * matA->ld,
+               matA->cols() * sizeof(float));
     }
     return column;
 }
@@ -186,6 +332,9 @@ float Matrix::dotProduct(const ColumnVector *u,
     if (u->rows() != v->rows())
         throw "Vectors do not match";
     
+    if (u->stride() == 1 && v->stride() == 1)
+        return MatrixMultiplier::dot(u->rows(), u->getData(), v->getData());
+    
     float dot = 0;
     for (int i = 0; i < u->rows(); i++) {
         dot += u->get(i) * v->get(i);
@@ -202,8 +351,11 @@ const Matrix* Matrix::mask(const Matrix *matA,
     
     Matrix * masked = new Matrix(matA->rows(), matA->cols());
     for (int i = 0; i < matA->rows(); i++) {
+        const float *ra = matA->data + (size_t)i * matA->ld;
+        const float *rm = mask->data + (size_t)i * mask->ld;
+        float *rd = masked->data + (size_t)i * masked->ld;
         for (int j = 0; j < matA->cols(); j++) {
-            masked->set(i, j, matA->get(i, j) * mask->get(i, j));
+            rd[j] = ra[j] * rm[j];
         }
     }
     
@@ -218,19 +370,37 @@ int Matrix::rows() const {
     return nbRows;
 }
 
-float Matrix::get(int theRow, int theCol) const {
-    return a[theRow][theCol];
-}
-
 ColumnVector* Matrix::getColumn(int theCol) const {
     ColumnVector* col = new ColumnVector(nbRows);
+    const float *src = data + theCol;
     for (int i = 0; i < nbRows; i++)
-        col->set(i, a[i][theCol]);
+        col->data[i] = src[(size_t)i * ld];
     return col;
 }
 
+ColumnVector* Matrix::columnView(int theCol) const {
+    return new ColumnVector(nbRows, data + theCol, ld);
+}
+
 float** Matrix::getArray() const {
-    return a;
+    if (rowPtrs == NULL) {
+        rowPtrs = new float*[nbRows > 0 ? nbRows : 1];
+        for (int i = 0; i < nbRows; i++)
+            rowPtrs[i] = data + (size_t)i * ld;
+    }
+    return rowPtrs;
+}
+
+float* Matrix::getData() const {
+    return data;
+}
+
+int Matrix::stride(void) const {
+    return ld;
+}
+
+bool Matrix::ownsData(void) const {
+    return owner;
 }
 
 float Matrix::norm1() const {
@@ -239,8 +409,9 @@ float Matrix::norm1() const {
     
     for (int i = 0; i < nbRows; i++) {
         current = 0;
+        const float *row = data + (size_t)i * ld;
         for (int j = 0; j < nbCols; j++) {
-            current += std::abs(a[i][j]);
+            current += std::abs(row[j]);
         }
         if (current > norm)
             norm = current;
@@ -256,7 +427,7 @@ float Matrix::normInf() const {
     for (int j = 0; j < nbCols; j++) {
         current = 0;
         for (int i = 0; i < nbRows; i++) {
-            current += std::abs(a[i][j]);
+            current += std::abs(data[(size_t)i * ld + j]);
         }
         if (current > norm)
             norm = current;
@@ -265,72 +436,90 @@ float Matrix::normInf() const {
     return norm;
 }
 
-void Matrix::set(int theRow, int theCol, float theVal) {
-    a[theRow][theCol] = theVal;
+void Matrix::scaleInPlace(float mult) {
+    for (int i = 0; i < nbRows; i++) {
+        float *row = data + (size_t)i * ld;
+        for (int j = 0; j < nbCols; j++) {
+            row[j] *= mult;
+        }
+    }
 }
 
-void Matrix::addRow(const RowVector *row) {
-    if (row->cols() != nbCols)
+void Matrix::axpy(float alpha, const Matrix *matX) {
+    if (matX->cols() != nbCols || matX->rows() != nbRows)
         throw "Matrices do not match";
     
-    float **newa = new float*[nbRows+1];
     for (int i = 0; i < nbRows; i++) {
-        newa[i] = new float[nbCols];
+        float *row = data + (size_t)i * ld;
+        const float *rx = matX->data + (size_t)i * matX->ld;
         for (int j = 0; j < nbCols; j++) {
-            newa[i][j] = a[i][j];
+            row[j] += alpha * rx[j];
         }
     }
-    newa[nbRows] = new float[nbCols];
+}
+
+void Matrix::addRow(const RowVector *row) {
+    if (row->cols() != nbCols)
+        throw "Matrices do not match";
+    
+    // Grow geometrically so that building a matrix row by row is linear
+    if (nbRows == capRows)
+        reallocate(capRows < 4 ? 4 : 2 * capRows, ld);
+    
+    float *dst = data + (size_t)nbRows * ld;
     for (int j = 0; j < nbCols; j++) {
-        newa[nbRows][j] = row->get(j);
+        dst[j] = row->get(j);
     }
     
     nbRows += 1;
-    this->a = newa;
-    
+    invalidateRowPtrs();
 }
 
 void Matrix::addColumn(const ColumnVector *col) {
     if (col->rows() != nbRows)
         throw "Matrices do not match";
     
-    float **newa = new float*[nbRows];
+    // Spare room at the end of each row absorbs later columns
+    if (nbCols == ld)
+        reallocate(capRows, ld < 4 ? 4 : 2 * ld);
+    
     for (int i = 0; i < nbRows; i++) {
-        newa[i] = new float[nbCols+1];
-        for (int j = 0; j < nbCols; j++) {
-            newa[i][j] = a[i][j];
-        }
-        newa[i][nbCols] = col->get(i);
+        data[(size_t)i * ld + nbCols] = col->get(i);
     }
     
     nbCols += 1;
-    this->a = newa;
-    
 }
 
 const RowVector* Matrix::averageRow(void) const {
     RowVector *ave = new RowVector(nbCols);
-    for (int j = 0; j < nbCols; j++) {
-        float e = 0;
-        for (int i = 0; i < nbRows; i++) {
-            e += a[i][j];
+    float *sum = ave->data;
+    for (int i = 0; i < nbRows; i++) {
+        const float *row = data + (size_t)i * ld;
+        for (int j = 0; j < nbCols; j++) {
+            sum[j] += row[j];
         }
-        e /= nbRows;
-        ave->set(j, e);
+    }
+    for (int j = 0; j < nbCols; j++) {
+        sum[j] /= nbRows;
     }
     return ave;
 }
 
 const ColumnVector* Matrix::averageColumn(void) const {
     ColumnVector *ave = new ColumnVector(nbRows);
-    for (int i = 0; i < nbRows; i++) {
-        float e = 0;
-        for (int j = 0; j < nbCols; j++) {
-            e += a[i][j];
+    // Rows are independent; share them out once there is enough to add
+    int grain = (size_t)nbRows * nbCols < (1 << 20) ? nbRows : 0;
+    TaskScheduler::parallelFor(0, nbRows, grain, [&](int i0, int i1) {
+        for (int i = i0; i < i1; i++) {
+            const float *row = data + (size_t)i * ld;
+            float e = 0;
+            for (int j = 0; j < nbCols; j++) {
+                e += row[j];
+            }
+            e /= nbCols;
+            ave->set(i, e);
         }
-        e /= nbCols;
-        ave->set(i, e);
-    }
+    });
     return ave;
     
 }
@@ -401,64 +590,60 @@ float Matrix::eigenvalue(const ColumnVector *init, int kmax, float tol) const {
 }
 
 void Matrix::swapRows(int r1, int r2) {
+    float *row1 = data + (size_t)r1 * ld;
+    float *row2 = data + (size_t)r2 * ld;
     for (int i = 0; i < nbCols; i++){
         float temp;
-        temp = a[r2][i];
-        a[r2][i] = a[r1][i];
-        a[r1][i] = temp;
+        temp = row2[i];
+        row2[i] = row1[i];
+        row1[i] = temp;
     }
 }
 
 void Matrix::setMatrix(float ** a) {
-    this->a = a;
+    for (int i = 0; i < nbRows; i++) {
+        memcpy(data + (size_t)i * ld, a[i], nbCols * sizeof(float));
+        delete [] a[i];
+    }
+    delete [] a;
 }
 
 void Matrix::transpose() {
-    float ** b = new float*[nbCols];
-    for (int i = 0; i < nbCols; i++)
-        b[i] = new float[nbRows];
+    if (!owner)
+        throw "Cannot resize a matrix view";
+    
+    float *b = allocate((size_t)nbRows * nbCols);
     
     for (int i = 0; i < nbRows; i++) {
+        const float *row = data + (size_t)i * ld;
         for (int j = 0; j < nbCols; j++) {
-            b[j][i] = a[i][j];
+            b[(size_t)j * nbRows + i] = row[j];
         }
     }
+    free(data);
+    
     int temp = nbRows;
     nbRows = nbCols;
     nbCols = temp;
     
-    a = b;
-    
+    data = b;
+    ld = nbCols;
+    capRows = nbRows;
+    invalidateRowPtrs();
 }
 
 char* Matrix::toString(const char* theBeginArrayStr,
                        const char* theEndArrayStr,
                        const char* theElmtSepStr,
                        bool theEolAtEor) const {
-    char *str = (char *)malloc(9*nbRows*nbCols*sizeof(char)+
-                               nbCols*nbRows*sizeof(theElmtSepStr)+
-                               (nbCols+1)*sizeof(theBeginArrayStr)+
-                               (nbCols+1)*sizeof(theEndArrayStr));
-    strcpy(str, theBeginArrayStr);
-    char current[50] = "initialize";
-    for (int i = 0; i < nbRows; i++) {
-        strcat(str, theBeginArrayStr);
-        for (int j = 0; j < nbCols; j++) {
-            sprintf(current, "%f", a[i][j]);
-            strcat(str, current);
-            if(j < nbCols-1)
-                strcat(str, theElmtSepStr);
-        }
-        strcat(str, theEndArrayStr);
-        if (i < nbRows-1) {
-            if (theEolAtEor)
-                strcat(str, "\n");
-            else
-                strcat(str, theElmtSepStr);
-        }
-        
-    }
-    strcat(str, theEndArrayStr);
+    MatrixWriter writer(theBeginArrayStr, theEndArrayStr, theElmtSepStr,
+                        theEolAtEor);
+    size_t length = writer.length(this);
+    char *str = (char *)malloc(length + 1);
+    if (str == NULL)
+        throw "Out of memory";
+    writer.write(str, length, this);
+    str[length] = '\0';
     
     return str;
 }
\ No newline at end of file
@@ -17,143 +17,132 @@ using namespace csc450Lib_linalg_base;
  * @return an identity matrix with n rows and n columns
  */
 Matrix* MatrixGenerator::getIdentity(int n){
-    float **element = new float*[n];
+    Matrix *element = new Matrix(n,n);
     for (int i=0; i<n; i++){
-        element[i] = new float[n];
-        element[i][i] = 1;
+        element->set(i,i,1);
     }
-    return new Matrix(n,n,element);
+    return element;
 }
 
 
 Matrix* MatrixGenerator::getRandom(int m, int n){
-    float **element = new float*[n];
+    Matrix *element = new Matrix(m,n);
     for(int i=0; i<m; i++){
-        element[i] = new float[n];
         for(int j=0; j<n; j++){
-            element[i][j] = (rand() % 1000) / 1000.0f;
+            element->set(i,j,(rand() % 1000) / 1000.0f);
         }
     }
-    return new Matrix(m,n,element);
+    return element;
 }
 
 
 Matrix* MatrixGenerator::getRandomSymmetric(int n){
-    float **element = new float*[n];
+    Matrix *element = new Matrix(n,n);
     for(int i=0; i<n; i++){
-        element[i] = new float[n];
         for(int j=i; j<n; j++){
-            element[i][j] = (rand() % 1000) / 1000.0f;
+            element->set(i,j,(rand() % 1000) / 1000.0f);
             if(i!=j){
-                element[j][i] = element[i][j];
+                element->set(j,i,element->get(i,j));
             }
         }
     }
-    return new Matrix(n,n,element);
+    return element;
 }
 
 
 Matrix* MatrixGenerator::getRandomUpperDiagonal(int n){
-    float **element = new float*[n];
+    Matrix *element = new Matrix(n,n);
     for(int i=0; i<n; i++){
-        element[i] = new float[n];
         for(int j=i; j<n; j++){
-            element[i][j] = (rand() % 1000) / 1000.0f;
+            element->set(i,j,(rand() % 1000) / 1000.0f);
             if(i!=j){
-                element[j][i] = 0;
+                element->set(j,i,0);
             }
         }
     }
-    return new Matrix(n,n,element);
+    return element;
 }
 
 Matrix* MatrixGenerator::getRandomLowerDiagonal(int n){
-    float **element = new float*[n];
+    Matrix *element = new Matrix(n,n);
     for(int i=0; i<n; i++){
-        element[i] = new float[n];
         for(int j=0; j<=i; j++){
-            element[i][j] = (rand() % 1000) / 1000.0f;
+            element->set(i,j,(rand() % 1000) / 1000.0f);
         }
     }
-    return new Matrix(n,n,element);
+    return element;
 }
 
 Matrix* MatrixGenerator::getRandomLowerUnitDiagonal(int n){
-    float **element = new float*[n];
+    Matrix *element = new Matrix(n,n);
     for(int i=0; i<n; i++){
-        element[i] = new float[n];
         for(int j=0; j<=i; j++){
             if(i!=j){
-                element[i][j] = (rand() % 1000) / 1000.0f;
+                element->set(i,j,(rand() % 1000) / 1000.0f);
             }
             else{
-                element[i][j] = 1;
+                element->set(i,j,1);
             }
         }
     }
-    return new Matrix(n,n,element);
+    return element;
 }
 
 
 
 Matrix* MatrixGenerator::getSquareDiagonal(int n, float *d){
-    float **element = new float*[n];
+    Matrix *element = new Matrix(n,n);
     for(int i=0; i<n; i++){
-        element[i] = new float[n];
         for(int j=0; j<n; j++){
             if(i==j){
-                element[i][j] = d[i];
+                element->set(i,j,d[i]);
             }
             else{
-                element[i][j] = 0;
+                element->set(i,j,0);
             }
         }
     }
-    return new Matrix(n,n,element);
+    return element;
 }
 
 
 Matrix* MatrixGenerator::getRandomHessenberg(int n){
     Matrix *A = MatrixGenerator::getRandomUpperDiagonal(n);
-    float **a = A->getArray();
     for(int i=1; i<n; i++){
-        a[i][i-1] = (rand() % 1000) / 1000.0f;
+        A->set(i,i-1,(rand() % 1000) / 1000.0f);
     }
-    return new Matrix(n,n,a);
+    return A;
     
 }
 
 Matrix* MatrixGenerator::getHilbert(int n){
-    float **h = new float*[n];
+    Matrix *h = new Matrix(n,n);
     for(int i=0; i<n; i++){
-        h[i] = new float[n];
         for(int j=0; j<n; j++){
-            h[i][j] = 1.0f/(i+j+1.0f);
+            h->set(i,j,1.0f/(i+j+1.0f));
         }
     }
-    return new Matrix(n,n,h);
+    return h;
 }
 
 Matrix* MatrixGenerator::getPolynomial(int n, float *xs) {
-    float **element = new float*[n];
+    Matrix *element = new Matrix(n,n);
     for(int i=0; i<n; i++){
-        element[i] = new float[n];
         for(int j=0; j<n; j++){
-            element[i][j] = pow(xs[i],j);
+            element->set(i,j,pow(xs[i],j));
         }
     }
-    return new Matrix(n,n,element);
+    return element;
 }
 
 Matrix* MatrixGenerator::getPolynomial(int n, ColumnVector *xs) {
-    float **element = new float*[n];
+    Matrix *element = new Matrix(n,n);
     for(int i=0; i<n; i++){
-        element[i] = new float[n];
         for(int j=0; j<n; j++){
-            element[i][j] = pow(xs->get(i),j);
+            element->set(i,j,pow(xs->get(i),j));
         }
     }
-    return new Matrix(n,n,element);
+    return element;
 }
 
 Matrix* MatrixGenerator::getRandomPolynomial(int n, float L) {
@@ -163,14 +152,13 @@ Matrix* MatrixGenerator::getRandomPolynomial(int n, float L) {
         xs[i] = L * i / (float)n;
     }
     
-    float **element = new float*[n];
+    Matrix *element = new Matrix(n,n);
     for(int i=0; i<n; i++){
-        element[i] = new float[n];
         for(int j=0; j<n; j++){
-            element[i][j] = pow(xs[i],j);
+            element->set(i,j,pow(xs[i],j));
         }
     }
-    return new Matrix(n,n,element);
+    return element;
 }
 
 Matrix* MatrixGenerator::getTrigonometric(int n, float L) {
@@ -179,18 +167,17 @@ Matrix* MatrixGenerator::getTrigonometric(int n, float L) {
         xs[j] = (float)(j * L) / (float)(2 * n + 1);
     }
     
-    float **element = new float*[2 * n + 1];
+    Matrix *element = new Matrix(2 * n + 1, 2 * n + 1);
     for (int i = 0; i <= 2 * n; i++) {
-        element[i] = new float[2 * n + 1];
-        element[i][0] = 1;
+        element->set(i,0,1);
         for (int k = 1; k <= n; k++) {
-           element[i][k] = cos(2 * k * M_PI * xs[i] / L);
+           element->set(i,k,cos(2 * k * M_PI * xs[i] / L));
         }
         for (int k = 1; k <= n; k++) {
-           element[i][n + k] = sin(2 * k * M_PI * xs[i] / L);
+           element->set(i,n + k,sin(2 * k * M_PI * xs[i] / L));
         }
     }
-    return new Matrix(2 * n + 1, 2 * n + 1, element);
+    return element;
 }
 
 ColumnVector* MatrixGenerator::getUniformSample(int n, float L) {
@@ -222,6 +209,14 @@ RowVector* MatrixGenerator::getRandomRow(int n) {
     return new RowVector(n,element);
 }
 
+void MatrixGenerator::randomize(Matrix *mat) {
+    for(int i=0; i<mat->rows(); i++){
+        for(int j=0; j<mat->cols(); j++){
+            mat->set(i,j,(rand() % 1000) / 1000.0f);
+        }
+    }
+}
+
 void MatrixGenerator::seed() {
     srand(time(NULL));
 }
@@ -0,0 +1,625 @@
+//
+//  MatrixMultiplier.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include "MatrixMultiplier.h"
+#include "TaskScheduler.h"
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MATRIXMULTIPLIER_X86
+#endif
+
+using namespace csc450Lib_linalg_base;
+
+namespace {
+
+    /**
+     * Computes C += alpha * Ap * Bp for one MR x NR tile of C, where Ap is a
+     *  packed MR x kc sliver of A and Bp a packed kc x NR sliver of B
+     */
+    typedef void (*MicroKernel)(int kc, const float *ap, const float *bp,
+                                float *c, int ldc, float alpha);
+
+    typedef float (*DotKernel)(int n, const float *x, const float *y);
+
+    struct KernelInfo {
+        const char *name;
+        int mr;
+        int nr;
+        MicroKernel kernel;
+        DotKernel dot;
+    };
+
+    // Cache blocking, in floats: a KC x NR sliver of B stays in L1, an
+    //  MC x KC block of A in L2 and a KC x NC panel of B in L3
+    const int KC = 256;
+    const int MC = 120;
+    const int NC = 4096;
+
+    // Width of the column panels of C that SYRK hands out to threads
+    const int SYRK_PANEL = 512;
+
+    // Products are split into tasks only when there are this many
+    //  multiply-adds to share, so that small problems stay serial
+    const double PARALLEL_WORK = 1 << 20;
+
+    // Largest tile of any micro-kernel, for the edge scratch buffer
+    const int MAX_TILE = 12 * 32;
+
+    // Triangular solves with this few rows are done directly
+    const int TRSM_LEAF = 32;
+
+    // Columns of the right-hand side per task in a direct triangular solve
+    const int TRSM_COLUMNS = 256;
+
+    void kernelGeneric(int kc, const float *ap, const float *bp,
+                       float *c, int ldc, float alpha) {
+        float acc[4][8];
+        memset(acc, 0, sizeof(acc));
+        for (int p = 0; p < kc; p++) {
+            for (int r = 0; r < 4; r++) {
+                float ar = ap[r];
+                for (int j = 0; j < 8; j++)
+                    acc[r][j] += ar * bp[j];
+            }
+            ap += 4;
+            bp += 8;
+        }
+        for (int r = 0; r < 4; r++)
+            for (int j = 0; j < 8; j++)
+                c[(size_t)r * ldc + j] += alpha * acc[r][j];
+    }
+
+    float dotGeneric(int n, const float *x, const float *y) {
+        float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        int i = 0;
+        for (; i + 4 <= n; i += 4) {
+            s0 += x[i] * y[i];
+            s1 += x[i+1] * y[i+1];
+            s2 += x[i+2] * y[i+2];
+            s3 += x[i+3] * y[i+3];
+        }
+        for (; i < n; i++)
+            s0 += x[i] * y[i];
+        return (s0 + s1) + (s2 + s3);
+    }
+
+#ifdef MATRIXMULTIPLIER_X86
+    // 6 x 16 tile: twelve ymm accumulators, two for B, one broadcast of A
+    __attribute__((target("avx2,fma")))
+    void kernelAvx2(int kc, const float *ap, const float *bp,
+                    float *c, int ldc, float alpha) {
+        __m256 acc[6][2];
+#pragma GCC unroll 6
+        for (int r = 0; r < 6; r++) {
+            acc[r][0] = _mm256_setzero_ps();
+            acc[r][1] = _mm256_setzero_ps();
+        }
+        for (int p = 0; p < kc; p++) {
+            __m256 b0 = _mm256_loadu_ps(bp);
+            __m256 b1 = _mm256_loadu_ps(bp + 8);
+#pragma GCC unroll 6
+            for (int r = 0; r < 6; r++) {
+                __m256 ar = _mm256_broadcast_ss(ap + r);
+                acc[r][0] = _mm256_fmadd_ps(ar, b0, acc[r][0]);
+                acc[r][1] = _mm256_fmadd_ps(ar, b1, acc[r][1]);
+            }
+            ap += 6;
+            bp += 16;
+        }
+        __m256 va = _mm256_set1_ps(alpha);
+#pragma GCC unroll 6
+        for (int r = 0; r < 6; r++) {
+            float *cr = c + (size_t)r * ldc;
+            _mm256_storeu_ps(cr, _mm256_fmadd_ps(va, acc[r][0],
+                                                 _mm256_loadu_ps(cr)));
+            _mm256_storeu_ps(cr + 8, _mm256_fmadd_ps(va, acc[r][1],
+                                                     _mm256_loadu_ps(cr + 8)));
+        }
+    }
+
+    __attribute__((target("avx2,fma")))
+    float dotAvx2(int n, const float *x, const float *y) {
+        __m256 s0 = _mm256_setzero_ps();
+        __m256 s1 = _mm256_setzero_ps();
+        int i = 0;
+        for (; i + 16 <= n; i += 16) {
+            s0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i),
+                                 _mm256_loadu_ps(y + i), s0);
+            s1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8),
+                                 _mm256_loadu_ps(y + i + 8), s1);
+        }
+        s0 = _mm256_add_ps(s0, s1);
+        __m128 h = _mm_add_ps(_mm256_castps256_ps128(s0),
+                              _mm256_extractf128_ps(s0, 1));
+        h = _mm_add_ps(h, _mm_movehl_ps(h, h));
+        h = _mm_add_ss(h, _mm_shuffle_ps(h, h, 1));
+        float s = _mm_cvtss_f32(h);
+        for (; i < n; i++)
+            s += x[i] * y[i];
+        return s;
+    }
+
+    // 12 x 32 tile: twenty-four zmm accumulators out of thirty-two
+    __attribute__((target("avx512f")))
+    void kernelAvx512(int kc, const float *ap, const float *bp,
+                      float *c, int ldc, float alpha) {
+        __m512 acc[12][2];
+#pragma GCC unroll 12
+        for (int r = 0; r < 12; r++) {
+            acc[r][0] = _mm512_setzero_ps();
+            acc[r][1] = _mm512_setzero_ps();
+        }
+        for (int p = 0; p < kc; p++) {
+            __m512 b0 = _mm512_loadu_ps(bp);
+            __m512 b1 = _mm512_loadu_ps(bp + 16);
+#pragma GCC unroll 12
+            for (int r = 0; r < 12; r++) {
+                __m512 ar = _mm512_set1_ps(ap[r]);
+                acc[r][0] = _mm512_fmadd_ps(ar, b0, acc[r][0]);
+                acc[r][1] = _mm512_fmadd_ps(ar, b1, acc[r][1]);
+            }
+            ap += 12;
+            bp += 32;
+        }
+        __m512 va = _mm512_set1_ps(alpha);
+#pragma GCC unroll 12
+        for (int r = 0; r < 12; r++) {
+            float *cr = c + (size_t)r * ldc;
+            _mm512_storeu_ps(cr, _mm512_fmadd_ps(va, acc[r][0],
+                                                 _mm512_loadu_ps(cr)));
+            _mm512_storeu_ps(cr + 16, _mm512_fmadd_ps(va, acc[r][1],
+                                                      _mm512_loadu_ps(cr + 16)));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    float dotAvx512(int n, const float *x, const float *y) {
+        __m512 s0 = _mm512_setzero_ps();
+        __m512 s1 = _mm512_setzero_ps();
+        int i = 0;
+        for (; i + 32 <= n; i += 32) {
+            s0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i),
+                                 _mm512_loadu_ps(y + i), s0);
+            s1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16),
+                                 _mm512_loadu_ps(y + i + 16), s1);
+        }
+        float s = _mm512_reduce_add_ps(_mm512_add_ps(s0, s1));
+        for (; i < n; i++)
+            s += x[i] * y[i];
+        return s;
+    }
+#endif
+
+    KernelInfo detectKernel(void) {
+        KernelInfo generic = { "generic", 4, 8, kernelGeneric, dotGeneric };
+#ifdef MATRIXMULTIPLIER_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            KernelInfo info = { "avx512", 12, 32, kernelAvx512, dotAvx512 };
+            return info;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            KernelInfo info = { "avx2", 6, 16, kernelAvx2, dotAvx2 };
+            return info;
+        }
+#endif
+        return generic;
+    }
+
+    const KernelInfo& selectKernel(void) {
+        static const KernelInfo info = detectKernel();
+        return info;
+    }
+
+    float* allocatePanel(size_t n) {
+        void *p = NULL;
+        if (posix_memalign(&p, 64, n * sizeof(float)))
+            throw "Out of memory";
+        return (float*)p;
+    }
+
+    /**
+     * Packing buffer of at least n floats owned by the calling thread, so
+     *  that tasks do not allocate. Kernels do not nest, so a thread never
+     *  needs two of the same kind at once
+     */
+    struct ThreadPanel {
+        float *data;
+        size_t size;
+
+        ThreadPanel(void) : data(NULL), size(0) {}
+        ~ThreadPanel(void) { free(data); }
+
+        float* reserve(size_t n) {
+            if (n > size) {
+                free(data);
+                data = NULL;
+                size = 0;
+                data = allocatePanel(n);
+                size = n;
+            }
+            return data;
+        }
+    };
+
+    thread_local ThreadPanel panelA;
+    thread_local ThreadPanel panelB;
+
+    /**
+     * Copies the mc x kc block of op(A) at a into slivers of mr rows,
+     *  each stored column by column, padding the last sliver with zeros
+     */
+    void packA(bool trans, int mc, int kc, const float *a, int lda,
+               int mr, float *ap) {
+        for (int ir = 0; ir < mc; ir += mr) {
+            int rows = std::min(mr, mc - ir);
+            if (trans) {
+                for (int p = 0; p < kc; p++) {
+                    const float *src = a + (size_t)p * lda + ir;
+                    int r = 0;
+                    for (; r < rows; r++)
+                        ap[r] = src[r];
+                    for (; r < mr; r++)
+                        ap[r] = 0;
+                    ap += mr;
+                }
+            } else {
+                for (int r = 0; r < mr; r++) {
+                    if (r < rows) {
+                        const float *src = a + (size_t)(ir + r) * lda;
+                        for (int p = 0; p < kc; p++)
+                            ap[(size_t)p * mr + r] = src[p];
+                    } else {
+                        for (int p = 0; p < kc; p++)
+                            ap[(size_t)p * mr + r] = 0;
+                    }
+                }
+                ap += (size_t)kc * mr;
+            }
+        }
+    }
+
+    /**
+     * Copies the kc x nc block of op(B) at b into slivers of nr columns,
+     *  each stored row by row, padding the last sliver with zeros
+     */
+    void packB(bool trans, int kc, int nc, const float *b, int ldb,
+               int nr, float *bp) {
+        for (int jr = 0; jr < nc; jr += nr) {
+            int cols = std::min(nr, nc - jr);
+            if (trans) {
+                for (int j = 0; j < nr; j++) {
+                    if (j < cols) {
+                        const float *src = b + (size_t)(jr + j) * ldb;
+                        for (int p = 0; p < kc; p++)
+                            bp[(size_t)p * nr + j] = src[p];
+                    } else {
+                        for (int p = 0; p < kc; p++)
+                            bp[(size_t)p * nr + j] = 0;
+                    }
+                }
+                bp += (size_t)kc * nr;
+            } else {
+                for (int p = 0; p < kc; p++) {
+                    const float *src = b + (size_t)p * ldb + jr;
+                    int j = 0;
+                    for (; j < cols; j++)
+                        bp[j] = src[j];
+                    for (; j < nr; j++)
+                        bp[j] = 0;
+                    bp += nr;
+                }
+            }
+        }
+    }
+
+    /**
+     * Substitution for op(T) * X = B, for the columns [c0, c1) of B. Rows of
+     *  B are contiguous, so each step subtracts a multiple of a whole row
+     */
+    void trsmDirect(bool lower, bool transT, bool unitDiagonal, int m,
+                    const float *t, int ldt, float *b, int ldb,
+                    int c0, int c1) {
+        for (int s = 0; s < m; s++) {
+            int i = lower ? s : m - 1 - s;
+            int k0 = lower ? 0 : i + 1;
+            int k1 = lower ? i : m;
+            float *bi = b + (size_t)i * ldb;
+            for (int k = k0; k < k1; k++) {
+                float tik = transT ? t[(size_t)k * ldt + i]
+                                   : t[(size_t)i * ldt + k];
+                const float *bk = b + (size_t)k * ldb;
+                for (int c = c0; c < c1; c++)
+                    bi[c] -= tik * bk[c];
+            }
+            if (!unitDiagonal) {
+                float inv = 1.0f / t[(size_t)i * ldt + i];
+                for (int c = c0; c < c1; c++)
+                    bi[c] *= inv;
+            }
+        }
+    }
+
+    /**
+     * Substitution for op(T) * x = b with a single right-hand side: each
+     *  unknown is one dot product with a row (or column) of T
+     */
+    void trsvDirect(bool lower, bool transT, bool unitDiagonal, int m,
+                    const float *t, int ldt, float *b, int ldb) {
+        for (int s = 0; s < m; s++) {
+            int i = lower ? s : m - 1 - s;
+            int k0 = lower ? 0 : i + 1;
+            int k1 = lower ? i : m;
+            float val = b[(size_t)i * ldb];
+            if (transT) {
+                for (int k = k0; k < k1; k++)
+                    val -= t[(size_t)k * ldt + i] * b[(size_t)k * ldb];
+            } else {
+                const float *ti = t + (size_t)i * ldt;
+                for (int k = k0; k < k1; k++)
+                    val -= ti[k] * b[(size_t)k * ldb];
+            }
+            b[(size_t)i * ldb] = unitDiagonal
+                ? val : val / t[(size_t)i * ldt + i];
+        }
+    }
+
+    void runKernel(const KernelInfo &ki, int kc,
+                   const float *ap, const float *bp,
+                   float *c, int ldc, int mr, int nr, float alpha) {
+        if (mr == ki.mr && nr == ki.nr) {
+            ki.kernel(kc, ap, bp, c, ldc, alpha);
+            return;
+        }
+        // Partial tile: let the kernel write a full tile to scratch
+        float tile[MAX_TILE] __attribute__((aligned(64)));
+        memset(tile, 0, sizeof(float) * ki.mr * ki.nr);
+        ki.kernel(kc, ap, bp, tile, ki.nr, alpha);
+        for (int i = 0; i < mr; i++)
+            for (int j = 0; j < nr; j++)
+                c[(size_t)i * ldc + j] += tile[i * ki.nr + j];
+    }
+}
+
+void MatrixMultiplier::gemm(bool transA, bool transB,
+                            int m, int n, int k,
+                            float alpha,
+                            const float *a, int lda,
+                            const float *b, int ldb,
+                            float beta,
+                            float *c, int ldc) {
+    if (m <= 0 || n <= 0)
+        return;
+
+    // C = beta * C
+    if (beta != 1) {
+        for (int i = 0; i < m; i++) {
+            float *ci = c + (size_t)i * ldc;
+            if (beta == 0) {
+                memset(ci, 0, n * sizeof(float));
+            } else {
+                for (int j = 0; j < n; j++)
+                    ci[j] *= beta;
+            }
+        }
+    }
+
+    if (k <= 0 || alpha == 0)
+        return;
+
+    const KernelInfo &ki = selectKernel();
+
+    // Matrix-vector product with contiguous rows: packing would cost as
+    //  much as the product itself, so take dot products directly
+    if (n == 1 && !transA && (transB || ldb == 1)) {
+        for (int i = 0; i < m; i++)
+            c[(size_t)i * ldc] += alpha * ki.dot(k, a + (size_t)i * lda, b);
+        return;
+    }
+
+    int mcBlock = std::max(ki.mr, (MC / ki.mr) * ki.mr);
+    int ncBlock = std::min((NC / ki.nr) * ki.nr,
+                           ((n + ki.nr - 1) / ki.nr) * ki.nr);
+    int kcBlock = std::min(KC, k);
+
+    // The panel of B is shared by every task of a depth slice; each task
+    //  packs its own block of A and sweeps a group of slivers of B. It is
+    //  owned here, so that it is freed when a task throws
+    std::unique_ptr<float, void (*)(void*)> panel(allocatePanel((size_t)kcBlock * ncBlock),
+                                                  free);
+    float *bp = panel.get();
+    int numIc = (m + mcBlock - 1) / mcBlock;
+    bool parallel = (double)m * n * k >= PARALLEL_WORK
+        && TaskScheduler::threads() > 1;
+
+    for (int jc = 0; jc < n; jc += ncBlock) {
+        int nc = std::min(ncBlock, n - jc);
+        int numJr = (nc + ki.nr - 1) / ki.nr;
+        int groupsPerIc = 1;
+        if (parallel)
+            groupsPerIc = std::min(numJr, std::max(1, (4 * TaskScheduler::threads()
+                                                       + numIc - 1) / numIc));
+        int jrPerGroup = (numJr + groupsPerIc - 1) / groupsPerIc;
+        int numTasks = numIc * groupsPerIc;
+
+        for (int pc = 0; pc < k; pc += kcBlock) {
+            int kc = std::min(kcBlock, k - pc);
+
+            const float *bsrc = transB ? b + (size_t)jc * ldb + pc
+                                       : b + (size_t)pc * ldb + jc;
+            packB(transB, kc, nc, bsrc, ldb, ki.nr, bp);
+
+            auto work = [&](int t0, int t1) {
+                float *ap = panelA.reserve((size_t)mcBlock * kcBlock);
+                for (int t = t0; t < t1; t++) {
+                    int ic = (t / groupsPerIc) * mcBlock;
+                    int mc = std::min(mcBlock, m - ic);
+                    int jr0 = (t % groupsPerIc) * jrPerGroup * ki.nr;
+                    int jr1 = std::min(nc, jr0 + jrPerGroup * ki.nr);
+
+                    const float *asrc = transA ? a + (size_t)pc * lda + ic
+                                               : a + (size_t)ic * lda + pc;
+                    packA(transA, mc, kc, asrc, lda, ki.mr, ap);
+
+                    for (int jr = jr0; jr < jr1; jr += ki.nr) {
+                        for (int ir = 0; ir < mc; ir += ki.mr) {
+                            runKernel(ki, kc,
+                                      ap + (size_t)ir * kc,
+                                      bp + (size_t)jr * kc,
+                                      c + (size_t)(ic + ir) * ldc + jc + jr, ldc,
+                                      std::min(ki.mr, mc - ir),
+                                      std::min(ki.nr, nc - jr),
+                                      alpha);
+                        }
+                    }
+                }
+            };
+            TaskScheduler::parallelFor(0, numTasks, parallel ? 1 : numTasks,
+                                       work);
+        }
+    }
+}
+
+void MatrixMultiplier::syrk(int n, int k,
+                            float alpha,
+                            const float *a, int lda,
+                            float beta,
+                            float *c, int ldc,
+                            int from) {
+    from = std::max(from, 0);
+    if (n <= 0 || from >= n)
+        return;
+    
+    const KernelInfo &ki = selectKernel();
+    int mcBlock = std::max(ki.mr, (MC / ki.mr) * ki.mr);
+    int kcBlock = std::max(1, std::min(KC, k));
+    int numPanels = (n - from + SYRK_PANEL - 1) / SYRK_PANEL;
+    
+    // Each task takes column panels of C, packs the panel of A once per
+    //  depth slice and only sweeps the row blocks on or above the diagonal
+    auto work = [&](int t0, int t1) {
+        float *ap = panelA.reserve((size_t)mcBlock * kcBlock);
+        float *bp = panelB.reserve((size_t)kcBlock * SYRK_PANEL);
+        
+        for (int t = t0; t < t1; t++) {
+            int j0 = from + t * SYRK_PANEL;
+            int nc = std::min(SYRK_PANEL, n - j0);
+            int rowEnd = j0 + nc;
+            
+            // C = beta * C, over the rows this panel touches
+            for (int i = 0; i < rowEnd; i++) {
+                float *ci = c + (size_t)i * ldc + j0;
+                if (beta == 0) {
+                    memset(ci, 0, nc * sizeof(float));
+                } else if (beta != 1) {
+                    for (int j = 0; j < nc; j++)
+                        ci[j] *= beta;
+                }
+            }
+            if (alpha == 0)
+                continue;
+            
+            for (int pc = 0; pc < k; pc += kcBlock) {
+                int kc = std::min(kcBlock, k - pc);
+                packB(false, kc, nc, a + (size_t)pc * lda + j0, lda,
+                      ki.nr, bp);
+                
+                for (int ic = 0; ic < rowEnd; ic += mcBlock) {
+                    int mc = std::min(mcBlock, rowEnd - ic);
+                    packA(true, mc, kc, a + (size_t)pc * lda + ic, lda,
+                          ki.mr, ap);
+                    
+                    for (int jr = 0; jr < nc; jr += ki.nr) {
+                        int nr = std::min(ki.nr, nc - jr);
+                        for (int ir = 0; ir < mc; ir += ki.mr) {
+                            // Skip tiles wholly below the diagonal
+                            if (ic + ir > j0 + jr + nr - 1)
+                                break;
+                            runKernel(ki, kc,
+                                      ap + (size_t)ir * kc,
+                                      bp + (size_t)jr * kc,
+                                      c + (size_t)(ic + ir) * ldc + j0 + jr,
+                                      ldc,
+                                      std::min(ki.mr, mc - ir), nr,
+                                      alpha);
+                        }
+                    }
+                }
+            }
+        }
+    };
+    
+    double flops = (double)(n - from) * n * k;
+    TaskScheduler::parallelFor(0, numPanels,
+                               flops < PARALLEL_WORK ? numPanels : 1, work);
+}
+
+void MatrixMultiplier::trsm(bool upper, bool transT, bool unitDiagonal,
+                            int m, int n,
+                            const float *t, int ldt,
+                            float *b, int ldb) {
+    if (m <= 0 || n <= 0)
+        return;
+    
+    // Whether op(T) is lower triangular
+    bool lower = upper == transT;
+    
+    if (n == 1) {
+        trsvDirect(lower, transT, unitDiagonal, m, t, ldt, b, ldb);
+        return;
+    }
+    if (m <= TRSM_LEAF) {
+        TaskScheduler::parallelFor(0, n, TRSM_COLUMNS, [&](int c0, int c1) {
+            trsmDirect(lower, transT, unitDiagonal, m, t, ldt, b, ldb, c0, c1);
+        });
+        return;
+    }
+    
+    // op(T) = [T11 0; T21 T22] (or [T11 T12; 0 T22]): solve with the
+    //  diagonal block on the side that is ready, update the other half of
+    //  B with one GEMM, then solve with the other diagonal block
+    int m1 = m / 2;
+    int m2 = m - m1;
+    const float *t22 = t + (size_t)m1 * ldt + m1;
+    const float *off = lower != transT ? t + (size_t)m1 * ldt : t + m1;
+    float *b2 = b + (size_t)m1 * ldb;
+    if (lower) {
+        trsm(upper, transT, unitDiagonal, m1, n, t, ldt, b, ldb);
+        gemm(transT, false, m2, n, m1, -1.0f, off, ldt, b, ldb,
+             1.0f, b2, ldb);
+        trsm(upper, transT, unitDiagonal, m2, n, t22, ldt, b2, ldb);
+    } else {
+        trsm(upper, transT, unitDiagonal, m2, n, t22, ldt, b2, ldb);
+        gemm(transT, false, m1, n, m2, -1.0f, off, ldt, b2, ldb,
+             1.0f, b, ldb);
+        trsm(upper, transT, unitDiagonal, m1, n, t, ldt, b, ldb);
+    }
+}
+
+void MatrixMultiplier::symmetrize(int n, float *c, int ldc) {
+    for (int i = 1; i < n; i++) {
+        float *row = c + (size_t)i * ldc;
+        for (int j = 0; j < i; j++)
+            row[j] = c[(size_t)j * ldc + i];
+    }
+}
+
+float MatrixMultiplier::dot(int n, const float *x, const float *y) {
+    return selectKernel().dot(n, x, y);
+}
+
+const char* MatrixMultiplier::kernelName(void) {
+    return selectKernel().name;
+}
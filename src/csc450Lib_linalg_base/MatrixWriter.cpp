@@ -0,0 +1,203 @@
+//
+//  MatrixWriter.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#include "MatrixWriter.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+
+namespace {
+    
+    // Size of the formatting chunk
+    const size_t CHUNK = 1 << 16;
+    
+    // Longest text of one float, with room to spare
+    const size_t NUMBER = 48;
+    
+    /**
+     * Collects bytes in a chunk and hands full chunks to a sink
+     */
+    class ChunkBuffer {
+    private:
+        char data[CHUNK];
+        size_t used;
+        void (*sink)(void *context, const char *bytes, size_t n);
+        void *context;
+        
+    public:
+        ChunkBuffer(void (*sink)(void*, const char*, size_t), void *context)
+            : used(0), sink(sink), context(context) {}
+        
+        void flush(void) {
+            if (used > 0)
+                sink(context, data, used);
+            used = 0;
+        }
+        
+        void put(const char *bytes, size_t n) {
+            if (n > CHUNK - used) {
+                flush();
+                if (n > CHUNK) {
+                    sink(context, bytes, n);
+                    return;
+                }
+            }
+            memcpy(data + used, bytes, n);
+            used += n;
+        }
+        
+        void put(const string &s) {
+            put(s.data(), s.size());
+        }
+        
+        /** Returns room for at least NUMBER bytes, to be committed */
+        char* reserve(void) {
+            if (CHUNK - used < NUMBER)
+                flush();
+            return data + used;
+        }
+        
+        void commit(char *end) {
+            used = end - data;
+        }
+    };
+    
+    /** Writes the shortest round-trip text of value at p */
+    char* formatNumber(char *p, float value, bool mathematica) {
+        if (mathematica && !std::isfinite(value)) {
+            const char *name = std::isnan(value) ? "Indeterminate"
+                : value > 0 ? "Infinity" : "-Infinity";
+            size_t n = strlen(name);
+            memcpy(p, name, n);
+            return p + n;
+        }
+        char *end = std::to_chars(p, p + NUMBER, value).ptr;
+        if (mathematica) {
+            // Mathematica reads 1e-05 as 1 * e - 5; it wants 1*^-05
+            char *e = (char*)memchr(p, 'e', end - p);
+            if (e != NULL) {
+                char *exponent = e + 1;
+                if (*exponent == '+')
+                    exponent++;
+                size_t n = end - exponent;
+                memmove(e + 2, exponent, n);
+                e[0] = '*';
+                e[1] = '^';
+                end = e + 2 + n;
+            }
+        }
+        return end;
+    }
+    
+    void streamSink(void *context, const char *bytes, size_t n) {
+        ((ostream*)context)->write(bytes, n);
+    }
+    
+    struct BufferTarget {
+        char *buffer;
+        size_t capacity;
+        size_t total;
+    };
+    
+    void bufferSink(void *context, const char *bytes, size_t n) {
+        BufferTarget *target = (BufferTarget*)context;
+        if (target->total < target->capacity)
+            memcpy(target->buffer + target->total, bytes,
+                   std::min(n, target->capacity - target->total));
+        target->total += n;
+    }
+}
+
+MatrixWriter::MatrixWriter(MatrixFormat format) {
+    this->format = format;
+    this->mathematicaExponents = format == FORMAT_MATHEMATICA;
+    if (format == FORMAT_MATHEMATICA) {
+        this->beginArray = "{";
+        this->endArray = "}";
+        this->elementSeparator = ",";
+        this->eolAtEndOfRow = false;
+    } else {
+        this->elementSeparator = ",";
+        this->eolAtEndOfRow = true;
+    }
+}
+
+MatrixWriter::MatrixWriter(const char *theBeginArrayStr,
+                           const char *theEndArrayStr,
+                           const char *theElmtSepStr,
+                           bool theEolAtEor) {
+    this->format = FORMAT_MATHEMATICA;
+    this->mathematicaExponents = false;
+    this->beginArray = theBeginArrayStr;
+    this->endArray = theEndArrayStr;
+    this->elementSeparator = theElmtSepStr;
+    this->eolAtEndOfRow = theEolAtEor;
+}
+
+void MatrixWriter::emit(const Matrix *matrix,
+                        void (*sink)(void*, const char*, size_t),
+                        void *context) const {
+    ChunkBuffer out(sink, context);
+    int rows = matrix->rows();
+    int cols = matrix->cols();
+    const float *data = matrix->getData();
+    size_t ld = matrix->stride();
+    
+    if (format == FORMAT_BINARY) {
+        for (int i = 0; i < rows; i++)
+            out.put((const char*)(data + i * ld), cols * sizeof(float));
+        out.flush();
+        return;
+    }
+    
+    out.put(beginArray);
+    for (int i = 0; i < rows; i++) {
+        const float *row = data + i * ld;
+        out.put(beginArray);
+        for (int j = 0; j < cols; j++) {
+            char *p = out.reserve();
+            out.commit(formatNumber(p, row[j], mathematicaExponents));
+            if (j < cols - 1)
+                out.put(elementSeparator);
+        }
+        out.put(endArray);
+        if (i < rows - 1) {
+            if (eolAtEndOfRow)
+                out.put("\n", 1);
+            else
+                out.put(elementSeparator);
+        }
+    }
+    out.put(endArray);
+    if (format == FORMAT_CSV)
+        out.put("\n", 1);
+    out.flush();
+}
+
+void MatrixWriter::write(ostream &out, const Matrix *matrix) const {
+    emit(matrix, streamSink, &out);
+}
+
+size_t MatrixWriter::write(char *buffer, size_t capacity,
+                           const Matrix *matrix) const {
+    BufferTarget target = { buffer, capacity, 0 };
+    emit(matrix, bufferSink, &target);
+    return target.total;
+}
+
+size_t MatrixWriter::length(const Matrix *matrix) const {
+    if (format == FORMAT_BINARY)
+        return (size_t)matrix->rows() * matrix->cols() * sizeof(float);
+    return write(NULL, 0, matrix);
+}
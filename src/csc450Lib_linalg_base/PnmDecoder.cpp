@@ -0,0 +1,131 @@
+//
+//  PnmDecoder.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <ctype.h>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "PnmDecoder.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+
+namespace {
+
+    /**
+     * Reads the header fields and plain samples of a Netpbm file: decimal
+     *  numbers separated by whitespace, with comments from '#' to the end
+     *  of the line
+     */
+    class TokenReader {
+    private:
+        const unsigned char *file;
+        size_t length;
+
+    public:
+        size_t pos;
+
+        TokenReader(const unsigned char *file, size_t length, size_t pos)
+            : file(file), length(length), pos(pos) {}
+
+        /** Returns the next number, or -1 if there is none */
+        int read(void) {
+            while (pos < length) {
+                if (file[pos] == '#') {
+                    while (pos < length && file[pos] != '\n')
+                        pos++;
+                } else if (isspace(file[pos])) {
+                    pos++;
+                } else {
+                    break;
+                }
+            }
+            if (pos >= length || !isdigit(file[pos]))
+                return -1;
+            int value = 0;
+            while (pos < length && isdigit(file[pos]) && value < 1 << 24)
+                value = value * 10 + (file[pos++] - '0');
+            return value;
+        }
+    };
+}
+
+unsigned char* PnmDecoder::decode(const string &filename,
+                                  int *width, int *height) {
+    ifstream input(filename, ios::binary);
+    if (!input.good())
+        return NULL;
+    vector<unsigned char> file((istreambuf_iterator<char>(input)),
+                               istreambuf_iterator<char>());
+    input.close();
+    return decode(file.data(), file.size(), width, height);
+}
+
+unsigned char* PnmDecoder::decode(const unsigned char *file, size_t length,
+                                  int *width, int *height) {
+    if (length < 3 || file[0] != 'P')
+        return NULL;
+    char kind = file[1];
+    if (kind != '2' && kind != '3' && kind != '5' && kind != '6')
+        return NULL;
+    bool color = kind == '3' || kind == '6';
+    bool plain = kind == '2' || kind == '3';
+
+    TokenReader reader(file, length, 2);
+    int w = reader.read();
+    int h = reader.read();
+    int maxval = reader.read();
+    if (w <= 0 || h <= 0 || maxval <= 0 || maxval > 65535)
+        return NULL;
+
+    int channels = color ? 3 : 1;
+    int bytesPerSample = maxval > 255 ? 2 : 1;
+    size_t samples = (size_t)w * h * channels;
+
+    // Raw samples start after exactly one whitespace character; a plain
+    //  sample needs at least a separator and a digit. Either way the file
+    //  must hold every sample before the image is allocated
+    size_t pos = reader.pos + 1;
+    size_t left = length - reader.pos;
+    if (plain ? samples > left / 2
+              : pos > length || samples * bytesPerSample > length - pos)
+        return NULL;
+
+    unsigned char *pixels = new unsigned char[(size_t)w * h];
+    int rgb[3];
+    for (size_t p = 0; p < (size_t)w * h; p++) {
+        for (int c = 0; c < channels; c++) {
+            int value;
+            if (plain) {
+                value = reader.read();
+                if (value < 0) {
+                    delete [] pixels;
+                    return NULL;
+                }
+            } else if (bytesPerSample == 2) {
+                value = (file[pos] << 8) | file[pos + 1];
+                pos += 2;
+            } else {
+                value = file[pos++];
+            }
+            if (value > maxval)
+                value = maxval;
+            rgb[c] = (value * 255 + maxval / 2) / maxval;
+        }
+        pixels[p] = color
+            ? (unsigned char)((299 * rgb[0] + 587 * rgb[1] + 114 * rgb[2] + 500) / 1000)
+            : (unsigned char)rgb[0];
+    }
+
+    *width = w;
+    *height = h;
+    return pixels;
+}
@@ -13,18 +13,13 @@ using namespace csc450Lib_linalg_base;
 
 RowVector::RowVector(int nbCols, const float * v) : Matrix(1, nbCols) {
     for (int i = 0; i < nbCols; i++)
-        this->a[0][i] = v[i];
+        this->data[i] = v[i];
 }
 
 RowVector::RowVector(int nbCols) : Matrix(1, nbCols) {
 }
 
-float RowVector::get(int theCol) const {
-    return a[0][theCol];
-}
-
-void RowVector::set(int theCol, float theVal) const {
-    a[0][theCol] = theVal;
+RowVector::RowVector(int nbCols, float * data) : Matrix(1, nbCols, data, nbCols) {
 }
 
 const ColumnVector* RowVector::transpose(const RowVector *matA) {
@@ -16,6 +16,11 @@ Subject::Subject(Matrix *images, int idnum)
     this->images = images;
 }
 
+Subject::~Subject()
+{
+    delete images;
+}
+
 int Subject::getID() const {
     return idnum;
 }
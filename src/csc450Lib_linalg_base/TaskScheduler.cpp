@@ -0,0 +1,241 @@
+//
+//  TaskScheduler.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "TaskScheduler.h"
+
+using namespace csc450Lib_linalg_base;
+
+namespace {
+    
+    /** One call to parallelFor */
+    struct Job {
+        const std::function<void(int, int)> *body;
+        int grain;
+        std::atomic<int> pending;
+        std::mutex errorLock;
+        std::exception_ptr error;
+    };
+    
+    /** A subrange of a job */
+    struct Task {
+        Job *job;
+        int begin;
+        int end;
+    };
+    
+    struct WorkQueue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+    
+    // Failed attempts to find work before a worker goes to sleep
+    const int SPINS = 64;
+    
+    // Queue of the current thread: 0 for threads outside the pool, which
+    //  share it, and 1 .. workers for the workers
+    thread_local int slot = 0;
+    
+    class Pool {
+    private:
+        std::vector<WorkQueue*> queues;
+        std::vector<std::thread> workers;
+        std::atomic<bool> stopping;
+        std::atomic<int> queued;
+        std::mutex sleepLock;
+        std::condition_variable wake;
+        
+        // Workers waiting on wake. Atomic, like queued, so that push() can
+        //  skip the lock when nobody sleeps: a worker raises it before
+        //  checking queued, and push() raises queued before reading it, so
+        //  one of the two always sees the other and no wake-up is lost
+        std::atomic<int> sleepers;
+        
+        bool popLocal(Task &task) {
+            WorkQueue *q = queues[slot];
+            std::lock_guard<std::mutex> guard(q->lock);
+            if (q->tasks.empty())
+                return false;
+            task = q->tasks.back();
+            q->tasks.pop_back();
+            queued--;
+            return true;
+        }
+        
+        bool steal(Task &task) {
+            int n = (int)queues.size();
+            for (int i = 1; i < n; i++) {
+                WorkQueue *q = queues[(slot + i) % n];
+                std::lock_guard<std::mutex> guard(q->lock);
+                if (!q->tasks.empty()) {
+                    task = q->tasks.front();
+                    q->tasks.pop_front();
+                    queued--;
+                    return true;
+                }
+            }
+            return false;
+        }
+        
+        void workerLoop(int index) {
+            slot = index;
+            int idle = 0;
+            while (!stopping) {
+                Task task;
+                if (findTask(task)) {
+                    execute(task);
+                    idle = 0;
+                } else if (++idle < SPINS) {
+                    std::this_thread::yield();
+                } else {
+                    std::unique_lock<std::mutex> lock(sleepLock);
+                    sleepers++;
+                    wake.wait_for(lock, std::chrono::milliseconds(1), [this] {
+                        return queued > 0 || stopping;
+                    });
+                    sleepers--;
+                    idle = 0;
+                }
+            }
+        }
+        
+    public:
+        Pool(void) : stopping(false), queued(0), sleepers(0) {
+            start(0);
+        }
+        
+        ~Pool(void) {
+            stop();
+        }
+        
+        int threads(void) const {
+            return (int)workers.size() + 1;
+        }
+        
+        void start(int numThreads) {
+            if (numThreads <= 0)
+                numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+            stopping = false;
+            queues.push_back(new WorkQueue());
+            for (int i = 1; i < numThreads; i++)
+                queues.push_back(new WorkQueue());
+            for (int i = 1; i < numThreads; i++)
+                workers.push_back(std::thread(&Pool::workerLoop, this, i));
+        }
+        
+        void stop(void) {
+            stopping = true;
+            {
+                std::lock_guard<std::mutex> guard(sleepLock);
+                wake.notify_all();
+            }
+            for (size_t i = 0; i < workers.size(); i++)
+                workers[i].join();
+            workers.clear();
+            for (size_t i = 0; i < queues.size(); i++)
+                delete queues[i];
+            queues.clear();
+        }
+        
+        void push(const Task &task) {
+            WorkQueue *q = queues[slot];
+            {
+                std::lock_guard<std::mutex> guard(q->lock);
+                q->tasks.push_back(task);
+                queued++;
+            }
+            if (sleepers > 0) {
+                std::lock_guard<std::mutex> guard(sleepLock);
+                wake.notify_one();
+            }
+        }
+        
+        bool findTask(Task &task) {
+            return popLocal(task) || steal(task);
+        }
+        
+        void execute(Task task) {
+            Job *job = task.job;
+            try {
+                while (task.end - task.begin > job->grain) {
+                    int mid = task.begin + (task.end - task.begin) / 2;
+                    job->pending++;
+                    Task upper = { job, mid, task.end };
+                    push(upper);
+                    task.end = mid;
+                }
+                (*job->body)(task.begin, task.end);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(job->errorLock);
+                if (!job->error)
+                    job->error = std::current_exception();
+            }
+            job->pending--;
+        }
+    };
+    
+    Pool& pool(void) {
+        static Pool instance;
+        return instance;
+    }
+}
+
+void TaskScheduler::setThreads(int numThreads) {
+    Pool &p = pool();
+    p.stop();
+    p.start(numThreads);
+}
+
+int TaskScheduler::threads(void) {
+    return pool().threads();
+}
+
+int TaskScheduler::defaultGrain(int count) {
+    return std::max(1, count / (8 * threads()));
+}
+
+void TaskScheduler::parallelFor(int begin, int end, int grain,
+                                const std::function<void(int, int)> &body) {
+    if (end <= begin)
+        return;
+    if (grain <= 0)
+        grain = defaultGrain(end - begin);
+    Pool &p = pool();
+    if (p.threads() == 1 || end - begin <= grain) {
+        body(begin, end);
+        return;
+    }
+    
+    Job job;
+    job.body = &body;
+    job.grain = grain;
+    job.pending = 1;
+    Task root = { &job, begin, end };
+    p.execute(root);
+    
+    // Help with whatever is queued until the last piece of this job is done
+    while (job.pending > 0) {
+        Task task;
+        if (p.findTask(task))
+            p.execute(task);
+        else
+            std::this_thread::yield();
+    }
+    if (job.error)
+        std::rethrow_exception(job.error);
+}
@@ -14,14 +14,31 @@ using namespace csc450Lib_linalg_base;
 using namespace csc450Lib_linalg_eigensystems;
 
 EigenSystem::EigenSystem() {
+    this->a = NULL;
+    this->l = NULL;
+    this->v = NULL;
 }
 
 EigenSystem::EigenSystem(const Matrix *a, const Matrix *v, const ColumnVector *l) {
     this->a = Matrix::copyOf(a);
-    this->l = (ColumnVector*)Matrix::copyOf(l);
+    this->l = new ColumnVector(l->rows());
+    Matrix::copyInto(l, this->l);
     this->v = Matrix::copyOf(v);
 }
 
+EigenSystem::EigenSystem(const Matrix *v, const ColumnVector *l) {
+    this->a = NULL;
+    this->l = new ColumnVector(l->rows());
+    Matrix::copyInto(l, this->l);
+    this->v = Matrix::copyOf(v);
+}
+
+EigenSystem::~EigenSystem(void) {
+    delete a;
+    delete l;
+    delete v;
+}
+
 Matrix* EigenSystem::getEigenVectors(void) const { return v; }
 
 ColumnVector* EigenSystem::getEigenValues(void) const { return l; }
@@ -8,17 +8,19 @@
 //=================================
 // included dependencies
 #include "EigenSystemSolver.h"
+#include "LinearOperator_dense.h"
+#include "MatrixMultiplier.h"
 
 using namespace std;
 using namespace csc450Lib_linalg_base;
 using namespace csc450Lib_linalg_sle;
 using namespace csc450Lib_linalg_eigensystems;
 
-EigenSystem* EigenSystemSolver::power(const Matrix *a,
-                                      const ColumnVector *init,
-                                      int iterations, float tol) {
-    // make a copy of the initial vector
-    ColumnVector *x = (ColumnVector*)Matrix::copyOf(init);
+float EigenSystemSolver::power(const Matrix *a,
+                               EigenSystemWorkspace *workspace,
+                               int iterations, float tol) {
+    ColumnVector *x = workspace->getX();
+    ColumnVector *y = workspace->getY();
     
     int k = 1;
     int imax = 0;
@@ -26,13 +28,13 @@ EigenSystem* EigenSystemSolver::power(const Matrix *a,
     bool converged = false;
     
     // get an initial l and lastl
-    const ColumnVector *y = (ColumnVector*)Matrix::multiply(a, x);
+    Matrix::multiplyInto(a, x, y);
     float lambda = y->normInf();
     float lastlambda = lambda + 100;
     
     // loop until converged
     for (k = 1; k < iterations && !converged; k++) {
-        y = (ColumnVector*)Matrix::multiply(a, x);
+        Matrix::multiplyInto(a, x, y);
         lambda = y->normInf();
         if (abs(lambda - lastlambda) < tol)
             converged = true;
@@ -41,69 +43,122 @@ EigenSystem* EigenSystemSolver::power(const Matrix *a,
         
         // sign of eigenalue
         s = (y->get(imax) * x->get(imax)) < 0 ? -1 : 1;
-        x = (ColumnVector*)Matrix::multiply(1.0 / lambda, y);
+        Matrix::copyInto(y, x);
+        x->scaleInPlace(1.0f / lambda);
     }
-    float val = s * lambda;
+    return s * lambda;
+}
+
+EigenSystem* EigenSystemSolver::power(const Matrix *a,
+                                      const ColumnVector *init,
+                                      int iterations, float tol) {
+    EigenSystemWorkspace workspace(a->rows());
+    Matrix::copyInto(init, workspace.getX());
+    
+    float val = power(a, &workspace, iterations, tol);
     
-    Matrix *v = x;
     ColumnVector *l = new ColumnVector(1);
     l->set(0, val);
-    return new EigenSystem(a, v, l);
+    EigenSystem *system = new EigenSystem(a, workspace.getX(), l);
+    delete l;
+    return system;
 }
 
-EigenSystem* EigenSystemSolver::rayleigh(const Matrix *a,
-                                         const ColumnVector *init,
-                                         float lambda, int iterations, float tol)  {
-    // make a copy of the initial vector
-    ColumnVector *x = (ColumnVector*)Matrix::copyOf(init);
-    RowVector *xt;
-    const Matrix *i = MatrixGenerator::getIdentity(a->rows());
-    LinearSolver *solver = new LinearSolver_LU();
-    const LinearSystemRecord *record;
+float EigenSystemSolver::rayleigh(const Matrix *a,
+                                  EigenSystemWorkspace *workspace,
+                                  float lambda, int iterations, float tol) {
+    ColumnVector *x = workspace->getX();
+    ColumnVector *y = workspace->getY();
+    Matrix *shifted = workspace->getShifted();
+    int *pivots = workspace->getPivots();
+    float *offDiagonal = workspace->getOffDiagonal();
+    int n = a->rows();
+    
+    // Symmetric shifted systems are factorized as L D transpose(L), at
+    //  half the cost of LU
+    bool symmetric = true;
+    for (int i = 0; i < n && symmetric; i++)
+        for (int j = 0; j < i; j++)
+            if (a->get(i, j) != a->get(j, i)) {
+                symmetric = false;
+                break;
+            }
     
     int k = 1;
-    int imax = 0;
     bool converged = false;
     
-    // get an initial l and lastl
-    const ColumnVector *y = (ColumnVector*)Matrix::multiply(a, x);
     float sigma = lambda;
     float lastsigma = sigma + 100;
     float num, den, norm;
     
     // loop until converged
     for (k = 1; k < iterations && !converged; k++) {
-        xt = (RowVector*)Matrix::transpose(x);
-        
-        num = Matrix::multiply(Matrix::multiply(xt,a),x)->get(0, 0);
-        den = Matrix::multiply(xt,x)->get(0,0);
+        Matrix::multiplyInto(a, x, y);
+        num = Matrix::dotProduct(x, y);
+        den = Matrix::dotProduct(x, x);
         sigma = num / den;
         
         if (abs(sigma - lastsigma) < tol)
             converged = true;
         lastsigma = sigma;
         
-        record = solver->solve(Matrix::subtract(a, Matrix::multiply(sigma, i)), x);
-        y = (ColumnVector*)record->getSolution();
+        // Solve (a - sigma * I) y = x
+        Matrix::copyInto(a, shifted);
+        for (int i = 0; i < n; i++)
+            shifted->set(i, i, shifted->get(i, i) - sigma);
+        
+        // A zero pivot means sigma is an exact eigenvalue, and x its vector
+        bool regular = symmetric
+            ? LinearSolver_LDLT::factorizeInPlace(shifted, pivots, offDiagonal)
+            : LinearSolver_LU::factorizeInPlace(shifted, pivots);
+        if (!regular)
+            break;
+        
+        Matrix::copyInto(x, y);
+        if (symmetric)
+            LinearSolver_LDLT::solveInPlace(shifted, pivots, offDiagonal, y);
+        else
+            LinearSolver_LU::solveInPlace(shifted, pivots, y);
         
         norm = y->normInf();
         
-        x = (ColumnVector*)Matrix::copyOf(Matrix::multiply(1.0f / norm, y));
+        Matrix::copyInto(y, x);
+        x->scaleInPlace(1.0f / norm);
     }
-    Matrix *v = x;
+    return sigma;
+}
+
+EigenSystem* EigenSystemSolver::rayleigh(const Matrix *a,
+                                         const ColumnVector *init,
+                                         float lambda, int iterations, float tol)  {
+    EigenSystemWorkspace workspace(a->rows());
+    Matrix::copyInto(init, workspace.getX());
+    
+    float sigma = rayleigh(a, &workspace, lambda, iterations, tol);
+    
     ColumnVector *l = new ColumnVector(1);
     l->set(0, sigma);
-    return new EigenSystem(a, v, l);
+    EigenSystem *system = new EigenSystem(a, workspace.getX(), l);
+    delete l;
+    return system;
     
 }
 
 
 EigenSystemSolver::EigenSystemSolver(void) {
-    
+    this->a = NULL;
+    this->method = POWER_ITERATION;
 }
 
 EigenSystemSolver::EigenSystemSolver(const Matrix *a) {
     this->a = a;
+    this->method = POWER_ITERATION;
+}
+
+EigenSystemSolver::EigenSystemSolver(const Matrix *a,
+                                     EigenSystemMethod method) {
+    this->a = a;
+    this->method = method;
 }
 
 EigenSystemSolver::~EigenSystemSolver(void) {
@@ -120,49 +175,457 @@ Matrix* EigenSystemSolver::deflate(const Matrix *a,
     return Matrix::subtract(a, Matrix::multiply(v, Matrix::transpose(u)));
 }
 
+void EigenSystemSolver::deflateInPlace(Matrix *a,
+                                       const ColumnVector *v,
+                                       float l) {
+    float norm = v->norm2();
+    float scale = l / (norm * norm);
+    
+    // a -= scale * v * transpose(v)
+    for (int i = 0; i < a->rows(); i++) {
+        float vi = scale * v->get(i);
+        for (int j = 0; j < a->cols(); j++) {
+            a->set(i, j, a->get(i, j) - vi * v->get(j));
+        }
+    }
+}
+
 const EigenSystem* EigenSystemSolver::solve(const Matrix *a) {
     this->a = a;
     return solve();
 }
 
 
-const EigenSystem* EigenSystemSolver::solve(void) const {
-    MatrixGenerator::seed();
-    int size = a->rows();
+void EigenSystemSolver::tridiagonalize(int n, double *w, double *d, double *e) {
+    // w holds the transpose of the working matrix, so every inner loop
+    //  below runs along a contiguous row
+    for (int j = 0; j < n; j++)
+        d[j] = w[(size_t)j * n + n - 1];
     
-    const Matrix *deflated = Matrix::copyOf(a);
-    ColumnVector *vectors[size];
-    float values[size];
+    for (int i = n - 1; i > 0; i--) {
+        double scale = 0;
+        double h = 0;
+        for (int k = 0; k < i; k++)
+            scale += std::abs(d[k]);
+        
+        if (scale == 0) {
+            e[i] = d[i - 1];
+            for (int j = 0; j < i; j++) {
+                d[j] = w[(size_t)j * n + i - 1];
+                w[(size_t)j * n + i] = 0;
+                w[(size_t)i * n + j] = 0;
+            }
+        } else {
+            // Householder vector for row i
+            for (int k = 0; k < i; k++) {
+                d[k] /= scale;
+                h += d[k] * d[k];
+            }
+            double f = d[i - 1];
+            double g = std::sqrt(h);
+            if (f > 0)
+                g = -g;
+            e[i] = scale * g;
+            h -= f * g;
+            d[i - 1] = f - g;
+            for (int j = 0; j < i; j++)
+                e[j] = 0;
+            
+            // p = A u / h, using the lower triangle only
+            for (int j = 0; j < i; j++) {
+                double *wj = w + (size_t)j * n;
+                f = d[j];
+                w[(size_t)i * n + j] = f;
+                g = e[j] + wj[j] * f;
+                for (int k = j + 1; k <= i - 1; k++) {
+                    g += wj[k] * d[k];
+                    e[k] += wj[k] * f;
+                }
+                e[j] = g;
+            }
+            f = 0;
+            for (int j = 0; j < i; j++) {
+                e[j] /= h;
+                f += e[j] * d[j];
+            }
+            double hh = f / (h + h);
+            for (int j = 0; j < i; j++)
+                e[j] -= hh * d[j];
+            
+            // A -= u q' + q u'
+            for (int j = 0; j < i; j++) {
+                double *wj = w + (size_t)j * n;
+                f = d[j];
+                g = e[j];
+                for (int k = j; k <= i - 1; k++)
+                    wj[k] -= (f * e[k] + g * d[k]);
+                d[j] = wj[i - 1];
+                wj[i] = 0;
+            }
+        }
+        d[i] = h;
+    }
     
-    ColumnVector *init;
+    // Accumulate the transformations
+    for (int i = 0; i < n - 1; i++) {
+        double *wi = w + (size_t)i * n;
+        double *wnext = w + (size_t)(i + 1) * n;
+        wi[n - 1] = wi[i];
+        wi[i] = 1;
+        double h = d[i + 1];
+        if (h != 0) {
+            for (int k = 0; k <= i; k++)
+                d[k] = wnext[k] / h;
+            for (int j = 0; j <= i; j++) {
+                double *wj = w + (size_t)j * n;
+                double g = 0;
+                for (int k = 0; k <= i; k++)
+                    g += wnext[k] * wj[k];
+                for (int k = 0; k <= i; k++)
+                    wj[k] -= g * d[k];
+            }
+        }
+        for (int k = 0; k <= i; k++)
+            wnext[k] = 0;
+    }
+    for (int j = 0; j < n; j++) {
+        d[j] = w[(size_t)j * n + n - 1];
+        w[(size_t)j * n + n - 1] = 0;
+    }
+    w[(size_t)(n - 1) * n + n - 1] = 1;
+    e[0] = 0;
+}
+
+bool EigenSystemSolver::tridiagonalQL(int n, double *w, double *d, double *e) {
+    for (int i = 1; i < n; i++)
+        e[i - 1] = e[i];
+    e[n - 1] = 0;
     
-    EigenSystem *currentSystem;
+    double f = 0;
+    double tst1 = 0;
+    double eps = std::pow(2.0, -52.0);
+    bool converged = true;
     
-    for (int i = 0; i < size; i++) {
-        init = MatrixGenerator::getRandomColumn(size);
+    for (int l = 0; l < n; l++) {
+        // Find a small subdiagonal element
+        tst1 = std::max(tst1, std::abs(d[l]) + std::abs(e[l]));
+        int m = l;
+        while (m < n - 1 && std::abs(e[m]) > eps * tst1)
+            m++;
         
-        currentSystem = power(deflated, init, 500, 0.00001);
-        currentSystem = rayleigh(a, currentSystem->getEigenVector(0),
-                                 currentSystem->getEigenValue(0),
-                                 10, 0.000001);
+        // If m == l, d[l] is already an eigenvalue; otherwise iterate
+        if (m > l) {
+            int iter = 0;
+            do {
+                if (++iter > 60) {
+                    converged = false;
+                    break;
+                }
+                
+                // Compute the implicit shift
+                double g = d[l];
+                double p = (d[l + 1] - g) / (2 * e[l]);
+                double r = std::hypot(p, 1.0);
+                if (p < 0)
+                    r = -r;
+                d[l] = e[l] / (p + r);
+                d[l + 1] = e[l] * (p + r);
+                double dl1 = d[l + 1];
+                double h = g - d[l];
+                for (int i = l + 2; i < n; i++)
+                    d[i] -= h;
+                f += h;
+                
+                // Implicit QL transformation
+                p = d[m];
+                double c = 1, c2 = 1, c3 = 1;
+                double el1 = e[l + 1];
+                double s = 0, s2 = 0;
+                for (int i = m - 1; i >= l; i--) {
+                    c3 = c2;
+                    c2 = c;
+                    s2 = s;
+                    g = c * e[i];
+                    h = c * p;
+                    r = std::hypot(p, e[i]);
+                    e[i + 1] = s * r;
+                    s = e[i] / r;
+                    c = p / r;
+                    p = c * d[i] - s * g;
+                    d[i + 1] = h + s * (c * g + s * d[i]);
+                    
+                    // Rotate eigenvectors i and i + 1
+                    double *wi = w + (size_t)i * n;
+                    double *wnext = w + (size_t)(i + 1) * n;
+                    for (int k = 0; k < n; k++) {
+                        h = wnext[k];
+                        wnext[k] = s * wi[k] + c * h;
+                        wi[k] = c * wi[k] - s * h;
+                    }
+                }
+                p = -s * s2 * c3 * el1 * e[l] / dl1;
+                e[l] = s * p;
+                d[l] = c * p;
+            } while (std::abs(e[l]) > eps * tst1);
+        }
+        d[l] += f;
+        e[l] = 0;
+    }
+    
+    return converged;
+}
+
+EigenSystem* EigenSystemSolver::symmetricQR(const Matrix *a) {
+    int n = a->rows();
+    if (a->cols() != n)
+        throw "Matrix is not square";
+    
+    double *w = new double[(size_t)n * n];
+    double *d = new double[n];
+    double *e = new double[n];
+    
+    // The lower triangle of a, transposed, is all the reduction reads
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            w[(size_t)i * n + j] = a->get(j, i);
+    
+    if (n > 0) {
+        tridiagonalize(n, w, d, e);
+        if (!tridiagonalQL(n, w, d, e))
+            cout << "No convergence\n";
+    }
+    
+    // Sort the eigenpairs by decreasing eigenvalue
+    int *order = new int[n];
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+    std::sort(order, order + n, [d](int x, int y) { return d[x] > d[y]; });
+    
+    Matrix *v = new Matrix(n, n);
+    ColumnVector *l = new ColumnVector(n);
+    for (int j = 0; j < n; j++) {
+        const double *wj = w + (size_t)order[j] * n;
+        for (int i = 0; i < n; i++)
+            v->set(i, j, (float)wj[i]);
+        l->set(j, (float)d[order[j]]);
+    }
+    
+    EigenSystem *system = new EigenSystem(a, v, l);
+    
+    delete [] w;
+    delete [] d;
+    delete [] e;
+    delete [] order;
+    delete v;
+    delete l;
+    return system;
+}
+
+void EigenSystemSolver::orthonormalizeRows(Matrix *q, int from) {
+    const int block = 32;
+    int n = q->cols();
+    float *data = q->getData();
+    int ld = q->stride();
+    
+    for (int i0 = std::max(from, 0); i0 < q->rows(); i0 += block) {
+        int nb = std::min(block, q->rows() - i0);
+        float *qb = data + (size_t)i0 * ld;
+        float before[block];
+        for (int i = 0; i < nb; i++)
+            before[i] = std::sqrt(MatrixMultiplier::dot(n, qb + (size_t)i * ld,
+                                                        qb + (size_t)i * ld));
         
-        vectors[i] = currentSystem->getEigenVector(0);
-        values[i] = currentSystem->getEigenValue(0);
+        // Project the block off the rows before it with two GEMMs, twice
+        //  for stability (classical Gram-Schmidt with reorthogonalization)
+        if (i0 > 0) {
+            Matrix *c = new Matrix(nb, i0);
+            for (int pass = 0; pass < 2; pass++) {
+                MatrixMultiplier::gemm(false, true, nb, i0, n,
+                                       1.0f, qb, ld, data, ld,
+                                       0.0f, c->getData(), c->stride());
+                MatrixMultiplier::gemm(false, false, nb, n, i0,
+                                       -1.0f, c->getData(), c->stride(),
+                                       data, ld,
+                                       1.0f, qb, ld);
+            }
+            delete c;
+        }
         
-        deflated = deflate(deflated, vectors[i], values[i]);
+        // Then the rows of the block off each other
+        for (int i = i0; i < i0 + nb; i++) {
+            float *qi = data + (size_t)i * ld;
+            int first = i0;
+            
+            for (int attempt = 0; attempt < 4; attempt++) {
+                for (int pass = 0; pass < 2; pass++) {
+                    for (int j = first; j < i; j++) {
+                        const float *qj = data + (size_t)j * ld;
+                        float r = MatrixMultiplier::dot(n, qi, qj);
+                        for (int c = 0; c < n; c++)
+                            qi[c] -= r * qj[c];
+                    }
+                }
+                
+                float norm = std::sqrt(MatrixMultiplier::dot(n, qi, qi));
+                if (norm > 1e-4f * before[i - i0] && norm > 0) {
+                    for (int c = 0; c < n; c++)
+                        qi[c] /= norm;
+                    break;
+                }
+                
+                // Dependent row: start over from a random direction, to be
+                //  projected off every previous row
+                for (int c = 0; c < n; c++)
+                    qi[c] = (rand() % 1000) / 1000.0f - 0.5f;
+                before[i - i0] = std::sqrt(MatrixMultiplier::dot(n, qi, qi));
+                first = 0;
+            }
+        }
+    }
+}
+
+EigenSystem* EigenSystemSolver::solveTopK(const Matrix *a, int k, float tol) {
+    LinearOperator_dense op(a);
+    return solveTopK(&op, k, tol);
+}
+
+EigenSystem* EigenSystemSolver::solveTopK(const LinearOperator *op,
+                                          int k, float tol) {
+    int n = op->size();
+    if (k <= 0 || k > n)
+        throw "Invalid number of eigenpairs";
+    
+    // Oversampling the block speeds up convergence of the k-th pair
+    int b = std::min(n, k + std::max(10, k / 2));
+    int maxIterations = 500;
+    
+    // Blocks of vectors, one vector per row
+    Matrix *q = new Matrix(b, n);
+    Matrix *y = new Matrix(b, n);
+    Matrix *v = new Matrix(b, n);
+    Matrix *t = new Matrix(b, b);
+    ColumnVector *theta = new ColumnVector(b);
+    
+    MatrixGenerator::randomize(q);
+    for (int i = 0; i < b; i++)
+        for (int j = 0; j < n; j++)
+            q->set(i, j, q->get(i, j) - 0.5f);
+    orthonormalizeRows(q);
+    
+    for (int iter = 0; iter < maxIterations; iter++) {
+        op->apply(q, y);
         
+        // Rayleigh-Ritz: t = q * transpose(op(q)), projected eigenproblem
+        MatrixMultiplier::gemm(false, true, b, b, n,
+                               1.0f, q->getData(), q->stride(),
+                               y->getData(), y->stride(),
+                               0.0f, t->getData(), t->stride());
+        for (int i = 0; i < b; i++)
+            for (int j = i + 1; j < b; j++) {
+                float sym = 0.5f * (t->get(i, j) + t->get(j, i));
+                t->set(i, j, sym);
+                t->set(j, i, sym);
+            }
+        EigenSystem *ritz = symmetricQR(t);
+        const Matrix *s = ritz->getEigenVectors();
+        for (int i = 0; i < b; i++)
+            theta->set(i, ritz->getEigenValue(i));
+        
+        // Ritz vectors v = transpose(s) * q, and their images transpose(s) * y
+        MatrixMultiplier::gemm(true, false, b, n, b,
+                               1.0f, s->getData(), s->stride(),
+                               q->getData(), q->stride(),
+                               0.0f, v->getData(), v->stride());
+        MatrixMultiplier::gemm(true, false, b, n, b,
+                               1.0f, s->getData(), s->stride(),
+                               y->getData(), y->stride(),
+                               0.0f, q->getData(), q->stride());
+        delete ritz;
+        
+        // Residuals of the wanted pairs: |op(v_i) - theta_i v_i|
+        float scale = std::max(std::abs(theta->get(0)), 1e-30f);
+        bool converged = true;
+        for (int i = 0; i < k && converged; i++) {
+            const float *vi = v->getData() + (size_t)i * v->stride();
+            const float *wi = q->getData() + (size_t)i * q->stride();
+            float res = 0;
+            for (int j = 0; j < n; j++) {
+                float r = wi[j] - theta->get(i) * vi[j];
+                res += r * r;
+            }
+            if (std::sqrt(res) > tol * scale)
+                converged = false;
+        }
+        
+        if (converged || b == n)
+            break;
+        if (iter == maxIterations - 1)
+            cout << "No convergence\n";
+        
+        // Next subspace: span of op(q), which q now holds
+        orthonormalizeRows(q);
+    }
+    
+    Matrix *vectors = new Matrix(n, k);
+    ColumnVector *values = new ColumnVector(k);
+    for (int i = 0; i < k; i++) {
+        for (int j = 0; j < n; j++)
+            vectors->set(j, i, v->get(i, j));
+        values->set(i, theta->get(i));
     }
+    EigenSystem *system = new EigenSystem(vectors, values);
     
-    ColumnVector *l = new ColumnVector(size, values);
+    delete q;
+    delete y;
+    delete v;
+    delete t;
+    delete theta;
+    delete vectors;
+    delete values;
+    return system;
+}
+
+const EigenSystem* EigenSystemSolver::solve(void) const {
+    if (method == SYMMETRIC_QR)
+        return symmetricQR(a);
     
-    Matrix *v = vectors[0];
-    for (int i = 1; i < size; i++) {
-        v->addColumn(vectors[i]);
+    MatrixGenerator::seed();
+    int size = a->rows();
+    
+    // Everything the iterations touch is allocated here, once
+    EigenSystemWorkspace workspace(size);
+    Matrix *deflated = workspace.getDeflated();
+    ColumnVector *x = workspace.getX();
+    Matrix::copyInto(a, deflated);
+    
+    Matrix *v = new Matrix(size, size);
+    ColumnVector *l = new ColumnVector(size);
+    
+    for (int i = 0; i < size; i++) {
+        MatrixGenerator::randomize(x);
+        
+        float value = power(deflated, &workspace, 500, 0.00001);
+        value = rayleigh(a, &workspace, value, 10, 0.000001);
+        
+        for (int j = 0; j < size; j++)
+            v->set(j, i, x->get(j));
+        l->set(i, value);
+        
+        deflateInPlace(deflated, x, value);
+        
     }
     
     const EigenSystem *system = new EigenSystem(a, v, l);
+    delete v;
+    delete l;
     return system;
 }
 
 
-void EigenSystemSolver::setA(const Matrix *a) { this->a = a; }
\ No newline at end of file
+void EigenSystemSolver::setA(const Matrix *a) { this->a = a; }
+
+void EigenSystemSolver::setMethod(EigenSystemMethod method) {
+    this->method = method;
+}
+
+EigenSystemMethod EigenSystemSolver::getMethod(void) const { return method; }
\ No newline at end of file
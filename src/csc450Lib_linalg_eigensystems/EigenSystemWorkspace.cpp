@@ -0,0 +1,47 @@
+//
+//  EigenSystemWorkspace.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include "EigenSystemWorkspace.h"
+
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+EigenSystemWorkspace::EigenSystemWorkspace(int size) {
+    this->size = size;
+    this->x = new ColumnVector(size);
+    this->y = new ColumnVector(size);
+    this->shifted = new Matrix(size, size);
+    this->deflated = new Matrix(size, size);
+    this->pivots = new int[size > 0 ? size : 1];
+    this->offDiagonal = new float[size > 0 ? size : 1];
+}
+
+EigenSystemWorkspace::~EigenSystemWorkspace(void) {
+    delete x;
+    delete y;
+    delete shifted;
+    delete deflated;
+    delete [] pivots;
+    delete [] offDiagonal;
+}
+
+int EigenSystemWorkspace::getSize(void) const { return size; }
+
+ColumnVector* EigenSystemWorkspace::getX(void) const { return x; }
+
+ColumnVector* EigenSystemWorkspace::getY(void) const { return y; }
+
+Matrix* EigenSystemWorkspace::getShifted(void) const { return shifted; }
+
+Matrix* EigenSystemWorkspace::getDeflated(void) const { return deflated; }
+
+int* EigenSystemWorkspace::getPivots(void) const { return pivots; }
+
+float* EigenSystemWorkspace::getOffDiagonal(void) const { return offDiagonal; }
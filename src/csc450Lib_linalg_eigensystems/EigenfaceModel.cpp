@@ -0,0 +1,141 @@
+//
+//  EigenfaceModel.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <cmath>
+
+#include "EigenfaceModel.h"
+#include "EigenSystemSolver.h"
+#include "MatrixMultiplier.h"
+#include "SingularValueSolver.h"
+
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+EigenfaceModel::EigenfaceModel(const ColumnVector *mean,
+                               const Matrix *eigenfaces,
+                               const ColumnVector *eigenvalues,
+                               int count) {
+    this->count = count;
+    this->mean = (ColumnVector*)Matrix::copyOf(mean);
+    this->eigenfaces = Matrix::copyOf(eigenfaces);
+    this->eigenvalues = (ColumnVector*)Matrix::copyOf(eigenvalues);
+}
+
+EigenfaceModel::~EigenfaceModel(void) {
+    delete mean;
+    delete eigenfaces;
+    delete eigenvalues;
+}
+
+int EigenfaceModel::getCount(void) const {
+    return count;
+}
+
+ColumnVector* EigenfaceModel::getMean(void) const {
+    return mean;
+}
+
+Matrix* EigenfaceModel::getEigenfaces(void) const {
+    return eigenfaces;
+}
+
+ColumnVector* EigenfaceModel::getEigenValues(void) const {
+    return eigenvalues;
+}
+
+EigenfaceModel* EigenfaceModel::train(const Matrix *images, int k) {
+    ColumnVector *mean = new ColumnVector(images->rows());
+    Matrix *empty = new Matrix(images->rows(), 0);
+    ColumnVector *none = new ColumnVector(0);
+    EigenfaceModel *model = new EigenfaceModel(mean, empty, none, 0);
+    EigenfaceModel *trained = model->update(images, k);
+    delete mean;
+    delete empty;
+    delete none;
+    delete model;
+    return trained;
+}
+
+EigenfaceModel* EigenfaceModel::update(const Matrix *images, int k) const {
+    int n = mean->rows();
+    int b = images->cols();
+    int kOld = eigenfaces->cols();
+    if (images->rows() != n)
+        throw "Matrices do not match";
+    
+    // Mean of the new images, and the updated mean
+    ColumnVector *batchMean = (ColumnVector*)images->averageColumn();
+    int total = count + b;
+    ColumnVector *newMean = new ColumnVector(n);
+    for (int i = 0; i < n; i++)
+        newMean->set(i, (count * mean->get(i) + b * batchMean->get(i)) / total);
+    
+    // The centered data of the updated model has the same left singular
+    //  vectors and values as D = [U * S, B - batchMean, c * (batchMean -
+    //  mean)], with c = sqrt(count * b / total) accounting for the shift of
+    //  the mean. The last column vanishes when the model is empty
+    int extra = count > 0 ? 1 : 0;
+    int r = kOld + b + extra;
+    Matrix *d = new Matrix(n, r);
+    float c = extra ? std::sqrt((float)count * b / total) : 0;
+    ColumnVector *sigma = new ColumnVector(kOld);
+    for (int j = 0; j < kOld; j++)
+        sigma->set(j, std::sqrt(eigenvalues->get(j)));
+    for (int i = 0; i < n; i++) {
+        float *row = d->getData() + (size_t)i * d->stride();
+        for (int j = 0; j < kOld; j++)
+            row[j] = eigenfaces->get(i, j) * sigma->get(j);
+        for (int j = 0; j < b; j++)
+            row[kOld + j] = images->get(i, j) - batchMean->get(i);
+        if (extra)
+            row[kOld + b] = c * (batchMean->get(i) - mean->get(i));
+    }
+    delete batchMean;
+    delete sigma;
+    
+    // Orthonormal basis Q of span(D), one vector per row. The eigenfaces
+    //  come first and are already orthonormal, so the new directions are
+    //  those of D orthogonal to them
+    Matrix *q = (Matrix*)Matrix::transpose(d);
+    for (int j = 0; j < kOld; j++)
+        for (int i = 0; i < n; i++)
+            q->set(j, i, eigenfaces->get(i, j));
+    EigenSystemSolver::orthonormalizeRows(q, kOld);
+    
+    // D = Q^T * (Q * D), and the small r x r factor gives the update
+    Matrix *small = new Matrix(r, r);
+    MatrixMultiplier::gemm(false, false, r, r, n,
+                           1.0f, q->getData(), q->stride(),
+                           d->getData(), d->stride(),
+                           0.0f, small->getData(), small->stride());
+    delete d;
+    SingularValueDecomposition *svd = SingularValueSolver::thinSVD(small);
+    delete small;
+    
+    int kNew = std::min(k, svd->getRank());
+    Matrix *newFaces = new Matrix(n, kNew);
+    ColumnVector *newValues = new ColumnVector(kNew);
+    for (int j = 0; j < kNew; j++)
+        newValues->set(j, svd->getSingularValue(j) * svd->getSingularValue(j));
+    if (kNew > 0)
+        MatrixMultiplier::gemm(true, false, n, kNew, r,
+                               1.0f, q->getData(), q->stride(),
+                               svd->getU()->getData(), svd->getU()->stride(),
+                               0.0f, newFaces->getData(), newFaces->stride());
+    delete svd;
+    delete q;
+    
+    EigenfaceModel *model = new EigenfaceModel(newMean, newFaces,
+                                               newValues, total);
+    delete newMean;
+    delete newFaces;
+    delete newValues;
+    return model;
+}
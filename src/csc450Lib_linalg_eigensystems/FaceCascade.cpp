@@ -0,0 +1,219 @@
+//
+//  FaceCascade.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "FaceCascade.h"
+#include "EigenfaceModel.h"
+#include "ImagePreprocessor.h"
+#include "NearestNeighborIndex.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+FaceCascade::FaceCascade(int numSubjects, const Subject *subjects[],
+                         const Matrix *eigenfaces,
+                         const ColumnVector *averageFace,
+                         int width, int height, float threshold) {
+    if (eigenfaces->rows() != averageFace->rows()
+        || eigenfaces->rows() != width * height)
+        throw "Matrices do not match";
+    this->width = width;
+    this->height = height;
+    this->subjects.assign(subjects, subjects + numSubjects);
+
+    Level full;
+    full.width = width;
+    full.height = height;
+    full.eigenfaces = eigenfaces;
+    full.averageFace = averageFace;
+    full.owned = false;
+    full.threshold = threshold;
+    full.candidates = numSubjects;
+    full.projector = NULL;
+    full.classWeights = NULL;
+    levels.push_back(full);
+    enroll(0);
+}
+
+FaceCascade::~FaceCascade(void) {
+    for (size_t l = 0; l < levels.size(); l++) {
+        delete levels[l].projector;
+        delete levels[l].classWeights;
+        if (levels[l].owned) {
+            delete levels[l].eigenfaces;
+            delete levels[l].averageFace;
+        }
+    }
+}
+
+void FaceCascade::enroll(int l) {
+    Level &level = levels[l];
+    delete level.projector;
+    delete level.classWeights;
+    level.projector = new FaceProjector(level.eigenfaces, level.averageFace);
+    level.classWeights = new Matrix((int)subjects.size(),
+                                    level.eigenfaces->cols());
+
+    // The class vector is the projection of the subject's average image,
+    //  which downsampling (linear too) leaves the average of the
+    //  downsampled images
+    for (size_t s = 0; s < subjects.size(); s++) {
+        const Matrix *images = subjects[s]->getImages();
+        if (images->rows() != width * height)
+            throw "Matrices do not match";
+        const ColumnVector *meanImage = images->averageColumn();
+        project(l, meanImage, reduce(meanImage),
+                level.classWeights->getData() + s * level.classWeights->stride());
+        delete meanImage;
+    }
+}
+
+const vector<vector<float> >& FaceCascade::reduce(const ColumnVector *probe) const {
+    if (probe->rows() != width * height)
+        throw "Matrices do not match";
+    static thread_local vector<vector<float> > reduced;
+    int coarse = size() - 1;
+    reduced.resize(coarse);
+    for (int l = coarse - 1; l >= 0; l--) {
+        const float *src = l == coarse - 1 ? probe->getData()
+            : reduced[l + 1].data();
+        size_t stride = l == coarse - 1 ? probe->stride() : 1;
+        const Level &finer = levels[l + 1];
+        reduced[l].resize((size_t)levels[l].width * levels[l].height);
+        ImagePreprocessor::resample(src, finer.width, finer.height, stride,
+                                    reduced[l].data(), levels[l].width,
+                                    levels[l].height, 1);
+    }
+    return reduced;
+}
+
+float FaceCascade::project(int level, const ColumnVector *probe,
+                           const vector<vector<float> > &reduced,
+                           float *weights) const {
+    if (level == size() - 1)
+        return levels[level].projector->project(probe, weights);
+    ColumnVector view((int)reduced[level].size(),
+                      (float*)reduced[level].data(), 1);
+    return levels[level].projector->project(&view, weights);
+}
+
+int FaceCascade::addLevel(int width, int height, int k, float threshold,
+                          int candidates) {
+    if (width < 1 || height < 1 || width > this->width || height > this->height)
+        throw "Level size out of range";
+    if (candidates < 1)
+        throw "A level must keep a candidate";
+
+    // The subjects' images, downsampled, one per column
+    int count = 0;
+    for (size_t s = 0; s < subjects.size(); s++)
+        count += subjects[s]->getImages()->cols();
+    Matrix *images = new Matrix(width * height, count);
+    int column = 0;
+    for (size_t s = 0; s < subjects.size(); s++) {
+        const Matrix *faces = subjects[s]->getImages();
+        for (int j = 0; j < faces->cols(); j++, column++)
+            ImagePreprocessor::resample(faces->getData() + j, this->width,
+                                        this->height, faces->stride(),
+                                        images->getData() + column, width,
+                                        height, images->stride());
+    }
+    EigenfaceModel *model = EigenfaceModel::train(images, k);
+    delete images;
+
+    Level level;
+    level.width = width;
+    level.height = height;
+    level.eigenfaces = Matrix::copyOf(model->getEigenfaces());
+    level.averageFace = new ColumnVector(width * height,
+                                         model->getMean()->getData());
+    level.owned = true;
+    level.projector = NULL;
+    level.classWeights = NULL;
+    level.threshold = threshold;
+    level.candidates = candidates;
+    delete model;
+
+    // Coarsest first, the full resolution staying last. The levels below
+    //  are now reduced from this one, so their class vectors are redone
+    int index = 0;
+    while (index < size() - 1
+           && levels[index].width * levels[index].height <= width * height)
+        index++;
+    levels.insert(levels.begin() + index, level);
+    for (int l = index; l >= 0; l--)
+        enroll(l);
+    return index;
+}
+
+int FaceCascade::size(void) const {
+    return (int)levels.size();
+}
+
+void FaceCascade::setThreshold(int level, float threshold) {
+    if (level < 0 || level >= size())
+        throw "Level out of range";
+    levels[level].threshold = threshold;
+}
+
+float FaceCascade::distFromFaceSpace(int level, const ColumnVector *probe) const {
+    if (level < 0 || level >= size())
+        throw "Level out of range";
+    static thread_local vector<float> weights;
+    weights.resize(levels[level].eigenfaces->cols());
+    return project(level, probe, reduce(probe), weights.data());
+}
+
+const Subject* FaceCascade::recognize(const ColumnVector *probe,
+                                      float *distance, int *level) const {
+    static thread_local vector<float> weights;
+    static thread_local vector<pair<float, int> > alive;
+    alive.clear();
+    for (int s = 0; s < (int)subjects.size(); s++)
+        alive.push_back(make_pair(0.0f, s));
+    if (alive.empty())
+        throw "No subjects enrolled";
+
+    const vector<vector<float> > &reduced = reduce(probe);
+    for (int l = 0; l < size(); l++) {
+        const Level &current = levels[l];
+        int k = current.eigenfaces->cols();
+        weights.resize(k);
+        if (project(l, probe, reduced, weights.data()) > current.threshold) {
+            if (level != NULL)
+                *level = l;
+            return NULL;
+        }
+
+        // Only the survivors of the coarser levels are scored
+        for (size_t c = 0; c < alive.size(); c++) {
+            const float *classVector = current.classWeights->getData()
+                + (size_t)alive[c].second * current.classWeights->stride();
+            alive[c].first = NearestNeighborIndex::squaredDistance(k, weights.data(),
+                                                                   classVector);
+        }
+        size_t keep = l == size() - 1 ? 1 : min((size_t)current.candidates,
+                                                 alive.size());
+        if (keep < alive.size()) {
+            partial_sort(alive.begin(), alive.begin() + keep, alive.end());
+            alive.resize(keep);
+        }
+    }
+
+    if (level != NULL)
+        *level = size() - 1;
+    if (distance != NULL)
+        *distance = sqrt(alive[0].first);
+    return subjects[alive[0].second];
+}
@@ -0,0 +1,266 @@
+//
+//  FaceDetector.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <algorithm>
+#include <cmath>
+
+#include "FaceDetector.h"
+#include "FourierTransform.h"
+#include "ImagePreprocessor.h"
+#include "TaskScheduler.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+namespace {
+
+    /**
+     * Share of the smaller of two detections covered by the other. Unlike
+     *  intersection over union it is 1 for a window nested in a larger
+     *  one, as a face part found at a finer scale is
+     */
+    float overlapOf(const FaceDetector::Detection &a,
+                    const FaceDetector::Detection &b) {
+        int w = min(a.x + a.width, b.x + b.width) - max(a.x, b.x);
+        int h = min(a.y + a.height, b.y + b.height) - max(a.y, b.y);
+        if (w <= 0 || h <= 0)
+            return 0;
+        float smaller = min((float)a.width * a.height, (float)b.width * b.height);
+        return (float)w * h / smaller;
+    }
+}
+
+FaceDetector::FaceDetector(const Matrix *eigenfaces,
+                           const ColumnVector *averageFace,
+                           int width, int height) {
+    if (eigenfaces->rows() != averageFace->rows()
+        || eigenfaces->rows() != width * height)
+        throw "Matrices do not match";
+    this->eigenfaces = eigenfaces;
+    this->averageFace = averageFace;
+    this->width = width;
+    this->height = height;
+
+    int k = eigenfaces->cols();
+    averageWeights.assign(k, 0.0);
+    averageNorm = 0;
+    for (int p = 0; p < eigenfaces->rows(); p++) {
+        double mu = averageFace->get(p);
+        const float *e = eigenfaces->getData() + (size_t)p * eigenfaces->stride();
+        for (int j = 0; j < k; j++)
+            averageWeights[j] += e[j] * mu;
+        averageNorm += mu * mu;
+    }
+}
+
+const vector<vector<complex<double> > >& FaceDetector::kernelSpectra(int rows,
+                                                                     int cols) const {
+    lock_guard<mutex> guard(lock);
+    pair<int, int> key(rows, cols);
+    map<pair<int, int>, vector<vector<complex<double> > > >::iterator found
+        = spectra.find(key);
+    if (found != spectra.end())
+        return found->second;
+
+    // Kernel i is eigenface i, and the last one the average face
+    int k = eigenfaces->cols();
+    int kernels = k + 1;
+    vector<vector<complex<double> > > &pairs = spectra[key];
+    pairs.resize((kernels + 1) / 2);
+    vector<complex<double> > buffer((size_t)rows * cols);
+    for (int i = 0; i < kernels; i++) {
+        std::fill(buffer.begin(), buffer.end(), complex<double>(0));
+        for (int u = 0; u < height; u++) {
+            for (int v = 0; v < width; v++) {
+                int p = u * width + v;
+                buffer[(size_t)u * cols + v] = i < k ? eigenfaces->get(p, i)
+                    : averageFace->get(p);
+            }
+        }
+        FourierTransform::transform2D(buffer.data(), rows, cols, false);
+
+        // Correlation is a product with the conjugate spectrum; the second
+        //  kernel of a pair goes to the imaginary part of the result
+        vector<complex<double> > &spectrum = pairs[i / 2];
+        if (i % 2 == 0) {
+            spectrum.resize(buffer.size());
+            for (size_t f = 0; f < buffer.size(); f++)
+                spectrum[f] = conj(buffer[f]);
+        } else {
+            complex<double> unit(0, 1);
+            for (size_t f = 0; f < buffer.size(); f++)
+                spectrum[f] += unit * conj(buffer[f]);
+        }
+    }
+    return pairs;
+}
+
+Matrix* FaceDetector::faceMap(const Matrix *frame) const {
+    int rows = frame->rows();
+    int cols = frame->cols();
+    if (rows < height || cols < width)
+        throw "Frame is smaller than a face";
+    int mapRows = rows - height + 1;
+    int mapCols = cols - width + 1;
+    int k = eigenfaces->cols();
+    int kernels = k + 1;
+
+    int fftRows = FourierTransform::size(rows);
+    int fftCols = FourierTransform::size(cols);
+    const vector<vector<complex<double> > > &pairs = kernelSpectra(fftRows, fftCols);
+
+    // |x|^2 of every window, from the integral image of the squared frame
+    vector<double> integral((size_t)(rows + 1) * (cols + 1), 0.0);
+    for (int r = 0; r < rows; r++) {
+        const float *line = frame->getData() + (size_t)r * frame->stride();
+        double sum = 0;
+        for (int c = 0; c < cols; c++) {
+            sum += (double)line[c] * line[c];
+            integral[(size_t)(r + 1) * (cols + 1) + c + 1]
+                = integral[(size_t)r * (cols + 1) + c + 1] + sum;
+        }
+    }
+    vector<double> distance((size_t)mapRows * mapCols);
+    for (int y = 0; y < mapRows; y++) {
+        for (int x = 0; x < mapCols; x++) {
+            const double *top = integral.data() + (size_t)y * (cols + 1);
+            const double *bottom = integral.data() + (size_t)(y + height) * (cols + 1);
+            distance[(size_t)y * mapCols + x] = bottom[x + width] - bottom[x]
+                - top[x + width] + top[x] + averageNorm;
+        }
+    }
+
+    vector<complex<double> > spectrum((size_t)fftRows * fftCols);
+    for (int r = 0; r < rows; r++) {
+        const float *line = frame->getData() + (size_t)r * frame->stride();
+        for (int c = 0; c < cols; c++)
+            spectrum[(size_t)r * fftCols + c] = line[c];
+    }
+    FourierTransform::transform2D(spectrum.data(), fftRows, fftCols, false);
+
+    // Two correlations per inverse transform, each taken off the distance
+    vector<complex<double> > product(spectrum.size());
+    for (size_t p = 0; p < pairs.size(); p++) {
+        const vector<complex<double> > &kernel = pairs[p];
+        for (size_t f = 0; f < product.size(); f++) {
+            double a = spectrum[f].real(), b = spectrum[f].imag();
+            double c = kernel[f].real(), d = kernel[f].imag();
+            product[f] = complex<double>(a * c - b * d, a * d + b * c);
+        }
+        FourierTransform::transform2D(product.data(), fftRows, fftCols, true);
+
+        int first = 2 * (int)p;
+        int second = first + 1 < kernels ? first + 1 : -1;
+        TaskScheduler::parallelFor(0, mapRows, 8, [&](int y0, int y1) {
+            for (int y = y0; y < y1; y++) {
+                const complex<double> *c = product.data() + (size_t)y * fftCols;
+                double *d = distance.data() + (size_t)y * mapCols;
+                for (int x = 0; x < mapCols; x++) {
+                    double a = c[x].real();
+                    d[x] -= first < k ? (a - averageWeights[first]) * (a - averageWeights[first])
+                        : 2 * a;
+                    if (second >= 0) {
+                        double b = c[x].imag();
+                        d[x] -= second < k ? (b - averageWeights[second]) * (b - averageWeights[second])
+                            : 2 * b;
+                    }
+                }
+            }
+        });
+    }
+
+    Matrix *map = new Matrix(mapRows, mapCols);
+    for (int y = 0; y < mapRows; y++) {
+        float *row = map->getData() + (size_t)y * map->stride();
+        for (int x = 0; x < mapCols; x++)
+            row[x] = (float)sqrt(max(distance[(size_t)y * mapCols + x], 0.0));
+    }
+    return map;
+}
+
+vector<FaceDetector::Detection> FaceDetector::detect(const Matrix *frame,
+                                                     float threshold,
+                                                     const vector<float> &scales,
+                                                     float overlap) const {
+    int rows = frame->rows();
+    int cols = frame->cols();
+
+    // The frame, contiguous, to be resampled
+    vector<float> pixels((size_t)rows * cols);
+    for (int r = 0; r < rows; r++)
+        std::copy(frame->getData() + (size_t)r * frame->stride(),
+                  frame->getData() + (size_t)r * frame->stride() + cols,
+                  pixels.data() + (size_t)r * cols);
+
+    vector<Detection> candidates;
+    for (size_t s = 0; s < scales.size(); s++) {
+        if (scales[s] <= 0 || scales[s] > 1)
+            throw "Scales must be in (0, 1]";
+        int scaledRows = (int)(rows * scales[s]);
+        int scaledCols = (int)(cols * scales[s]);
+        if (scaledRows < height || scaledCols < width)
+            continue;
+        Matrix *scaled = new Matrix(scaledRows, scaledCols);
+        ImagePreprocessor::resample(pixels.data(), cols, rows, 1,
+                                    scaled->getData(), scaledCols, scaledRows, 1);
+        Matrix *map = faceMap(scaled);
+        delete scaled;
+
+        // Local minima of the face map under the threshold
+        double sx = (double)scaledCols / cols;
+        double sy = (double)scaledRows / rows;
+        for (int y = 0; y < map->rows(); y++) {
+            for (int x = 0; x < map->cols(); x++) {
+                float d = map->get(y, x);
+                if (d >= threshold)
+                    continue;
+                bool minimum = true;
+                for (int dy = -1; dy <= 1 && minimum; dy++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        int ny = y + dy, nx = x + dx;
+                        if ((dy != 0 || dx != 0) && ny >= 0 && nx >= 0
+                            && ny < map->rows() && nx < map->cols()
+                            && map->get(ny, nx) < d) {
+                            minimum = false;
+                            break;
+                        }
+                    }
+                }
+                if (!minimum)
+                    continue;
+                Detection detection;
+                detection.x = (int)lround(x / sx);
+                detection.y = (int)lround(y / sy);
+                detection.width = (int)lround(width / sx);
+                detection.height = (int)lround(height / sy);
+                detection.distance = d;
+                detection.scale = scales[s];
+                candidates.push_back(detection);
+            }
+        }
+        delete map;
+    }
+
+    // Greedy non-maximum suppression, nearest to face space first
+    sort(candidates.begin(), candidates.end(),
+         [](const Detection &a, const Detection &b) {
+             return a.distance < b.distance;
+         });
+    vector<Detection> detections;
+    for (size_t c = 0; c < candidates.size(); c++) {
+        bool kept = true;
+        for (size_t d = 0; d < detections.size() && kept; d++)
+            kept = overlapOf(candidates[c], detections[d]) <= overlap;
+        if (kept)
+            detections.push_back(candidates[c]);
+    }
+    return detections;
+}
@@ -0,0 +1,213 @@
+//
+//  FaceGallery.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <cfloat>
+#include <cmath>
+
+#include "FaceGallery.h"
+#include "MatrixMultiplier.h"
+#include "NearestNeighborIndex.h"
+
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+namespace {
+    // Probes scored per pair of GEMMs, bounding the score matrix
+    const int BATCH = 256;
+}
+
+FaceGallery::FaceGallery(const Matrix *eigenfaces,
+                         const ColumnVector *averageFace) {
+    if (eigenfaces->rows() != averageFace->rows())
+        throw "Matrices do not match";
+    this->eigenfaces = eigenfaces;
+    this->averageFace = averageFace;
+    
+    int k = eigenfaces->cols();
+    this->averageWeights = new ColumnVector(k);
+    MatrixMultiplier::gemm(true, false, k, 1, eigenfaces->rows(),
+                           1.0f, eigenfaces->getData(), eigenfaces->stride(),
+                           averageFace->getData(), averageFace->stride(),
+                           0.0f, averageWeights->getData(),
+                           averageWeights->stride());
+    this->classWeights = new Matrix(k, 0);
+    this->index = NULL;
+}
+
+FaceGallery::FaceGallery(int numSubjects, const Subject *subjects[],
+                         const Matrix *eigenfaces,
+                         const ColumnVector *averageFace)
+    : FaceGallery(eigenfaces, averageFace) {
+    for (int i = 0; i < numSubjects; i++)
+        enroll(subjects[i]);
+}
+
+FaceGallery::~FaceGallery(void) {
+    delete averageWeights;
+    delete classWeights;
+    delete index;
+}
+
+int FaceGallery::enroll(const Subject *subject) {
+    // The average of the weights of the images is, by linearity, the
+    //  weights of their average
+    const ColumnVector *meanImage = subject->getImages()->averageColumn();
+    Matrix *weights = project(meanImage);
+    delete meanImage;
+    
+    ColumnVector *classVector = weights->columnView(0);
+    classWeights->addColumn(classVector);
+    classNorms.push_back(Matrix::dotProduct(classVector, classVector));
+    subjects.push_back(subject);
+    if (index != NULL)
+        index->add(classVector->getData());
+    delete classVector;
+    delete weights;
+    return (int)subjects.size() - 1;
+}
+
+void FaceGallery::useIndex(NearestNeighborIndex *index) {
+    if (index->dimension() != dimension())
+        throw "Index dimension does not match";
+    if (index->size() != 0)
+        throw "Index is not empty";
+    if (size() > 0)
+        index->build(classWeights);
+    delete this->index;
+    this->index = index;
+}
+
+int FaceGallery::size(void) const {
+    return (int)subjects.size();
+}
+
+int FaceGallery::dimension(void) const {
+    return eigenfaces->cols();
+}
+
+const Subject* FaceGallery::getSubject(int index) const {
+    return subjects[index];
+}
+
+int FaceGallery::indexOf(const Subject *subject) const {
+    for (size_t i = 0; i < subjects.size(); i++)
+        if (subjects[i] == subject)
+            return (int)i;
+    return -1;
+}
+
+const Matrix* FaceGallery::getClassWeights(void) const {
+    return classWeights;
+}
+
+ColumnVector* FaceGallery::getClassVector(int index) const {
+    return classWeights->getColumn(index);
+}
+
+Matrix* FaceGallery::project(const Matrix *images) const {
+    if (images->rows() != eigenfaces->rows())
+        throw "Matrices do not match";
+    int k = eigenfaces->cols();
+    int b = images->cols();
+    
+    // transpose(E) * (X - psi) = transpose(E) * X - transpose(E) * psi
+    Matrix *weights = new Matrix(k, b);
+    MatrixMultiplier::gemm(true, false, k, b, eigenfaces->rows(),
+                           1.0f, eigenfaces->getData(), eigenfaces->stride(),
+                           images->getData(), images->stride(),
+                           0.0f, weights->getData(), weights->stride());
+    for (int i = 0; i < k; i++) {
+        float *row = weights->getData() + (size_t)i * weights->stride();
+        float mean = averageWeights->get(i);
+        for (int j = 0; j < b; j++)
+            row[j] -= mean;
+    }
+    return weights;
+}
+
+void FaceGallery::nearest(const float *w, int ldw, int count,
+                          int *index, float *distance) const {
+    int k = eigenfaces->cols();
+    if (this->index != NULL) {
+        // The index wants each query contiguous
+        std::vector<float> query(k);
+        for (int p = 0; p < count; p++) {
+            for (int i = 0; i < k; i++)
+                query[i] = w[(size_t)i * ldw + p];
+            float d;
+            if (this->index->search(&query[0], 1, index + p, &d) == 0)
+                throw "Index returned no match";
+            if (distance != NULL)
+                distance[p] = std::sqrt(d);
+        }
+        return;
+    }
+    
+    int s = size();
+    Matrix *scores = new Matrix(count, s);
+    
+    // scores = transpose(W) * C, the dot products of probes and classes
+    MatrixMultiplier::gemm(true, false, count, s, k,
+                           1.0f, w, ldw,
+                           classWeights->getData(), classWeights->stride(),
+                           0.0f, scores->getData(), scores->stride());
+    
+    for (int p = 0; p < count; p++) {
+        const float *row = scores->getData() + (size_t)p * scores->stride();
+        int best = 0;
+        float bestScore = FLT_MAX;
+        for (int c = 0; c < s; c++) {
+            float score = classNorms[c] - 2 * row[c];
+            if (score < bestScore) {
+                bestScore = score;
+                best = c;
+            }
+        }
+        index[p] = best;
+        
+        // The expanded form cancels badly near a match; recompute directly
+        if (distance != NULL) {
+            float sum = 0;
+            for (int i = 0; i < k; i++) {
+                float d = w[(size_t)i * ldw + p]
+                    - classWeights->get(i, best);
+                sum += d * d;
+            }
+            distance[p] = std::sqrt(sum);
+        }
+    }
+    delete scores;
+}
+
+const Subject* FaceGallery::recognize(const ColumnVector *probe,
+                                      float *distance) const {
+    const Subject *match;
+    recognizeBatch(probe, &match, distance);
+    return match;
+}
+
+void FaceGallery::recognizeBatch(const Matrix *probes, const Subject **matches,
+                                 float *distances) const {
+    if (size() == 0)
+        throw "No subjects enrolled";
+    
+    int index[BATCH];
+    for (int p0 = 0; p0 < probes->cols(); p0 += BATCH) {
+        int count = std::min(BATCH, probes->cols() - p0);
+        Matrix *batch = Matrix::view(probes, 0, p0, probes->rows(), count);
+        Matrix *weights = project(batch);
+        nearest(weights->getData(), weights->stride(), count, index,
+                distances == NULL ? NULL : distances + p0);
+        for (int p = 0; p < count; p++)
+            matches[p0 + p] = subjects[index[p]];
+        delete weights;
+        delete batch;
+    }
+}
@@ -0,0 +1,263 @@
+//
+//  FaceProjector.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "FaceProjector.h"
+#include "MatrixMultiplier.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FACEPROJECTOR_X86
+#endif
+
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+namespace {
+    
+    /**
+     * Adds, for each of the n pixels, (x - mu) times its row of e (width
+     *  floats, lde between rows) onto w, keeping w in registers. When ss is
+     *  not NULL it also receives |x - mu|^2. width is at most the block
+     *  width of the kernel
+     */
+    typedef void (*BlockKernel)(int n, int width,
+                                const float *e, int lde,
+                                const float *x, int incx,
+                                const float *mu, int incm,
+                                float *w, float *ss);
+    
+    struct KernelInfo {
+        int block;
+        BlockKernel kernel;
+    };
+    
+    // Below this fraction of |phi|^2 the Gram form of the residual loses
+    //  too many digits to cancellation, and it is recomputed directly
+    const double CANCELLATION = 1e-2;
+    
+    void blockGeneric(int n, int width, const float *e, int lde,
+                      const float *x, int incx, const float *mu, int incm,
+                      float *w, float *ss) {
+        float acc[16];
+        memset(acc, 0, sizeof(acc));
+        float sum = 0;
+        for (int p = 0; p < n; p++) {
+            float phi = x[(size_t)p * incx] - mu[(size_t)p * incm];
+            const float *row = e + (size_t)p * lde;
+            sum += phi * phi;
+            for (int j = 0; j < width; j++)
+                acc[j] += phi * row[j];
+        }
+        for (int j = 0; j < width; j++)
+            w[j] += acc[j];
+        if (ss != NULL)
+            *ss = sum;
+    }
+    
+#ifdef FACEPROJECTOR_X86
+    // C ymm accumulators (8 weights each), the last one masked
+    template <int C>
+    __attribute__((target("avx2,fma")))
+    void blockAvx2(int n, int width, const float *e, int lde,
+                   const float *x, int incx, const float *mu, int incm,
+                   float *w, float *ss) {
+        int tail = width - 8 * (C - 1);
+        __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(tail),
+                                          _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256 acc[C];
+#pragma GCC unroll 4
+        for (int c = 0; c < C; c++)
+            acc[c] = _mm256_setzero_ps();
+        float sum = 0;
+        for (int p = 0; p < n; p++) {
+            float phi = x[(size_t)p * incx] - mu[(size_t)p * incm];
+            __m256 vphi = _mm256_set1_ps(phi);
+            const float *row = e + (size_t)p * lde;
+            sum += phi * phi;
+#pragma GCC unroll 4
+            for (int c = 0; c < C - 1; c++)
+                acc[c] = _mm256_fmadd_ps(vphi, _mm256_loadu_ps(row + 8 * c), acc[c]);
+            acc[C - 1] = _mm256_fmadd_ps(vphi,
+                                         _mm256_maskload_ps(row + 8 * (C - 1), mask),
+                                         acc[C - 1]);
+        }
+#pragma GCC unroll 4
+        for (int c = 0; c < C - 1; c++)
+            _mm256_storeu_ps(w + 8 * c, _mm256_add_ps(_mm256_loadu_ps(w + 8 * c), acc[c]));
+        __m256 last = _mm256_add_ps(_mm256_maskload_ps(w + 8 * (C - 1), mask),
+                                    acc[C - 1]);
+        _mm256_maskstore_ps(w + 8 * (C - 1), mask, last);
+        if (ss != NULL)
+            *ss = sum;
+    }
+    
+    __attribute__((target("avx2,fma")))
+    void blockAvx2Any(int n, int width, const float *e, int lde,
+                      const float *x, int incx, const float *mu, int incm,
+                      float *w, float *ss) {
+        switch ((width + 7) / 8) {
+            case 1: blockAvx2<1>(n, width, e, lde, x, incx, mu, incm, w, ss); break;
+            case 2: blockAvx2<2>(n, width, e, lde, x, incx, mu, incm, w, ss); break;
+            case 3: blockAvx2<3>(n, width, e, lde, x, incx, mu, incm, w, ss); break;
+            default: blockAvx2<4>(n, width, e, lde, x, incx, mu, incm, w, ss); break;
+        }
+    }
+    
+    // C zmm accumulators (16 weights each), the last one masked
+    template <int C>
+    __attribute__((target("avx512f")))
+    void blockAvx512(int n, int width, const float *e, int lde,
+                     const float *x, int incx, const float *mu, int incm,
+                     float *w, float *ss) {
+        int tail = width - 16 * (C - 1);
+        __mmask16 mask = (__mmask16)((1u << tail) - 1);
+        __m512 acc[C];
+#pragma GCC unroll 4
+        for (int c = 0; c < C; c++)
+            acc[c] = _mm512_setzero_ps();
+        float sum = 0;
+        for (int p = 0; p < n; p++) {
+            float phi = x[(size_t)p * incx] - mu[(size_t)p * incm];
+            __m512 vphi = _mm512_set1_ps(phi);
+            const float *row = e + (size_t)p * lde;
+            sum += phi * phi;
+#pragma GCC unroll 4
+            for (int c = 0; c < C - 1; c++)
+                acc[c] = _mm512_fmadd_ps(vphi, _mm512_loadu_ps(row + 16 * c), acc[c]);
+            acc[C - 1] = _mm512_fmadd_ps(vphi,
+                                         _mm512_maskz_loadu_ps(mask, row + 16 * (C - 1)),
+                                         acc[C - 1]);
+        }
+#pragma GCC unroll 4
+        for (int c = 0; c < C - 1; c++)
+            _mm512_storeu_ps(w + 16 * c, _mm512_add_ps(_mm512_loadu_ps(w + 16 * c), acc[c]));
+        __m512 last = _mm512_add_ps(_mm512_maskz_loadu_ps(mask, w + 16 * (C - 1)),
+                                    acc[C - 1]);
+        _mm512_mask_storeu_ps(w + 16 * (C - 1), mask, last);
+        if (ss != NULL)
+            *ss = sum;
+    }
+    
+    __attribute__((target("avx512f")))
+    void blockAvx512Any(int n, int width, const float *e, int lde,
+                        const float *x, int incx, const float *mu, int incm,
+                        float *w, float *ss) {
+        switch ((width + 15) / 16) {
+            case 1: blockAvx512<1>(n, width, e, lde, x, incx, mu, incm, w, ss); break;
+            case 2: blockAvx512<2>(n, width, e, lde, x, incx, mu, incm, w, ss); break;
+            case 3: blockAvx512<3>(n, width, e, lde, x, incx, mu, incm, w, ss); break;
+            default: blockAvx512<4>(n, width, e, lde, x, incx, mu, incm, w, ss); break;
+        }
+    }
+#endif
+    
+    KernelInfo detectKernel(void) {
+        KernelInfo generic = { 16, blockGeneric };
+#ifdef FACEPROJECTOR_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            KernelInfo info = { 64, blockAvx512Any };
+            return info;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            KernelInfo info = { 32, blockAvx2Any };
+            return info;
+        }
+#endif
+        return generic;
+    }
+    
+    const KernelInfo& selectKernel(void) {
+        static const KernelInfo info = detectKernel();
+        return info;
+    }
+}
+
+FaceProjector::FaceProjector(const Matrix *eigenfaces,
+                             const ColumnVector *averageFace) {
+    if (eigenfaces->rows() != averageFace->rows())
+        throw "Matrices do not match";
+    this->eigenfaces = eigenfaces;
+    this->averageFace = averageFace;
+    
+    int k = eigenfaces->cols();
+    gram.assign((size_t)k * k, 0.0f);
+    if (k > 0) {
+        MatrixMultiplier::syrk(k, eigenfaces->rows(), 1.0f,
+                               eigenfaces->getData(), eigenfaces->stride(),
+                               0.0f, &gram[0], k);
+        MatrixMultiplier::symmetrize(k, &gram[0], k);
+    }
+}
+
+int FaceProjector::dimension(void) const {
+    return eigenfaces->cols();
+}
+
+float FaceProjector::project(const ColumnVector *image, float *weights) const {
+    int n = eigenfaces->rows();
+    int k = eigenfaces->cols();
+    if (image->rows() != n)
+        throw "Matrices do not match";
+    
+    const KernelInfo &ki = selectKernel();
+    const float *e = eigenfaces->getData();
+    int lde = eigenfaces->stride();
+    const float *x = image->getData();
+    const float *mu = averageFace->getData();
+    
+    // Each block of weights sweeps its own columns of E, so E is read once
+    //  whatever k is; only the probe is re-read, and it stays in cache
+    memset(weights, 0, (size_t)k * sizeof(float));
+    float phiNorm2 = 0;
+    if (k == 0) {
+        for (int p = 0; p < n; p++) {
+            float phi = x[(size_t)p * image->stride()]
+                - mu[(size_t)p * averageFace->stride()];
+            phiNorm2 += phi * phi;
+        }
+        return std::sqrt(phiNorm2);
+    }
+    for (int j0 = 0; j0 < k; j0 += ki.block) {
+        int width = std::min(ki.block, k - j0);
+        ki.kernel(n, width, e + j0, lde, x, image->stride(),
+                  mu, averageFace->stride(), weights + j0,
+                  j0 == 0 ? &phiNorm2 : NULL);
+    }
+    
+    // |phi - E w|^2 = |phi|^2 - 2 |w|^2 + transpose(w) * G * w
+    double wNorm2 = 0;
+    double wGw = 0;
+    for (int i = 0; i < k; i++) {
+        const float *g = &gram[(size_t)i * k];
+        double gw = 0;
+        for (int j = 0; j < k; j++)
+            gw += (double)g[j] * weights[j];
+        wNorm2 += (double)weights[i] * weights[i];
+        wGw += weights[i] * gw;
+    }
+    double residual2 = phiNorm2 - 2 * wNorm2 + wGw;
+    if (residual2 >= CANCELLATION * phiNorm2)
+        return (float)std::sqrt(residual2);
+    
+    // Too close to face space for the expansion; reconstruct pixel by pixel
+    double sum = 0;
+    for (int p = 0; p < n; p++) {
+        float phi = x[(size_t)p * image->stride()]
+            - mu[(size_t)p * averageFace->stride()];
+        float r = phi - MatrixMultiplier::dot(k, e + (size_t)p * lde, weights);
+        sum += (double)r * r;
+    }
+    return (float)std::sqrt(sum);
+}
@@ -0,0 +1,53 @@
+//
+//  FaceScorer.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <cmath>
+
+#include "FaceScorer.h"
+#include "NearestNeighborIndex.h"
+
+using namespace csc450Lib_linalg_eigensystems;
+
+FaceScorer::FaceScorer(int dimension, int features, ScoringMetric metric) {
+    if (dimension < 1 || features < 1)
+        throw "Scorer needs at least one dimension";
+    this->inputs = dimension;
+    this->outputs = features;
+    this->metric = metric;
+}
+
+FaceScorer::~FaceScorer(void) {}
+
+int FaceScorer::dimension(void) const {
+    return inputs;
+}
+
+int FaceScorer::features(void) const {
+    return outputs;
+}
+
+ScoringMetric FaceScorer::getMetric(void) const {
+    return metric;
+}
+
+float FaceScorer::distance(const float *a, const float *b) const {
+    if (metric == SCORE_EUCLIDEAN)
+        return std::sqrt(NearestNeighborIndex::squaredDistance(outputs, a, b));
+    
+    double ab = 0, aa = 0, bb = 0;
+    for (int i = 0; i < outputs; i++) {
+        ab += (double)a[i] * b[i];
+        aa += (double)a[i] * a[i];
+        bb += (double)b[i] * b[i];
+    }
+    if (aa == 0 || bb == 0)
+        return 1;
+    return (float)(1 - ab / std::sqrt(aa * bb));
+}
@@ -0,0 +1,180 @@
+//
+//  FaceScorer_fisher.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "FaceScorer_fisher.h"
+#include "EigenSystem.h"
+#include "EigenSystemSolver.h"
+#include "LinearSolver_Cholesky.h"
+#include "MatrixMultiplier.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_sle;
+using namespace csc450Lib_linalg_eigensystems;
+
+FaceScorer_fisher::FaceScorer_fisher(Matrix *directions, ScoringMetric metric)
+    : FaceScorer(directions->rows(), directions->cols(), metric) {
+    this->directions = directions;
+}
+
+FaceScorer_fisher::~FaceScorer_fisher(void) {
+    delete directions;
+}
+
+FaceScorer_fisher* FaceScorer_fisher::train(int numSubjects,
+                                            const Subject *subjects[],
+                                            const Matrix *eigenfaces,
+                                            const ColumnVector *averageFace,
+                                            int features,
+                                            ScoringMetric metric,
+                                            float regularization) {
+    if (numSubjects < 2)
+        throw "Fisherfaces need at least two subjects";
+    if (eigenfaces->rows() != averageFace->rows())
+        throw "Matrices do not match";
+    int pixels = eigenfaces->rows();
+    int k = eigenfaces->cols();
+    if (features <= 0 || features > numSubjects - 1)
+        features = numSubjects - 1;
+    features = min(features, k);
+    for (int s = 0; s < numSubjects; s++) {
+        const Matrix *images = subjects[s]->getImages();
+        if (images->rows() != pixels)
+            throw "Matrices do not match";
+        if (images->cols() < 1)
+            throw "Subject has no images";
+    }
+    
+    // Weights of the average face, taken off every projection
+    vector<float> averageWeights(k);
+    MatrixMultiplier::gemm(true, false, k, 1, pixels,
+                           1.0f, eigenfaces->getData(), eigenfaces->stride(),
+                           averageFace->getData(), averageFace->stride(),
+                           0.0f, &averageWeights[0], 1);
+    
+    // Sw accumulates the centered weights of each subject; the class means
+    //  are kept for Sb
+    Matrix *within = new Matrix(k, k);
+    Matrix *means = new Matrix(k, numSubjects);
+    vector<int> counts(numSubjects);
+    vector<double> total(k, 0.0);
+    int count = 0;
+    for (int s = 0; s < numSubjects; s++) {
+        const Matrix *images = subjects[s]->getImages();
+        int n = images->cols();
+        // One image per row, as syrk wants them
+        Matrix *weights = new Matrix(n, k);
+        MatrixMultiplier::gemm(true, false, n, k, pixels,
+                               1.0f, images->getData(), images->stride(),
+                               eigenfaces->getData(), eigenfaces->stride(),
+                               0.0f, weights->getData(), weights->stride());
+        vector<double> sum(k, 0.0);
+        for (int j = 0; j < n; j++) {
+            const float *row = weights->getData() + (size_t)j * weights->stride();
+            for (int i = 0; i < k; i++)
+                sum[i] += row[i];
+        }
+        for (int i = 0; i < k; i++) {
+            float mean = (float)(sum[i] / n);
+            means->set(i, s, mean - averageWeights[i]);
+            total[i] += sum[i] - (double)n * averageWeights[i];
+        }
+        for (int j = 0; j < n; j++) {
+            float *row = weights->getData() + (size_t)j * weights->stride();
+            for (int i = 0; i < k; i++)
+                row[i] -= means->get(i, s) + averageWeights[i];
+        }
+        MatrixMultiplier::syrk(k, n, 1.0f, weights->getData(), weights->stride(),
+                               1.0f, within->getData(), within->stride());
+        delete weights;
+        counts[s] = n;
+        count += n;
+    }
+    
+    // Sb = B * transpose(B), the columns of B sqrt(n_s) (m_s - m)
+    Matrix *between = means;
+    for (int s = 0; s < numSubjects; s++) {
+        float scale = sqrt((float)counts[s]);
+        for (int i = 0; i < k; i++)
+            between->set(i, s, scale * (between->get(i, s) - (float)(total[i] / count)));
+    }
+    
+    // With Sw = transpose(U) * U, the problem is the symmetric one
+    //  M * transpose(M) y = lambda y for M = inverse(transpose(U)) * B,
+    //  and v = inverse(U) * y
+    double trace = 0;
+    for (int i = 0; i < k; i++)
+        trace += within->get(i, i);
+    float ridge = (float)(regularization * trace / k);
+    if (ridge <= 0)
+        ridge = regularization;
+    for (int i = 0; i < k; i++)
+        within->set(i, i, within->get(i, i) + ridge);
+    if (!LinearSolver_Cholesky::factorizeInPlace(within)) {
+        delete within;
+        delete between;
+        throw "Within-class scatter is not positive definite";
+    }
+    MatrixMultiplier::trsm(true, true, false, k, numSubjects,
+                           within->getData(), within->stride(),
+                           between->getData(), between->stride());
+    Matrix *reduced = new Matrix(k, k);
+    MatrixMultiplier::gemm(false, true, k, k, numSubjects,
+                           1.0f, between->getData(), between->stride(),
+                           between->getData(), between->stride(),
+                           0.0f, reduced->getData(), reduced->stride());
+    delete between;
+    
+    EigenSystem *system = EigenSystemSolver::symmetricQR(reduced);
+    delete reduced;
+    Matrix *directions = new Matrix(k, features);
+    const Matrix *y = system->getEigenVectors();
+    for (int i = 0; i < k; i++)
+        for (int j = 0; j < features; j++)
+            directions->set(i, j, y->get(i, j));
+    delete system;
+    MatrixMultiplier::trsm(true, false, false, k, features,
+                           within->getData(), within->stride(),
+                           directions->getData(), directions->stride());
+    delete within;
+    
+    return new FaceScorer_fisher(directions, metric);
+}
+
+const Matrix* FaceScorer_fisher::getDirections(void) const {
+    return directions;
+}
+
+Matrix* FaceScorer_fisher::getFisherfaces(const Matrix *eigenfaces) const {
+    if (eigenfaces->cols() != inputs)
+        throw "Matrices do not match";
+    Matrix *fisherfaces = new Matrix(eigenfaces->rows(), outputs);
+    MatrixMultiplier::gemm(false, false, eigenfaces->rows(), outputs, inputs,
+                           1.0f, eigenfaces->getData(), eigenfaces->stride(),
+                           directions->getData(), directions->stride(),
+                           0.0f, fisherfaces->getData(), fisherfaces->stride());
+    return fisherfaces;
+}
+
+void FaceScorer_fisher::transform(const float *weights, float *features) const {
+    // transpose(V) * w, a row of V at a time so that the loads stay
+    //  contiguous
+    std::fill(features, features + outputs, 0.0f);
+    for (int i = 0; i < inputs; i++) {
+        const float *row = directions->getData() + (size_t)i * directions->stride();
+        float w = weights[i];
+        for (int j = 0; j < outputs; j++)
+            features[j] += w * row[j];
+    }
+}
@@ -0,0 +1,22 @@
+//
+//  FaceScorer_pca.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <algorithm>
+
+#include "FaceScorer_pca.h"
+
+using namespace csc450Lib_linalg_eigensystems;
+
+FaceScorer_pca::FaceScorer_pca(int k, ScoringMetric metric)
+    : FaceScorer(k, k, metric) {}
+
+void FaceScorer_pca::transform(const float *weights, float *features) const {
+    std::copy(weights, weights + inputs, features);
+}
@@ -0,0 +1,40 @@
+//
+//  FaceScorer_whitened.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <algorithm>
+#include <cmath>
+
+#include "FaceScorer_whitened.h"
+
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+FaceScorer_whitened::FaceScorer_whitened(const ColumnVector *eigenvalues,
+                                         ScoringMetric metric,
+                                         float regularization)
+    : FaceScorer(eigenvalues->rows(), eigenvalues->rows(), metric) {
+    float largest = 0;
+    for (int j = 0; j < inputs; j++)
+        largest = std::max(largest, eigenvalues->get(j));
+    if (largest <= 0)
+        throw "Eigenvalues must be positive";
+    
+    // The scale of the eigenvalues does not change the ranking, so the
+    //  number of training images is left out of the variance
+    float floor = regularization * largest;
+    scale.resize(inputs);
+    for (int j = 0; j < inputs; j++)
+        scale[j] = 1.0f / std::sqrt(std::max(eigenvalues->get(j), 0.0f) + floor);
+}
+
+void FaceScorer_whitened::transform(const float *weights, float *features) const {
+    for (int j = 0; j < inputs; j++)
+        features[j] = weights[j] * scale[j];
+}
@@ -9,13 +9,22 @@
 
 //=================================
 // included dependencies
+#include <cmath>
+#include <vector>
+
 #include "FacialRecognizer.h"
 
 using namespace csc450Lib_linalg_base;
 using namespace csc450Lib_linalg_eigensystems;
 
 
-FacialRecognizer::FacialRecognizer(void) {}
+FacialRecognizer::FacialRecognizer(void) {
+    this->input = NULL;
+    this->gallery = NULL;
+    this->projector = NULL;
+    this->scorer = NULL;
+    this->classFeatures = NULL;
+}
 
 FacialRecognizer::FacialRecognizer(int numFaceClasses,
                                    const Subject *faceclasses[],
@@ -25,6 +34,12 @@ FacialRecognizer::FacialRecognizer(int numFaceClasses,
     this->faceclasses = faceclasses;
     this->eigenfaces = eigenfaces;
     this->averageFace = averageFace;
+    this->input = NULL;
+    this->gallery = new FaceGallery(numFaceClasses, faceclasses,
+                                    eigenfaces, averageFace);
+    this->projector = new FaceProjector(eigenfaces, averageFace);
+    this->scorer = NULL;
+    this->classFeatures = NULL;
 }
 
 FacialRecognizer::FacialRecognizer(int numFaceClasses,
@@ -36,36 +51,128 @@ FacialRecognizer::FacialRecognizer(int numFaceClasses,
     this->faceclasses = faceclasses;
     this->eigenfaces = eigenfaces;
     this->averageFace = averageFace;
-    this->input = (ColumnVector*)Matrix::copyOf(input);
+    this->input = NULL;
+    setInput(input);
+    this->gallery = new FaceGallery(numFaceClasses, faceclasses,
+                                    eigenfaces, averageFace);
+    this->projector = new FaceProjector(eigenfaces, averageFace);
+    this->scorer = NULL;
+    this->classFeatures = NULL;
 }
 
 FacialRecognizer::~FacialRecognizer(void) {
+    delete input;
+    delete gallery;
+    delete projector;
+    delete scorer;
+    delete classFeatures;
+}
+
+void FacialRecognizer::setScorer(FaceScorer *scorer) {
+    if (gallery == NULL)
+        throw "No subjects enrolled";
+    if (scorer != NULL && scorer->dimension() != eigenfaces->cols())
+        throw "Scorer dimension does not match";
+    delete this->scorer;
+    delete this->classFeatures;
+    this->scorer = scorer;
+    this->classFeatures = NULL;
+    if (scorer == NULL)
+        return;
     
+    // The class vectors are mapped once; a probe then costs one
+    //  projection, one transform and numFaceClasses short distances
+    const Matrix *classWeights = gallery->getClassWeights();
+    int k = classWeights->rows();
+    std::vector<float> weights(k);
+    classFeatures = new Matrix(numFaceClasses, scorer->features());
+    for (int s = 0; s < numFaceClasses; s++) {
+        for (int i = 0; i < k; i++)
+            weights[i] = classWeights->get(i, s);
+        scorer->transform(&weights[0],
+                          classFeatures->getData() + (size_t)s * classFeatures->stride());
+    }
 }
 
-float FacialRecognizer::distFromFaceSpace() const {
-    ColumnVector *phi = (ColumnVector*)Matrix::subtract(input, averageFace);
-    ColumnVector *weights = getWeights(input);
-    ColumnVector *phif = (ColumnVector*)Matrix::multiply(weights->get(0), eigenfaces->getColumn(0));
-    for (int i = 1; i < eigenfaces->cols(); i++) {
-        phif = (ColumnVector*)Matrix::add(phif, Matrix::multiply(weights->get(i), eigenfaces->getColumn(i)));
+const FaceScorer* FacialRecognizer::getScorer(void) const {
+    return scorer;
+}
+
+int FacialRecognizer::nearestClass(float *distance) const {
+    // Scratch of the calling thread, so that one recognizer can be queried
+    //  from several threads at once
+    static thread_local std::vector<float> projection;
+    static thread_local std::vector<float> features;
+    projection.resize(eigenfaces->cols());
+    features.resize(scorer->features());
+    projector->project(input, &projection[0]);
+    scorer->transform(&projection[0], &features[0]);
+    int nearest = -1;
+    float best = 0;
+    for (int s = 0; s < numFaceClasses; s++) {
+        float d = scorer->distance(&features[0],
+                                   classFeatures->getData() + (size_t)s * classFeatures->stride());
+        if (nearest < 0 || d < best) {
+            nearest = s;
+            best = d;
+        }
     }
-    return ((ColumnVector*)Matrix::subtract(phi, phif))->norm2();
+    if (nearest < 0)
+        throw "No subjects enrolled";
+    if (distance != NULL)
+        *distance = best;
+    return nearest;
+}
+
+float FacialRecognizer::distFromFaceSpace() const {
+    static thread_local std::vector<float> projection;
+    projection.resize(eigenfaces->cols());
+    return projector->project(input, &projection[0]);
 }
 
 float FacialRecognizer::distFromFaceClass(const Subject* subject) const {
+    static thread_local std::vector<float> projection;
+    static thread_local std::vector<float> features;
+    int index = gallery->indexOf(subject);
+    if (index >= 0)
+        projection.resize(eigenfaces->cols());
+    if (index >= 0 && scorer != NULL) {
+        features.resize(scorer->features());
+        projector->project(input, &projection[0]);
+        scorer->transform(&projection[0], &features[0]);
+        return scorer->distance(&features[0],
+                                classFeatures->getData() + (size_t)index * classFeatures->stride());
+    }
+    if (index >= 0) {
+        projector->project(input, &projection[0]);
+        const Matrix *classWeights = gallery->getClassWeights();
+        float dist = 0;
+        for (int i = 0; i < classWeights->rows(); i++) {
+            float d = projection[i] - classWeights->get(i, index);
+            dist += d * d;
+        }
+        return std::sqrt(dist);
+    }
+    
     ColumnVector *weights = getWeights(input);
     ColumnVector *classVector = (ColumnVector*)Matrix::copyOf(subject->calculateClassVector(eigenfaces, averageFace));
     return ((ColumnVector*)Matrix::subtract(weights,classVector))->norm2();
 }
 
 
+void FacialRecognizer::setInput(const ColumnVector *input) {
+    // Copied into a vector of its own, so that probes of one size reuse
+    //  it and it can be released with the recognizer
+    if (this->input == NULL || this->input->rows() != input->rows()) {
+        delete this->input;
+        this->input = new ColumnVector(input->rows());
+    }
+    Matrix::copyInto(input, this->input);
+}
+
 ColumnVector* FacialRecognizer::getWeights(const ColumnVector *input) const {
     ColumnVector* weights = new ColumnVector(eigenfaces->cols());
-    for (int i = 0; i < eigenfaces->cols(); i++) {
-        weights->set(i,Matrix::multiply(Matrix::transpose(eigenfaces->getColumn(i)),
-                                        Matrix::subtract(input, averageFace))->get(0,0));
-    }
+    projector->project(input, weights->getData());
     return weights;
 }
 
@@ -75,42 +182,33 @@ bool FacialRecognizer::nearFaceSpace(float tol) const {
 }
 
 bool FacialRecognizer::nearFaceSpace(const ColumnVector *input, float tol) {
-    this->input = (ColumnVector*)Matrix::copyOf(input);
+    setInput(input);
     return nearFaceSpace(tol);
 }
 
 bool FacialRecognizer::nearFaceClass(float tol) const {
-    float dist = distFromFaceClass(faceclasses[0]);
-    float currentdist;
-    for (int i = 0; i < numFaceClasses; i++) {
-        currentdist = distFromFaceClass(faceclasses[i]);
-        if (currentdist < dist)
-            dist = currentdist;
+    float dist;
+    if (scorer != NULL) {
+        nearestClass(&dist);
+        return dist < tol;
     }
+    gallery->recognize(input, &dist);
     return dist < tol;
 }
 
 bool FacialRecognizer::nearFaceClass(const ColumnVector *input, float tol) {
-    this->input = (ColumnVector*)Matrix::copyOf(input);
+    setInput(input);
     return nearFaceClass(tol);
 }
 
 const Subject* FacialRecognizer::faceClass(void) const {
-    int retind = 0;
-    float dist = distFromFaceClass(faceclasses[0]);
-    float currentdist;
-    for (int i = 1; i < numFaceClasses; i++) {
-        currentdist = distFromFaceClass(faceclasses[i]);
-        if (currentdist < dist) {
-            retind = i;
-            dist = currentdist;
-        }
-    }
-    return faceclasses[retind];
+    if (scorer != NULL)
+        return faceclasses[nearestClass(NULL)];
+    return gallery->recognize(input);
 }
 
 const Subject* FacialRecognizer::faceClass(const ColumnVector *input) {
-    this->input = (ColumnVector*)Matrix::copyOf(input);
+    setInput(input);
     return faceClass();
     
 }
@@ -0,0 +1,417 @@
+//
+//  ModelFile.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+#include "ModelFile.h"
+#include "EigenfaceModel.h"
+#include "FaceGallery.h"
+#include "TaskScheduler.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MODELFILE_X86
+#endif
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+namespace {
+    
+    const char MAGIC[8] = { 'E', 'F', 'M', 'O', 'D', 'E', 'L', 0 };
+    const uint32_t VERSION = 1;
+    
+    struct ModelHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t length;
+        uint32_t dimension;
+        uint32_t subjects;
+        uint32_t images;
+        uint64_t meanOffset;
+        uint64_t eigenvalueOffset;
+        uint64_t scaleOffset;
+        uint64_t basisOffset;
+        uint64_t idOffset;
+        uint64_t weightOffset;
+        unsigned char reserved[40];
+    };
+    static_assert(sizeof(ModelHeader) == 128, "model header must be 128 bytes");
+    
+    size_t elementSize(BasisFormat format) {
+        switch (format) {
+            case BASIS_FLOAT16: return 2;
+            case BASIS_INT8: return 1;
+            default: return sizeof(float);
+        }
+    }
+    
+    size_t alignUp(size_t offset) {
+        return (offset + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+    }
+    
+    /** Rounds to the nearest half float, ties to even */
+    uint16_t toHalf(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        uint16_t sign = (bits >> 16) & 0x8000;
+        int exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+        uint32_t mantissa = bits & 0x7fffff;
+        
+        if (exponent >= 31) {
+            // Overflow, infinity or NaN
+            bool nan = ((bits >> 23) & 0xff) == 0xff && mantissa != 0;
+            return sign | 0x7c00 | (nan ? 0x200 : 0);
+        }
+        if (exponent <= 0) {
+            // Subnormal or zero: shift the implicit one in
+            if (exponent < -10)
+                return sign;
+            mantissa |= 0x800000;
+            int shift = 14 - exponent;
+            uint32_t half = mantissa >> shift;
+            uint32_t rest = mantissa & ((1u << shift) - 1);
+            uint32_t midpoint = 1u << (shift - 1);
+            if (rest > midpoint || (rest == midpoint && (half & 1)))
+                half++;
+            return sign | half;
+        }
+        uint32_t half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+        uint32_t rest = mantissa & 0x1fff;
+        if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+            half++;    // may carry into the exponent, which is still right
+        return sign | half;
+    }
+    
+    float fromHalf(uint16_t half) {
+        uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+        int exponent = (half >> 10) & 0x1f;
+        uint32_t mantissa = half & 0x3ff;
+        uint32_t bits;
+        if (exponent == 0x1f) {
+            bits = sign | 0x7f800000 | (mantissa << 13);
+        } else if (exponent != 0) {
+            bits = sign | ((uint32_t)(exponent - 15 + 127) << 23) | (mantissa << 13);
+        } else if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // Subnormal: normalize
+            int shift = 0;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                shift++;
+            }
+            bits = sign | ((uint32_t)(1 - 15 + 127 - shift) << 23)
+                | ((mantissa & 0x3ff) << 13);
+        }
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    
+    /** Sets dst[i] = half src[i] * scales[i], for i in [0, n) */
+    typedef void (*HalfKernel)(int n, const uint16_t *src,
+                               const float *scales, float *dst);
+    
+    void expandGeneric(int n, const uint16_t *src, const float *scales,
+                       float *dst) {
+        for (int i = 0; i < n; i++)
+            dst[i] = fromHalf(src[i]) * scales[i];
+    }
+    
+#ifdef MODELFILE_X86
+    __attribute__((target("avx,f16c")))
+    void expandF16c(int n, const uint16_t *src, const float *scales,
+                    float *dst) {
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 v = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i)));
+            _mm256_storeu_ps(dst + i, _mm256_mul_ps(v, _mm256_loadu_ps(scales + i)));
+        }
+        for (; i < n; i++)
+            dst[i] = fromHalf(src[i]) * scales[i];
+    }
+#endif
+    
+    HalfKernel selectHalfKernel(void) {
+#ifdef MODELFILE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c"))
+            return expandF16c;
+#endif
+        return expandGeneric;
+    }
+    
+    void pad(ofstream &out, size_t offset) {
+        static const char zeros[MATRIX_ALIGNMENT] = { 0 };
+        size_t position = (size_t)out.tellp();
+        if (offset > position)
+            out.write(zeros, offset - position);
+    }
+    
+    void writeFloats(ofstream &out, const vector<float> &values) {
+        out.write((const char*)values.data(), values.size() * sizeof(float));
+    }
+}
+
+ModelFile::ModelFile(const string &filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw "Cannot open model";
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(ModelHeader)) {
+        close(fd);
+        throw "Not a model file";
+    }
+    
+    // A private mapping shares its clean pages with every other process
+    //  mapping the file, and lets the float views be written to (copy on
+    //  write) without ever touching it
+    this->length = info.st_size;
+    void *p = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        throw "Cannot map model";
+    this->base = (unsigned char*)p;
+    
+    const ModelHeader *header = (const ModelHeader*)base;
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+        || header->version != VERSION
+        || header->format > BASIS_INT8) {
+        munmap(base, length);
+        throw "Not a model file";
+    }
+    this->format = (BasisFormat)header->format;
+    this->width = header->width;
+    this->height = header->height;
+    this->imageCount = header->images;
+    int n = header->length;
+    int k = header->dimension;
+    int s = header->subjects;
+    
+    // Every section must lie inside the mapping, written so that a huge
+    //  offset cannot wrap around, and start on an element boundary
+    size_t mapped = length;
+    auto fits = [mapped](uint64_t offset, size_t size) {
+        return offset <= mapped && size <= mapped - offset
+            && offset % sizeof(float) == 0;
+    };
+    if (!fits(header->meanOffset, (size_t)n * sizeof(float))
+        || !fits(header->eigenvalueOffset, (size_t)k * sizeof(float))
+        || !fits(header->scaleOffset, (size_t)k * sizeof(float))
+        || !fits(header->basisOffset, (size_t)n * k * elementSize(format))
+        || !fits(header->idOffset, (size_t)s * sizeof(int32_t))
+        || !fits(header->weightOffset, (size_t)k * s * sizeof(float))) {
+        munmap(base, length);
+        throw "Truncated model file";
+    }
+    
+    this->ids = (const int32_t*)(base + header->idOffset);
+    this->mean = new ColumnVector(n, (float*)(base + header->meanOffset), 1);
+    this->eigenvalues = new ColumnVector(k, (float*)(base + header->eigenvalueOffset), 1);
+    this->classWeights = new Matrix(k, s, (float*)(base + header->weightOffset), s);
+    
+    const unsigned char *basis = base + header->basisOffset;
+    if (format == BASIS_FLOAT32) {
+        this->eigenfaces = new Matrix(n, k, (float*)basis, k);
+        return;
+    }
+    
+    // Expand the quantized basis once; rows are independent
+    const float *scales = (const float*)(base + header->scaleOffset);
+    this->eigenfaces = new Matrix(n, k);
+    Matrix *e = eigenfaces;
+    BasisFormat f = format;
+    static const HalfKernel expandHalf = selectHalfKernel();
+    TaskScheduler::parallelFor(0, n, 0, [&](int p0, int p1) {
+        for (int p = p0; p < p1; p++) {
+            float *row = e->getData() + (size_t)p * e->stride();
+            if (f == BASIS_FLOAT16) {
+                expandHalf(k, (const uint16_t*)basis + (size_t)p * k,
+                           scales, row);
+            } else {
+                const int8_t *src = (const int8_t*)basis + (size_t)p * k;
+                for (int i = 0; i < k; i++)
+                    row[i] = src[i] * (scales[i] / 127);
+            }
+        }
+    });
+}
+
+ModelFile::~ModelFile(void) {
+    delete mean;
+    delete eigenvalues;
+    delete eigenfaces;
+    delete classWeights;
+    munmap(base, length);
+}
+
+void ModelFile::save(const string &filename,
+                     const EigenfaceModel *model,
+                     const FaceGallery *gallery,
+                     int width, int height,
+                     BasisFormat format) {
+    const Matrix *e = model->getEigenfaces();
+    int n = e->rows();
+    int k = e->cols();
+    int s = gallery == NULL ? 0 : gallery->size();
+    if ((size_t)width * height != (size_t)n)
+        throw "Image size does not match the eigenfaces";
+    if (gallery != NULL && gallery->dimension() != k)
+        throw "Gallery does not match the model";
+    
+    ModelHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.format = format;
+    header.width = width;
+    header.height = height;
+    header.length = n;
+    header.dimension = k;
+    header.subjects = s;
+    header.images = model->getCount();
+    header.meanOffset = alignUp(sizeof(ModelHeader));
+    header.eigenvalueOffset = alignUp(header.meanOffset + (size_t)n * sizeof(float));
+    header.scaleOffset = alignUp(header.eigenvalueOffset + (size_t)k * sizeof(float));
+    header.basisOffset = alignUp(header.scaleOffset + (size_t)k * sizeof(float));
+    header.idOffset = alignUp(header.basisOffset + (size_t)n * k * elementSize(format));
+    header.weightOffset = alignUp(header.idOffset + (size_t)s * sizeof(int32_t));
+    
+    // Each eigenface is scaled by its largest magnitude before quantizing
+    vector<float> scales(k, 1.0f);
+    if (format != BASIS_FLOAT32) {
+        scales.assign(k, 0.0f);
+        for (int p = 0; p < n; p++)
+            for (int i = 0; i < k; i++)
+                scales[i] = std::max(scales[i], std::fabs(e->get(p, i)));
+        for (int i = 0; i < k; i++)
+            if (scales[i] == 0)
+                scales[i] = 1;
+    }
+    
+    ofstream out(filename.c_str(), ios::binary | ios::trunc);
+    if (!out.good())
+        throw "Cannot create model";
+    out.write((const char*)&header, sizeof(header));
+    
+    vector<float> values(n);
+    for (int p = 0; p < n; p++)
+        values[p] = model->getMean()->get(p);
+    pad(out, header.meanOffset);
+    writeFloats(out, values);
+    
+    values.resize(k);
+    for (int i = 0; i < k; i++)
+        values[i] = model->getEigenValues()->get(i);
+    pad(out, header.eigenvalueOffset);
+    writeFloats(out, values);
+    pad(out, header.scaleOffset);
+    writeFloats(out, scales);
+    
+    pad(out, header.basisOffset);
+    vector<unsigned char> row((size_t)k * elementSize(format));
+    for (int p = 0; p < n; p++) {
+        const float *src = e->getData() + (size_t)p * e->stride();
+        for (int i = 0; i < k; i++) {
+            if (format == BASIS_FLOAT32) {
+                memcpy(&row[(size_t)i * sizeof(float)], &src[i], sizeof(float));
+            } else if (format == BASIS_FLOAT16) {
+                uint16_t half = toHalf(src[i] / scales[i]);
+                memcpy(&row[(size_t)i * 2], &half, 2);
+            } else {
+                float q = std::round(127 * src[i] / scales[i]);
+                row[i] = (unsigned char)(int8_t)std::min(127.0f, std::max(-127.0f, q));
+            }
+        }
+        out.write((const char*)row.data(), row.size());
+    }
+    
+    pad(out, header.idOffset);
+    for (int c = 0; c < s; c++) {
+        int32_t id = gallery->getSubject(c)->getID();
+        out.write((const char*)&id, sizeof(id));
+    }
+    pad(out, header.weightOffset);
+    if (s > 0) {
+        const Matrix *w = gallery->getClassWeights();
+        values.resize(s);
+        for (int i = 0; i < k; i++) {
+            for (int c = 0; c < s; c++)
+                values[c] = w->get(i, c);
+            writeFloats(out, values);
+        }
+    }
+    
+    if (!out.good())
+        throw "Cannot write model";
+}
+
+BasisFormat ModelFile::getFormat(void) const {
+    return format;
+}
+
+int ModelFile::getWidth(void) const {
+    return width;
+}
+
+int ModelFile::getHeight(void) const {
+    return height;
+}
+
+int ModelFile::getImageCount(void) const {
+    return imageCount;
+}
+
+int ModelFile::dimension(void) const {
+    return eigenfaces->cols();
+}
+
+int ModelFile::size(void) const {
+    return classWeights->cols();
+}
+
+const ColumnVector* ModelFile::getMean(void) const {
+    return mean;
+}
+
+const Matrix* ModelFile::getEigenfaces(void) const {
+    return eigenfaces;
+}
+
+const ColumnVector* ModelFile::getEigenValues(void) const {
+    return eigenvalues;
+}
+
+const Matrix* ModelFile::getClassWeights(void) const {
+    return classWeights;
+}
+
+int ModelFile::getSubjectID(int index) const {
+    if (index < 0 || index >= size())
+        throw "Index out of bounds";
+    return ids[index];
+}
+
+EigenfaceModel* ModelFile::getModel(void) const {
+    return new EigenfaceModel(mean, eigenfaces, eigenvalues, imageCount);
+}
@@ -0,0 +1,61 @@
+//
+//  NearestNeighborIndex.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <fstream>
+#include <string.h>
+
+#include "NearestNeighborIndex.h"
+#include "NearestNeighborIndex_exact.h"
+#include "NearestNeighborIndex_hnsw.h"
+#include "NearestNeighborIndex_ivfpq.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+NearestNeighborIndex::~NearestNeighborIndex(void) {}
+
+void NearestNeighborIndex::build(const Matrix *vectors) {
+    if (vectors->rows() != dimension())
+        throw "Matrices do not match";
+    
+    float *vector = new float[dimension()];
+    for (int j = 0; j < vectors->cols(); j++) {
+        for (int i = 0; i < dimension(); i++)
+            vector[i] = vectors->get(i, j);
+        add(vector);
+    }
+    delete [] vector;
+}
+
+void NearestNeighborIndex::writeFile(const string &filename) const {
+    ofstream out(filename, ios::binary);
+    if (!out.good())
+        throw "Cannot write index file";
+    write(out);
+    if (!out.good())
+        throw "Cannot write index file";
+}
+
+NearestNeighborIndex* NearestNeighborIndex::load(const string &filename) {
+    ifstream in(filename, ios::binary);
+    if (!in.good())
+        throw "Cannot open index file";
+    
+    char tag[8];
+    readArray(in, tag, 8);
+    if (memcmp(tag, "EFNNEXCT", 8) == 0)
+        return NearestNeighborIndex_exact::read(in);
+    if (memcmp(tag, "EFNNHNSW", 8) == 0)
+        return NearestNeighborIndex_hnsw::read(in);
+    if (memcmp(tag, "EFNNIVPQ", 8) == 0)
+        return NearestNeighborIndex_ivfpq::read(in);
+    throw "Not an index file";
+}
@@ -0,0 +1,89 @@
+//
+//  NearestNeighborIndex_exact.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <algorithm>
+#include <memory>
+#include <stdint.h>
+
+#include "NearestNeighborIndex_exact.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_eigensystems;
+
+NearestNeighborIndex_exact::NearestNeighborIndex_exact(int dimension) {
+    this->dim = dimension;
+}
+
+int NearestNeighborIndex_exact::dimension(void) const {
+    return dim;
+}
+
+int NearestNeighborIndex_exact::size(void) const {
+    return (int)(vectors.size() / dim);
+}
+
+int NearestNeighborIndex_exact::add(const float *vector) {
+    vectors.insert(vectors.end(), vector, vector + dim);
+    return size() - 1;
+}
+
+int NearestNeighborIndex_exact::search(const float *query, int k,
+                                       int *ids, float *distances) const {
+    int n = size();
+    k = std::min(k, n);
+    
+    // Max-heap of the k best so far, on (distance, id)
+    vector<pair<float, int> > best;
+    best.reserve(k + 1);
+    for (int i = 0; i < n; i++) {
+        float d = squaredDistance(dim, query, &vectors[(size_t)i * dim]);
+        if ((int)best.size() < k) {
+            best.push_back(make_pair(d, i));
+            push_heap(best.begin(), best.end());
+        } else if (k > 0 && d < best.front().first) {
+            pop_heap(best.begin(), best.end());
+            best.back() = make_pair(d, i);
+            push_heap(best.begin(), best.end());
+        }
+    }
+    sort_heap(best.begin(), best.end());
+    
+    for (int i = 0; i < k; i++) {
+        ids[i] = best[i].second;
+        if (distances != NULL)
+            distances[i] = best[i].first;
+    }
+    return k;
+}
+
+void NearestNeighborIndex_exact::save(const string &filename) const {
+    writeFile(filename);
+}
+
+void NearestNeighborIndex_exact::write(ostream &out) const {
+    int32_t header[2] = { dim, size() };
+    writeArray(out, "EFNNEXCT", 8);
+    writeArray(out, header, 2);
+    writeArray(out, vectors.data(), vectors.size());
+}
+
+NearestNeighborIndex_exact* NearestNeighborIndex_exact::read(istream &in) {
+    int32_t header[2];
+    readArray(in, header, 2);
+    if (header[0] <= 0 || header[1] < 0)
+        throw "Not an index file";
+    
+    // Owned until the vectors have been read, so that a truncated file
+    //  does not leak it
+    unique_ptr<NearestNeighborIndex_exact> index(new NearestNeighborIndex_exact(header[0]));
+    index->vectors.resize((size_t)header[0] * header[1]);
+    readArray(in, index->vectors.data(), index->vectors.size());
+    return index.release();
+}
@@ -0,0 +1,299 @@
+//
+//  NearestNeighborIndex_hnsw.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <stdint.h>
+
+#include "NearestNeighborIndex_hnsw.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_eigensystems;
+
+namespace {
+    
+    typedef pair<float, int> Candidate;
+    
+    // Nodes visited by the current search, marked with its epoch so that
+    //  the marks never need clearing. One set per thread
+    thread_local vector<unsigned> visitMarks;
+    thread_local unsigned visitEpoch = 0;
+    
+    unsigned startVisit(size_t n) {
+        if (visitMarks.size() < n)
+            visitMarks.resize(n, 0);
+        if (++visitEpoch == 0) {
+            fill(visitMarks.begin(), visitMarks.end(), 0);
+            visitEpoch = 1;
+        }
+        return visitEpoch;
+    }
+}
+
+NearestNeighborIndex_hnsw::NearestNeighborIndex_hnsw(int dimension, int m,
+                                                     int efConstruction)
+    : generator(42) {
+    this->dim = dimension;
+    this->m = std::max(m, 2);
+    this->efConstruction = std::max(efConstruction, this->m);
+    this->efSearch = 64;
+    this->levelMult = 1 / std::log((double)this->m);
+    this->entry = -1;
+    this->maxLevel = -1;
+}
+
+void NearestNeighborIndex_hnsw::setEfSearch(int efSearch) {
+    this->efSearch = std::max(efSearch, 1);
+}
+
+int NearestNeighborIndex_hnsw::dimension(void) const {
+    return dim;
+}
+
+int NearestNeighborIndex_hnsw::size(void) const {
+    return (int)neighbors.size();
+}
+
+const float* NearestNeighborIndex_hnsw::vectorAt(int id) const {
+    return &vectors[(size_t)id * dim];
+}
+
+int NearestNeighborIndex_hnsw::greedy(const float *query, int ep,
+                                      int layer) const {
+    float best = squaredDistance(dim, query, vectorAt(ep));
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        const vector<int> &links = neighbors[ep][layer];
+        for (size_t i = 0; i < links.size(); i++) {
+            float d = squaredDistance(dim, query, vectorAt(links[i]));
+            if (d < best) {
+                best = d;
+                ep = links[i];
+                changed = true;
+            }
+        }
+    }
+    return ep;
+}
+
+vector<Candidate> NearestNeighborIndex_hnsw::searchLayer(const float *query,
+                                                         int ep, int ef,
+                                                         int layer) const {
+    unsigned epoch = startVisit(neighbors.size());
+    
+    // Frontier, nearest on top, and the ef best so far, farthest on top
+    priority_queue<Candidate, vector<Candidate>, greater<Candidate> > frontier;
+    priority_queue<Candidate> best;
+    
+    float d = squaredDistance(dim, query, vectorAt(ep));
+    frontier.push(make_pair(d, ep));
+    best.push(make_pair(d, ep));
+    visitMarks[ep] = epoch;
+    
+    while (!frontier.empty()) {
+        Candidate current = frontier.top();
+        if (current.first > best.top().first && (int)best.size() >= ef)
+            break;
+        frontier.pop();
+        
+        const vector<int> &links = neighbors[current.second][layer];
+        for (size_t i = 0; i < links.size(); i++) {
+            int next = links[i];
+            if (visitMarks[next] == epoch)
+                continue;
+            visitMarks[next] = epoch;
+            
+            d = squaredDistance(dim, query, vectorAt(next));
+            if ((int)best.size() < ef || d < best.top().first) {
+                frontier.push(make_pair(d, next));
+                best.push(make_pair(d, next));
+                if ((int)best.size() > ef)
+                    best.pop();
+            }
+        }
+    }
+    
+    vector<Candidate> result(best.size());
+    for (int i = (int)result.size() - 1; i >= 0; i--) {
+        result[i] = best.top();
+        best.pop();
+    }
+    return result;
+}
+
+vector<int> NearestNeighborIndex_hnsw::selectNeighbors(const vector<Candidate> &candidates,
+                                                       int count) const {
+    // Keep a candidate only if it is nearer to the query than to every
+    //  neighbour kept so far, which spreads the links in all directions
+    vector<int> selected;
+    for (size_t i = 0; i < candidates.size() && (int)selected.size() < count; i++) {
+        const float *x = vectorAt(candidates[i].second);
+        bool keep = true;
+        for (size_t j = 0; j < selected.size() && keep; j++) {
+            if (squaredDistance(dim, x, vectorAt(selected[j])) < candidates[i].first)
+                keep = false;
+        }
+        if (keep)
+            selected.push_back(candidates[i].second);
+    }
+    return selected;
+}
+
+void NearestNeighborIndex_hnsw::shrink(int node, int layer) {
+    vector<int> &links = neighbors[node][layer];
+    int limit = layer == 0 ? 2 * m : m;
+    if ((int)links.size() <= limit)
+        return;
+    
+    vector<Candidate> candidates;
+    for (size_t i = 0; i < links.size(); i++)
+        candidates.push_back(make_pair(squaredDistance(dim, vectorAt(node),
+                                                       vectorAt(links[i])),
+                                       links[i]));
+    sort(candidates.begin(), candidates.end());
+    links = selectNeighbors(candidates, limit);
+}
+
+int NearestNeighborIndex_hnsw::add(const float *vector) {
+    int id = size();
+    vectors.insert(vectors.end(), vector, vector + dim);
+    
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    int level = (int)(-std::log(1.0 - uniform(generator)) * levelMult);
+    neighbors.push_back(std::vector<std::vector<int> >(level + 1));
+    
+    if (entry < 0) {
+        entry = id;
+        maxLevel = level;
+        return id;
+    }
+    
+    int ep = entry;
+    for (int layer = maxLevel; layer > level; layer--)
+        ep = greedy(vector, ep, layer);
+    
+    for (int layer = std::min(level, maxLevel); layer >= 0; layer--) {
+        std::vector<Candidate> found = searchLayer(vector, ep, efConstruction,
+                                                   layer);
+        std::vector<int> links = selectNeighbors(found, m);
+        neighbors[id][layer] = links;
+        for (size_t i = 0; i < links.size(); i++) {
+            neighbors[links[i]][layer].push_back(id);
+            shrink(links[i], layer);
+        }
+        ep = found[0].second;
+    }
+    
+    if (level > maxLevel) {
+        entry = id;
+        maxLevel = level;
+    }
+    return id;
+}
+
+int NearestNeighborIndex_hnsw::search(const float *query, int k,
+                                      int *ids, float *distances) const {
+    if (entry < 0 || k <= 0)
+        return 0;
+    
+    int ep = entry;
+    for (int layer = maxLevel; layer > 0; layer--)
+        ep = greedy(query, ep, layer);
+    vector<Candidate> found = searchLayer(query, ep, std::max(efSearch, k), 0);
+    
+    int count = std::min(k, (int)found.size());
+    for (int i = 0; i < count; i++) {
+        ids[i] = found[i].second;
+        if (distances != NULL)
+            distances[i] = found[i].first;
+    }
+    return count;
+}
+
+void NearestNeighborIndex_hnsw::save(const string &filename) const {
+    writeFile(filename);
+}
+
+void NearestNeighborIndex_hnsw::write(ostream &out) const {
+    int32_t header[7] = { dim, size(), m, efConstruction, efSearch,
+                          entry, maxLevel };
+    writeArray(out, "EFNNHNSW", 8);
+    writeArray(out, header, 7);
+    writeArray(out, &levelMult, 1);
+    writeArray(out, vectors.data(), vectors.size());
+    for (int node = 0; node < size(); node++) {
+        int32_t levels = (int32_t)neighbors[node].size();
+        writeArray(out, &levels, 1);
+        for (int layer = 0; layer < levels; layer++) {
+            const vector<int> &links = neighbors[node][layer];
+            int32_t count = (int32_t)links.size();
+            writeArray(out, &count, 1);
+            writeArray(out, links.data(), links.size());
+        }
+    }
+}
+
+NearestNeighborIndex_hnsw* NearestNeighborIndex_hnsw::read(istream &in) {
+    int32_t header[7];
+    readArray(in, header, 7);
+    if (header[0] <= 0 || header[1] < 0)
+        throw "Not an index file";
+    
+    // Owned until every field has been checked, so that a corrupt file
+    //  does not leak it
+    unique_ptr<NearestNeighborIndex_hnsw> index(
+        new NearestNeighborIndex_hnsw(header[0], header[2], header[3]));
+    int n = header[1];
+    index->efSearch = header[4];
+    index->entry = header[5];
+    index->maxLevel = header[6];
+    readArray(in, &index->levelMult, 1);
+    index->vectors.resize((size_t)n * index->dim);
+    readArray(in, index->vectors.data(), index->vectors.size());
+    
+    index->neighbors.resize(n);
+    for (int node = 0; node < n; node++) {
+        int32_t levels;
+        readArray(in, &levels, 1);
+        if (levels <= 0)
+            throw "Not an index file";
+        index->neighbors[node].resize(levels);
+        for (int layer = 0; layer < levels; layer++) {
+            int32_t count;
+            readArray(in, &count, 1);
+            if (count < 0 || count > n)
+                throw "Not an index file";
+            index->neighbors[node][layer].resize(count);
+            readArray(in, index->neighbors[node][layer].data(), count);
+        }
+    }
+    
+    // Searches follow the links without checks: every link must name a
+    //  node that has the layer it is on, and the entry point must be a
+    //  node of the top layer (or -1 for an empty index)
+    if (n == 0 ? index->entry != -1
+        : index->entry < 0 || index->entry >= n
+          || index->maxLevel != (int)index->neighbors[index->entry].size() - 1)
+        throw "Not an index file";
+    for (int node = 0; node < n; node++) {
+        for (size_t layer = 0; layer < index->neighbors[node].size(); layer++) {
+            const vector<int> &links = index->neighbors[node][layer];
+            for (size_t j = 0; j < links.size(); j++)
+                if (links[j] < 0 || links[j] >= n
+                    || index->neighbors[links[j]].size() <= layer)
+                    throw "Not an index file";
+        }
+    }
+    return index.release();
+}
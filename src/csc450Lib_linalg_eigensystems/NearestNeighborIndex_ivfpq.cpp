@@ -0,0 +1,359 @@
+//
+//  NearestNeighborIndex_ivfpq.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <algorithm>
+#include <cfloat>
+#include <memory>
+#include <random>
+
+#include "NearestNeighborIndex_ivfpq.h"
+#include "MatrixMultiplier.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+namespace {
+    
+    // Lloyd iterations of the k-means runs
+    const int KMEANS_ITERATIONS = 20;
+    
+    // Training points used per centroid, at most
+    const int POINTS_PER_CENTROID = 64;
+    
+    // Points assigned per GEMM while clustering
+    const int ASSIGN_CHUNK = 4096;
+    
+    /**
+     * Clusters the n points of x (d floats each, one after the other) into
+     *  k centroids. Assignments use |x|^2 - 2 x.c + |c|^2 with the dot
+     *  products from one GEMM per chunk of points
+     */
+    void kmeans(const float *x, int n, int d, int k, float *centroids,
+                mt19937 &generator) {
+        vector<int> order(n);
+        for (int i = 0; i < n; i++)
+            order[i] = i;
+        shuffle(order.begin(), order.end(), generator);
+        for (int c = 0; c < k; c++)
+            copy(x + (size_t)order[c] * d, x + (size_t)(order[c] + 1) * d,
+                 centroids + (size_t)c * d);
+        
+        vector<int> label(n);
+        vector<float> norms(k);
+        vector<float> scores((size_t)ASSIGN_CHUNK * k);
+        vector<double> sums((size_t)k * d);
+        vector<int> sizes(k);
+        
+        for (int iter = 0; iter < KMEANS_ITERATIONS; iter++) {
+            for (int c = 0; c < k; c++) {
+                const float *cc = centroids + (size_t)c * d;
+                norms[c] = MatrixMultiplier::dot(d, cc, cc);
+            }
+            for (int i0 = 0; i0 < n; i0 += ASSIGN_CHUNK) {
+                int nb = std::min(ASSIGN_CHUNK, n - i0);
+                MatrixMultiplier::gemm(false, true, nb, k, d,
+                                       1.0f, x + (size_t)i0 * d, d,
+                                       centroids, d,
+                                       0.0f, scores.data(), k);
+                for (int i = 0; i < nb; i++) {
+                    const float *row = &scores[(size_t)i * k];
+                    int best = 0;
+                    float bestScore = FLT_MAX;
+                    for (int c = 0; c < k; c++) {
+                        float score = norms[c] - 2 * row[c];
+                        if (score < bestScore) {
+                            bestScore = score;
+                            best = c;
+                        }
+                    }
+                    label[i0 + i] = best;
+                }
+            }
+            
+            fill(sums.begin(), sums.end(), 0.0);
+            fill(sizes.begin(), sizes.end(), 0);
+            for (int i = 0; i < n; i++) {
+                const float *xi = x + (size_t)i * d;
+                double *sum = &sums[(size_t)label[i] * d];
+                for (int j = 0; j < d; j++)
+                    sum[j] += xi[j];
+                sizes[label[i]]++;
+            }
+            for (int c = 0; c < k; c++) {
+                float *cc = centroids + (size_t)c * d;
+                if (sizes[c] == 0) {
+                    // Empty cluster: restart it on a random point
+                    int i = uniform_int_distribution<int>(0, n - 1)(generator);
+                    copy(x + (size_t)i * d, x + (size_t)(i + 1) * d, cc);
+                    continue;
+                }
+                for (int j = 0; j < d; j++)
+                    cc[j] = (float)(sums[(size_t)c * d + j] / sizes[c]);
+            }
+        }
+    }
+}
+
+NearestNeighborIndex_ivfpq::NearestNeighborIndex_ivfpq(int dimension,
+                                                       int nlist, int msub) {
+    this->dim = dimension;
+    this->nlist = std::max(nlist, 1);
+    this->msub = std::max(1, std::min(msub, dimension));
+    this->dsub = (dimension + this->msub - 1) / this->msub;
+    this->ksub = 256;
+    this->nprobe = 8;
+    this->count = 0;
+    this->trained = false;
+}
+
+void NearestNeighborIndex_ivfpq::setNprobe(int nprobe) {
+    this->nprobe = std::max(nprobe, 1);
+}
+
+int NearestNeighborIndex_ivfpq::dimension(void) const {
+    return dim;
+}
+
+int NearestNeighborIndex_ivfpq::size(void) const {
+    return count;
+}
+
+void NearestNeighborIndex_ivfpq::train(const Matrix *vectors) {
+    if (vectors->rows() != dim)
+        throw "Matrices do not match";
+    int n = vectors->cols();
+    if (n == 0)
+        throw "No vectors to train on";
+    
+    mt19937 generator(42);
+    nlist = std::min(nlist, n);
+    ksub = std::min(256, n);
+    
+    // A random sample is enough to place the centroids
+    int samples = std::min(n, POINTS_PER_CENTROID * std::max(nlist, ksub));
+    vector<int> order(n);
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+    shuffle(order.begin(), order.end(), generator);
+    vector<float> x((size_t)samples * dim);
+    for (int i = 0; i < samples; i++)
+        for (int j = 0; j < dim; j++)
+            x[(size_t)i * dim + j] = vectors->get(j, order[i]);
+    
+    coarse.assign((size_t)nlist * dim, 0);
+    kmeans(x.data(), samples, dim, nlist, coarse.data(), generator);
+    
+    // Residuals to the coarse centroids, cut into zero-padded sub-vectors
+    //  and clustered sub-space by sub-space
+    vector<float> sub((size_t)samples * dsub);
+    codebooks.assign((size_t)msub * ksub * dsub, 0);
+    vector<int> lists(samples);
+    for (int i = 0; i < samples; i++)
+        lists[i] = assign(&x[(size_t)i * dim]);
+    for (int s = 0; s < msub; s++) {
+        for (int i = 0; i < samples; i++) {
+            const float *c = &coarse[(size_t)lists[i] * dim];
+            for (int j = 0; j < dsub; j++) {
+                int col = s * dsub + j;
+                sub[(size_t)i * dsub + j] = col < dim
+                    ? x[(size_t)i * dim + col] - c[col] : 0;
+            }
+        }
+        kmeans(sub.data(), samples, dsub, ksub,
+               &codebooks[(size_t)s * ksub * dsub], generator);
+    }
+    
+    listIds.assign(nlist, vector<int>());
+    listCodes.assign(nlist, vector<uint8_t>());
+    count = 0;
+    trained = true;
+}
+
+void NearestNeighborIndex_ivfpq::build(const Matrix *vectors) {
+    train(vectors);
+    NearestNeighborIndex::build(vectors);
+}
+
+int NearestNeighborIndex_ivfpq::assign(const float *x) const {
+    int best = 0;
+    float bestDist = FLT_MAX;
+    for (int c = 0; c < nlist; c++) {
+        float d = squaredDistance(dim, x, &coarse[(size_t)c * dim]);
+        if (d < bestDist) {
+            bestDist = d;
+            best = c;
+        }
+    }
+    return best;
+}
+
+int NearestNeighborIndex_ivfpq::add(const float *vector) {
+    if (!trained)
+        throw "Index is not trained";
+    
+    int list = assign(vector);
+    const float *c = &coarse[(size_t)list * dim];
+    std::vector<float> residual((size_t)msub * dsub, 0);
+    for (int j = 0; j < dim; j++)
+        residual[j] = vector[j] - c[j];
+    
+    for (int s = 0; s < msub; s++) {
+        const float *r = &residual[(size_t)s * dsub];
+        const float *book = &codebooks[(size_t)s * ksub * dsub];
+        int best = 0;
+        float bestDist = FLT_MAX;
+        for (int w = 0; w < ksub; w++) {
+            float d = squaredDistance(dsub, r, book + (size_t)w * dsub);
+            if (d < bestDist) {
+                bestDist = d;
+                best = w;
+            }
+        }
+        listCodes[list].push_back((uint8_t)best);
+    }
+    listIds[list].push_back(count);
+    return count++;
+}
+
+int NearestNeighborIndex_ivfpq::search(const float *query, int k,
+                                       int *ids, float *distances) const {
+    if (!trained || k <= 0)
+        return 0;
+    
+    // The nprobe lists with the nearest centroids
+    int probes = std::min(nprobe, nlist);
+    vector<pair<float, int> > lists(nlist);
+    for (int c = 0; c < nlist; c++)
+        lists[c] = make_pair(squaredDistance(dim, query, &coarse[(size_t)c * dim]), c);
+    partial_sort(lists.begin(), lists.begin() + probes, lists.end());
+    
+    vector<float> residual((size_t)msub * dsub, 0);
+    vector<float> table((size_t)msub * ksub);
+    vector<pair<float, int> > best;
+    best.reserve(k + 1);
+    
+    for (int p = 0; p < probes; p++) {
+        int list = lists[p].second;
+        const float *c = &coarse[(size_t)list * dim];
+        for (int j = 0; j < dim; j++)
+            residual[j] = query[j] - c[j];
+        
+        // Distances from each sub-vector of the residual to each codeword
+        for (int s = 0; s < msub; s++) {
+            const float *r = &residual[(size_t)s * dsub];
+            const float *book = &codebooks[(size_t)s * ksub * dsub];
+            float *row = &table[(size_t)s * ksub];
+            for (int w = 0; w < ksub; w++) {
+                const float *word = book + (size_t)w * dsub;
+                float d = 0;
+                for (int j = 0; j < dsub; j++)
+                    d += (r[j] - word[j]) * (r[j] - word[j]);
+                row[w] = d;
+            }
+        }
+        
+        const vector<int> &members = listIds[list];
+        const uint8_t *codes = listCodes[list].data();
+        for (size_t i = 0; i < members.size(); i++) {
+            const uint8_t *code = codes + i * msub;
+            float d = 0;
+            for (int s = 0; s < msub; s++)
+                d += table[(size_t)s * ksub + code[s]];
+            
+            if ((int)best.size() < k) {
+                best.push_back(make_pair(d, members[i]));
+                push_heap(best.begin(), best.end());
+            } else if (d < best.front().first) {
+                pop_heap(best.begin(), best.end());
+                best.back() = make_pair(d, members[i]);
+                push_heap(best.begin(), best.end());
+            }
+        }
+    }
+    sort_heap(best.begin(), best.end());
+    
+    for (size_t i = 0; i < best.size(); i++) {
+        ids[i] = best[i].second;
+        if (distances != NULL)
+            distances[i] = best[i].first;
+    }
+    return (int)best.size();
+}
+
+void NearestNeighborIndex_ivfpq::save(const string &filename) const {
+    writeFile(filename);
+}
+
+void NearestNeighborIndex_ivfpq::write(ostream &out) const {
+    int32_t header[8] = { dim, nlist, msub, dsub, ksub, nprobe, count,
+                          trained ? 1 : 0 };
+    writeArray(out, "EFNNIVPQ", 8);
+    writeArray(out, header, 8);
+    writeArray(out, coarse.data(), coarse.size());
+    writeArray(out, codebooks.data(), codebooks.size());
+    for (size_t list = 0; list < listIds.size(); list++) {
+        int32_t size = (int32_t)listIds[list].size();
+        writeArray(out, &size, 1);
+        writeArray(out, listIds[list].data(), listIds[list].size());
+        writeArray(out, listCodes[list].data(), listCodes[list].size());
+    }
+}
+
+NearestNeighborIndex_ivfpq* NearestNeighborIndex_ivfpq::read(istream &in) {
+    int32_t header[8];
+    readArray(in, header, 8);
+    if (header[0] <= 0 || header[1] <= 0 || header[2] <= 0
+        || header[3] <= 0 || header[4] <= 0 || header[4] > 256
+        || header[5] <= 0 || header[6] < 0)
+        throw "Not an index file";
+    
+    // Owned until the whole file has been read, so that a truncated or
+    //  corrupt one does not leak it
+    unique_ptr<NearestNeighborIndex_ivfpq> index(
+        new NearestNeighborIndex_ivfpq(header[0], header[1], header[2]));
+    
+    // The sub-vectors must tile the whole vector, as the constructor lays
+    //  them out, or search() runs off the end of its residual
+    if (header[1] != index->nlist || header[2] != index->msub
+        || header[3] != index->dsub)
+        throw "Not an index file";
+    index->dsub = header[3];
+    index->ksub = header[4];
+    index->nprobe = header[5];
+    index->count = header[6];
+    index->trained = header[7] != 0;
+    if (!index->trained)
+        return index.release();
+    
+    index->coarse.resize((size_t)index->nlist * index->dim);
+    readArray(in, index->coarse.data(), index->coarse.size());
+    index->codebooks.resize((size_t)index->msub * index->ksub * index->dsub);
+    readArray(in, index->codebooks.data(), index->codebooks.size());
+    index->listIds.resize(index->nlist);
+    index->listCodes.resize(index->nlist);
+    for (int list = 0; list < index->nlist; list++) {
+        int32_t size;
+        readArray(in, &size, 1);
+        if (size < 0 || size > index->count)
+            throw "Not an index file";
+        index->listIds[list].resize(size);
+        readArray(in, index->listIds[list].data(), size);
+        for (int i = 0; i < size; i++)
+            if (index->listIds[list][i] < 0 || index->listIds[list][i] >= index->count)
+                throw "Not an index file";
+        index->listCodes[list].resize((size_t)size * index->msub);
+        readArray(in, index->listCodes[list].data(), index->listCodes[list].size());
+        for (size_t c = 0; c < index->listCodes[list].size(); c++)
+            if (index->listCodes[list][c] >= index->ksub)
+                throw "Not an index file";
+    }
+    return index.release();
+}
@@ -0,0 +1,57 @@
+//
+//  SingularValueDecomposition.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include "SingularValueDecomposition.h"
+
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+SingularValueDecomposition::SingularValueDecomposition(Matrix *u,
+                                                       ColumnVector *s,
+                                                       Matrix *v) {
+    this->rank = s->rows();
+    this->u = u;
+    this->s = s;
+    this->v = v;
+}
+
+SingularValueDecomposition::~SingularValueDecomposition(void) {
+    delete u;
+    delete s;
+    delete v;
+}
+
+int SingularValueDecomposition::getRank(void) const {
+    return rank;
+}
+
+Matrix* SingularValueDecomposition::getU(void) const {
+    return u;
+}
+
+ColumnVector* SingularValueDecomposition::getSingularValues(void) const {
+    return s;
+}
+
+Matrix* SingularValueDecomposition::getV(void) const {
+    return v;
+}
+
+float SingularValueDecomposition::getSingularValue(int index) const {
+    return s->get(index);
+}
+
+ColumnVector* SingularValueDecomposition::getLeftSingularVector(int index) const {
+    return u->getColumn(index);
+}
+
+ColumnVector* SingularValueDecomposition::getRightSingularVector(int index) const {
+    return v->getColumn(index);
+}
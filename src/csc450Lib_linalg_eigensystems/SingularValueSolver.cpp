@@ -0,0 +1,223 @@
+//
+//  SingularValueSolver.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#include "SingularValueSolver.h"
+#include "MatrixMultiplier.h"
+#include "TaskScheduler.h"
+
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+namespace {
+    
+    // Maximum number of Jacobi sweeps before giving up
+    const int MAX_SWEEPS = 60;
+    
+    // Rows are handed out to threads only when there are this many
+    //  multiply-adds to share, so that small problems stay serial
+    const double PARALLEL_WORK = 1 << 20;
+    
+    /**
+     * Runs body(i) for i in [begin, end) on the task scheduler when work
+     *  (total multiply-adds) is large enough
+     */
+    template <class Body>
+    void parallelFor(int begin, int end, double work, Body body) {
+        int grain = work >= PARALLEL_WORK ? 0 : end - begin;
+        TaskScheduler::parallelFor(begin, end, grain, [&](int b, int e) {
+            for (int i = b; i < e; i++)
+                body(i);
+        });
+    }
+    
+    double dot(int n, const double *x, const double *y) {
+        double sum = 0;
+        for (int i = 0; i < n; i++)
+            sum += x[i] * y[i];
+        return sum;
+    }
+}
+
+SingularValueSolver::SingularValueSolver(const Matrix *a) {
+    this->a = a;
+}
+
+const SingularValueDecomposition* SingularValueSolver::solve(void) const {
+    return thinSVD(a);
+}
+
+void SingularValueSolver::triangularize(int m, int n, float *x, int ldx,
+                                        double *w) {
+    for (int i = 0; i < n * n; i++)
+        w[i] = 0;
+    
+    for (int j = 0; j < n; j++) {
+        float *xj = x + (size_t)j * ldx + j;
+        int len = m - j;
+        
+        // Householder vector v = x - alpha * e1 sending column j to alpha * e1
+        float norm = std::sqrt(MatrixMultiplier::dot(len, xj, xj));
+        if (norm == 0) {
+            for (int i = j + 1; i < n; i++)
+                w[(size_t)i * n + j] = x[(size_t)i * ldx + j];
+            continue;
+        }
+        float alpha = xj[0] > 0 ? -norm : norm;
+        float vnorm2 = 2 * norm * (norm + std::abs(xj[0]));
+        xj[0] -= alpha;
+        w[(size_t)j * n + j] = alpha;
+        
+        // Reflect the remaining columns: x_i -= 2 (v . x_i) / (v . v) v
+        parallelFor(j + 1, n, (double)(n - j - 1) * len, [&](int i) {
+            float *xi = x + (size_t)i * ldx + j;
+            float f = 2 * MatrixMultiplier::dot(len, xj, xi) / vnorm2;
+            for (int r = 0; r < len; r++)
+                xi[r] -= f * xj[r];
+            w[(size_t)i * n + j] = xi[0];
+        });
+    }
+}
+
+bool SingularValueSolver::jacobi(int n, double *w, double *v) {
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            v[(size_t)i * n + j] = (i == j);
+    
+    // Round-robin ordering: each round pairs every row with another one,
+    //  so the rotations of a round touch disjoint rows and can run in
+    //  parallel. An odd number of rows gets a dummy partner
+    int players = n + (n % 2);
+    std::vector<int> order(players);
+    for (int i = 0; i < players; i++)
+        order[i] = i;
+    
+    for (int sweep = 0; sweep < MAX_SWEEPS; sweep++) {
+        std::atomic<int> rotations(0);
+        
+        for (int round = 0; round < players - 1; round++) {
+            parallelFor(0, players / 2, 3.0 * n * players, [&](int k) {
+                int p = std::min(order[k], order[players - 1 - k]);
+                int q = std::max(order[k], order[players - 1 - k]);
+                if (q >= n)
+                    return;
+                double *wp = w + (size_t)p * n;
+                double *wq = w + (size_t)q * n;
+                double alpha = dot(n, wp, wp);
+                double beta = dot(n, wq, wq);
+                double gamma = dot(n, wp, wq);
+                if (std::abs(gamma) <= 1e-15 * std::sqrt(alpha * beta))
+                    return;
+                
+                double zeta = (beta - alpha) / (2 * gamma);
+                double t = (zeta >= 0 ? 1 : -1) /
+                    (std::abs(zeta) + std::sqrt(1 + zeta * zeta));
+                double c = 1 / std::sqrt(1 + t * t);
+                double s = c * t;
+                
+                double *vp = v + (size_t)p * n;
+                double *vq = v + (size_t)q * n;
+                for (int i = 0; i < n; i++) {
+                    double x = wp[i], y = wq[i];
+                    wp[i] = c * x - s * y;
+                    wq[i] = s * x + c * y;
+                    x = vp[i];
+                    y = vq[i];
+                    vp[i] = c * x - s * y;
+                    vq[i] = s * x + c * y;
+                }
+                rotations++;
+            });
+            
+            // Keep the first player fixed and rotate the others
+            int last = order[players - 1];
+            for (int i = players - 1; i > 1; i--)
+                order[i] = order[i - 1];
+            if (players > 1)
+                order[1] = last;
+        }
+        
+        if (rotations == 0)
+            return true;
+    }
+    return false;
+}
+
+SingularValueDecomposition* SingularValueSolver::tallSVD(const Matrix *a) {
+    int m = a->rows();
+    int n = a->cols();
+    
+    // Work on the columns of a as contiguous rows
+    Matrix *x = (Matrix*)Matrix::transpose(a);
+    double *w = new double[(size_t)n * n];
+    double *v = new double[(size_t)n * n];
+    triangularize(m, n, x->getData(), x->stride(), w);
+    delete x;
+    
+    if (!jacobi(n, w, v))
+        cout << "No convergence\n";
+    
+    // Singular values are the norms of the orthogonalized rows
+    std::vector<double> sigma(n);
+    std::vector<int> index(n);
+    for (int i = 0; i < n; i++) {
+        sigma[i] = std::sqrt(dot(n, w + (size_t)i * n, w + (size_t)i * n));
+        index[i] = i;
+    }
+    std::sort(index.begin(), index.end(), [&](int i, int j) {
+        return sigma[i] > sigma[j];
+    });
+    
+    double tol = n > 0 ? sigma[index[0]] * std::max(m, n) * FLT_EPSILON : 0;
+    int rank = 0;
+    while (rank < n && sigma[index[rank]] > tol)
+        rank++;
+    
+    // V, and V * inverse(S) for the product giving U
+    Matrix *vr = new Matrix(n, rank);
+    Matrix *scaled = new Matrix(n, rank);
+    ColumnVector *s = new ColumnVector(rank);
+    for (int k = 0; k < rank; k++) {
+        int i = index[k];
+        s->set(k, sigma[i]);
+        for (int j = 0; j < n; j++) {
+            vr->set(j, k, v[(size_t)i * n + j]);
+            scaled->set(j, k, v[(size_t)i * n + j] / sigma[i]);
+        }
+    }
+    delete [] w;
+    delete [] v;
+    
+    Matrix *u = Matrix::multiply(a, scaled);
+    delete scaled;
+    
+    return new SingularValueDecomposition(u, s, vr);
+}
+
+SingularValueDecomposition* SingularValueSolver::thinSVD(const Matrix *a) {
+    if (a->rows() >= a->cols())
+        return tallSVD(a);
+    
+    // A = U S transpose(V) if and only if transpose(A) = V S transpose(U)
+    const Matrix *at = Matrix::transpose(a);
+    SingularValueDecomposition *svd = tallSVD(at);
+    delete at;
+    
+    SingularValueDecomposition *swapped =
+        new SingularValueDecomposition(Matrix::copyOf(svd->getV()),
+                                       (ColumnVector*)Matrix::copyOf(svd->getSingularValues()),
+                                       Matrix::copyOf(svd->getU()));
+    delete svd;
+    return swapped;
+}
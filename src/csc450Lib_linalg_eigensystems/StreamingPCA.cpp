@@ -0,0 +1,336 @@
+//
+//  StreamingPCA.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+//=================================
+// included dependencies
+#include <cfloat>
+#include <cmath>
+
+#include "StreamingPCA.h"
+#include "GetPixels.h"
+#include "MatrixGenerator.h"
+#include "MatrixMultiplier.h"
+#include "EigenSystem.h"
+#include "EigenSystemSolver.h"
+#include "SingularValueSolver.h"
+
+using namespace csc450Lib_linalg_base;
+using namespace csc450Lib_linalg_eigensystems;
+
+StreamingPCA::StreamingPCA(const vector<string> &files, size_t memoryBudget,
+                           StreamingPCAMode mode, int width, int height) {
+    this->files = files;
+    this->width = width;
+    this->height = height;
+    this->pixels = height * height;
+    this->memoryBudget = memoryBudget;
+    this->mode = mode;
+    this->oversampling = 10;
+    this->powerIterations = 2;
+    this->imagesRead = 0;
+    this->mean = NULL;
+    this->eigenfaces = NULL;
+    this->eigenvalues = NULL;
+}
+
+StreamingPCA::~StreamingPCA(void) {
+    delete mean;
+    delete eigenfaces;
+    delete eigenvalues;
+}
+
+void StreamingPCA::setOversampling(int oversampling) {
+    this->oversampling = oversampling;
+}
+
+void StreamingPCA::setPowerIterations(int powerIterations) {
+    this->powerIterations = powerIterations;
+}
+
+ColumnVector* StreamingPCA::getMean(void) const {
+    return mean;
+}
+
+Matrix* StreamingPCA::getEigenfaces(void) const {
+    return eigenfaces;
+}
+
+ColumnVector* StreamingPCA::getEigenValues(void) const {
+    return eigenvalues;
+}
+
+long StreamingPCA::getImagesRead(void) const {
+    return imagesRead;
+}
+
+void StreamingPCA::loadBlock(int first, int count, Matrix *block,
+                             bool center) {
+    for (int i = 0; i < count; i++) {
+        float *row = block->getData() + (size_t)i * block->stride();
+        if (!GetPixels::readPixelSquare(files[first + i], row, width, height))
+            throw "Cannot read image";
+        if (center) {
+            const float *mu = mean->getData();
+            for (int p = 0; p < pixels; p++)
+                row[p] -= mu[p];
+        }
+    }
+    imagesRead += count;
+}
+
+int StreamingPCA::blockSize(size_t fixed, size_t perImage) const {
+    if (fixed >= memoryBudget || memoryBudget - fixed < perImage)
+        throw "Memory budget too small";
+    size_t count = (memoryBudget - fixed) / perImage;
+    return (int)std::min(count, files.size());
+}
+
+void StreamingPCA::train(int k) {
+    if (files.empty())
+        throw "No images to train on";
+    k = std::min(k, (int)files.size());
+    
+    delete mean;
+    delete eigenfaces;
+    delete eigenvalues;
+    mean = NULL;
+    eigenfaces = NULL;
+    eigenvalues = NULL;
+    imagesRead = 0;
+    
+    if (mode == GRAM_TILES)
+        trainGram(k);
+    else
+        trainSketch(k);
+}
+
+void StreamingPCA::trainGram(int k) {
+    int m = (int)files.size();
+    size_t n = pixels;
+    
+    // Gram matrix, its eigensolve (double workspace and vectors), the
+    //  average face, the eigenfaces and a small streaming block are fixed;
+    //  the rest of the budget caches a panel of centered images
+    int s = std::min(16, m);
+    size_t fixed = (size_t)m * m * (sizeof(float) * 3 + sizeof(double))
+        + (n + n * k + n * s) * sizeof(float);
+    int c = blockSize(fixed, n * sizeof(float));
+    int numPanels = (m + c - 1) / c;
+    Matrix *panel = new Matrix(c, pixels);
+    Matrix *block = new Matrix(s, pixels);
+    
+    // First pass: the average face. The last panel stays in the cache, to
+    //  be centered once the mean is known
+    int last = (numPanels - 1) * c;
+    mean = new ColumnVector(pixels);
+    auto accumulate = [&](const Matrix *images, int count) {
+        for (int i = 0; i < count; i++) {
+            const float *row = images->getData() + (size_t)i * images->stride();
+            for (int p = 0; p < pixels; p++)
+                mean->getData()[p] += row[p];
+        }
+    };
+    for (int j0 = 0; j0 < last; j0 += s) {
+        int nb = std::min(s, last - j0);
+        loadBlock(j0, nb, block, false);
+        accumulate(block, nb);
+    }
+    loadBlock(last, m - last, panel, false);
+    accumulate(panel, m - last);
+    mean->scaleInPlace(1.0f / m);
+    const float *mu = mean->getData();
+    for (int i = 0; i < m - last; i++) {
+        float *row = panel->getData() + (size_t)i * panel->stride();
+        for (int p = 0; p < pixels; p++)
+            row[p] -= mu[p];
+    }
+    
+    // Gram passes: upper tiles of L = transpose(A) * A, last panel first.
+    //  Each panel in the cache gets its own tile, then the images before
+    //  it stream past it in small blocks; each image is read once per
+    //  later panel, so the whole computation reads the gallery once when
+    //  it fits in the cache
+    Matrix *gram = new Matrix(m, m);
+    for (int pi = numPanels - 1; pi >= 0; pi--) {
+        int i0 = pi * c;
+        int ni = std::min(c, m - i0);
+        if (pi < numPanels - 1)
+            loadBlock(i0, ni, panel, true);
+        MatrixMultiplier::gemm(false, true, ni, ni, pixels,
+                               1.0f, panel->getData(), panel->stride(),
+                               panel->getData(), panel->stride(),
+                               0.0f, gram->getData() + (size_t)i0 * m + i0, m);
+        for (int j0 = 0; j0 < i0; j0 += s) {
+            int nj = std::min(s, i0 - j0);
+            loadBlock(j0, nj, block, true);
+            MatrixMultiplier::gemm(false, true, nj, ni, pixels,
+                                   1.0f, block->getData(), block->stride(),
+                                   panel->getData(), panel->stride(),
+                                   0.0f, gram->getData() + (size_t)j0 * m + i0, m);
+        }
+    }
+    MatrixMultiplier::symmetrize(m, gram->getData(), m);
+    
+    EigenSystem *system;
+    if (2 * k < m)
+        system = EigenSystemSolver::solveTopK(gram, k, 1e-5f);
+    else
+        system = EigenSystemSolver::symmetricQR(gram);
+    delete gram;
+    
+    // Drop the directions the centered images do not span
+    float tol = std::abs(system->getEigenValue(0)) * m * FLT_EPSILON;
+    int rank = 0;
+    while (rank < k && system->getEigenValue(rank) > tol)
+        rank++;
+    
+    // Eigenface i is A * v_i / sqrt(lambda_i)
+    Matrix *coefficients = new Matrix(m, rank);
+    eigenvalues = new ColumnVector(rank);
+    const Matrix *v = system->getEigenVectors();
+    for (int i = 0; i < rank; i++) {
+        float lambda = system->getEigenValue(i);
+        eigenvalues->set(i, lambda);
+        for (int j = 0; j < m; j++)
+            coefficients->set(j, i, v->get(j, i) / std::sqrt(lambda));
+    }
+    delete system;
+    
+    // Last pass: accumulate the eigenfaces, the first panel straight from
+    //  the cache and the images after it block by block
+    eigenfaces = new Matrix(pixels, rank);
+    auto project = [&](const Matrix *images, int j0, int count) {
+        MatrixMultiplier::gemm(true, false, pixels, rank, count,
+                               1.0f, images->getData(), images->stride(),
+                               coefficients->getData() + (size_t)j0 * coefficients->stride(),
+                               coefficients->stride(),
+                               1.0f, eigenfaces->getData(), eigenfaces->stride());
+    };
+    if (rank > 0) {
+        int first = std::min(c, m);
+        project(panel, 0, first);
+        for (int j0 = first; j0 < m; j0 += s) {
+            int nb = std::min(s, m - j0);
+            loadBlock(j0, nb, block, true);
+            project(block, j0, nb);
+        }
+    }
+    delete coefficients;
+    delete panel;
+    delete block;
+}
+
+void StreamingPCA::trainSketch(int k) {
+    int m = (int)files.size();
+    size_t n = pixels;
+    int l = std::min(m, k + oversampling);
+    
+    // Sketch (twice, when refined), projections and their SVD (a
+    //  transposed copy, V and the double Jacobi workspace), the average
+    //  face and the eigenfaces are fixed; each image of a block costs its
+    //  pixels and its row of the random test matrix
+    size_t fixed = (n * l * (powerIterations > 0 ? 2 : 1) + n + n * k)
+        * sizeof(float)
+        + (size_t)m * l * sizeof(float) * 4 + (size_t)l * l * sizeof(double) * 2;
+    int b = blockSize(fixed, (n + l) * sizeof(float));
+    Matrix *block = new Matrix(b, pixels);
+    Matrix *omega = new Matrix(b, l);
+    
+    // First pass: the average face and the sketch Y = X * Omega of the raw
+    //  images, kept transposed so that its columns are contiguous rows
+    mean = new ColumnVector(pixels);
+    Matrix *sketch = new Matrix(l, pixels);
+    ColumnVector *omegaSum = new ColumnVector(l);
+    for (int j0 = 0; j0 < m; j0 += b) {
+        int nb = std::min(b, m - j0);
+        loadBlock(j0, nb, block, false);
+        MatrixGenerator::randomize(omega);
+        for (int i = 0; i < nb; i++) {
+            const float *row = block->getData() + (size_t)i * block->stride();
+            for (int p = 0; p < pixels; p++)
+                mean->getData()[p] += row[p];
+            for (int c = 0; c < l; c++) {
+                omega->set(i, c, omega->get(i, c) - 0.5f);
+                omegaSum->set(c, omegaSum->get(c) + omega->get(i, c));
+            }
+        }
+        MatrixMultiplier::gemm(true, false, l, pixels, nb,
+                               1.0f, omega->getData(), omega->stride(),
+                               block->getData(), block->stride(),
+                               1.0f, sketch->getData(), sketch->stride());
+    }
+    mean->scaleInPlace(1.0f / m);
+    delete omega;
+    
+    // Center the sketch, (X - mean) * Omega = X * Omega - mean * sum(Omega),
+    //  and take an orthonormal basis Q of its range
+    for (int c = 0; c < l; c++) {
+        float *row = sketch->getData() + (size_t)c * sketch->stride();
+        float s = omegaSum->get(c);
+        for (int p = 0; p < pixels; p++)
+            row[p] -= s * mean->getData()[p];
+    }
+    delete omegaSum;
+    EigenSystemSolver::orthonormalizeRows(sketch);
+    
+    // Subspace iteration, one pass each: Y = A * transpose(A) * Q, summed
+    //  image by image as a_j * (transpose(a_j) * Q)
+    Matrix *projections = new Matrix(l, m);
+    Matrix *next = powerIterations > 0 ? new Matrix(l, pixels) : NULL;
+    for (int q = 0; q < powerIterations; q++) {
+        for (int j0 = 0; j0 < m; j0 += b) {
+            int nb = std::min(b, m - j0);
+            loadBlock(j0, nb, block, true);
+            float *bj = projections->getData() + j0;
+            MatrixMultiplier::gemm(false, true, l, nb, pixels,
+                                   1.0f, sketch->getData(), sketch->stride(),
+                                   block->getData(), block->stride(),
+                                   0.0f, bj, projections->stride());
+            MatrixMultiplier::gemm(false, false, l, pixels, nb,
+                                   1.0f, bj, projections->stride(),
+                                   block->getData(), block->stride(),
+                                   j0 == 0 ? 0.0f : 1.0f,
+                                   next->getData(), next->stride());
+        }
+        Matrix *swap = sketch;
+        sketch = next;
+        next = swap;
+        EigenSystemSolver::orthonormalizeRows(sketch);
+    }
+    delete next;
+    
+    // Last pass: the projections B = transpose(Q) * A of the centered
+    //  images onto that basis
+    for (int j0 = 0; j0 < m; j0 += b) {
+        int nb = std::min(b, m - j0);
+        loadBlock(j0, nb, block, true);
+        MatrixMultiplier::gemm(false, true, l, nb, pixels,
+                               1.0f, sketch->getData(), sketch->stride(),
+                               block->getData(), block->stride(),
+                               0.0f, projections->getData() + j0,
+                               projections->stride());
+    }
+    delete block;
+    
+    // A ~ Q * B = (Q * U_B) * S * transpose(V)
+    SingularValueDecomposition *svd = SingularValueSolver::thinSVD(projections);
+    delete projections;
+    int rank = std::min(k, svd->getRank());
+    
+    eigenvalues = new ColumnVector(rank);
+    for (int i = 0; i < rank; i++)
+        eigenvalues->set(i, svd->getSingularValue(i) * svd->getSingularValue(i));
+    eigenfaces = new Matrix(pixels, rank);
+    if (rank > 0)
+        MatrixMultiplier::gemm(true, false, pixels, rank, l,
+                               1.0f, sketch->getData(), sketch->stride(),
+                               svd->getU()->getData(), svd->getU()->stride(),
+                               0.0f, eigenfaces->getData(), eigenfaces->stride());
+    delete svd;
+    delete sketch;
+}
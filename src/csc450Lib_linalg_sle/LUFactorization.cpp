@@ -0,0 +1,202 @@
+//
+//  LUFactorization.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "LUFactorization.h"
+#include "LinearSolver_LU.h"
+#include "MatrixMultiplier.h"
+#include "TaskScheduler.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_sle;
+using namespace csc450Lib_linalg_base;
+
+LUFactorization::LUFactorization(const Matrix *a) {
+    if (a->rows() != a->cols())
+        throw "Matrix is not square";
+    this->a = a;
+    this->lu = Matrix::copyOf(a);
+    this->pivots = vector<int>(a->rows());
+    this->singular = !LinearSolver_LU::factorizeInPlace(lu, pivots.data());
+}
+
+LUFactorization::~LUFactorization(void) {
+    delete lu;
+}
+
+int LUFactorization::size(void) const {
+    return lu->rows();
+}
+
+bool LUFactorization::isSingular(void) const {
+    return singular;
+}
+
+const Matrix* LUFactorization::getFactors(void) const {
+    return lu;
+}
+
+const int* LUFactorization::getPivots(void) const {
+    return pivots.data();
+}
+
+float LUFactorization::determinant(void) const {
+    // Det(A) = det(L) * det(U), and every row swap changes its sign
+    float det = 1;
+    for (int i = 0; i < size(); i++) {
+        if (pivots[i] != i)
+            det = -det;
+        det *= lu->get(i, i);
+    }
+    return det;
+}
+
+void LUFactorization::solveInPlace(Matrix *b) const {
+    int n = size();
+    if (b->rows() != n)
+        throw "Matrices do not match";
+    if (singular)
+        throw "Matrix is singular";
+
+    float *d = b->getData();
+    int ld = b->stride();
+    int r = b->cols();
+
+    // Apply the row swaps, then L * Y = B and U * X = Y
+    for (int i = 0; i < n; i++) {
+        if (pivots[i] != i)
+            std::swap_ranges(d + (size_t)i * ld, d + (size_t)i * ld + r,
+                             d + (size_t)pivots[i] * ld);
+    }
+    MatrixMultiplier::trsm(false, false, true, n, r,
+                           lu->getData(), lu->stride(), d, ld);
+    MatrixMultiplier::trsm(true, false, false, n, r,
+                           lu->getData(), lu->stride(), d, ld);
+}
+
+void LUFactorization::refine(const Matrix *b, Matrix *x, int steps) const {
+    if (steps <= 0)
+        return;
+
+    int n = size();
+    int r = b->cols();
+    Matrix *residual = new Matrix(n, r);
+    for (int s = 0; s < steps; s++) {
+        // residual = b - A x, then x += inverse(A) * residual
+        Matrix::copyInto(b, residual);
+        MatrixMultiplier::gemm(false, false, n, r, n,
+                               -1.0f, a->getData(), a->stride(),
+                               x->getData(), x->stride(),
+                               1.0f, residual->getData(), residual->stride());
+        solveInPlace(residual);
+        for (int i = 0; i < n; i++) {
+            float *xi = x->getData() + (size_t)i * x->stride();
+            const float *ri = residual->getData() + (size_t)i * residual->stride();
+            for (int j = 0; j < r; j++)
+                xi[j] += ri[j];
+        }
+    }
+    delete residual;
+}
+
+Matrix* LUFactorization::solve(const Matrix *b, int refinementSteps) const {
+    Matrix *x = Matrix::copyOf(b);
+    solveInPlace(x);
+    refine(b, x, refinementSteps);
+    return x;
+}
+
+ColumnVector* LUFactorization::solve(const ColumnVector *b,
+                                     int refinementSteps) const {
+    ColumnVector *x = new ColumnVector(b->rows());
+    Matrix::copyInto(b, x);
+    solveInPlace(x);
+    refine(b, x, refinementSteps);
+    return x;
+}
+
+int LUFactorization::solveMixed(const double *b, double *x,
+                               double tolerance, int maxSteps) const {
+    int n = size();
+    if (singular)
+        throw "Matrix is singular";
+    if (tolerance <= 0)
+        tolerance = sqrt((double)n) * DBL_EPSILON;
+
+    // |A| and |b|, infinity norms
+    double normA = 0;
+    double normB = 0;
+    for (int i = 0; i < n; i++) {
+        const float *ai = a->getData() + (size_t)i * a->stride();
+        double row = 0;
+        for (int j = 0; j < n; j++)
+            row += std::abs(ai[j]);
+        normA = std::max(normA, row);
+        normB = std::max(normB, std::abs(b[i]));
+    }
+
+    // First solution, all in single precision
+    ColumnVector *correction = new ColumnVector(n);
+    for (int i = 0; i < n; i++)
+        correction->set(i, (float)b[i]);
+    solveInPlace(correction);
+    for (int i = 0; i < n; i++)
+        x[i] = correction->get(i);
+
+    std::vector<double> residual(n);
+    int steps = -1;
+    for (int step = 0; step <= maxSteps; step++) {
+        // residual = b - A x, accumulated in double
+        TaskScheduler::parallelFor(0, n, 64, [&](int i0, int i1) {
+            for (int i = i0; i < i1; i++) {
+                const float *ai = a->getData() + (size_t)i * a->stride();
+                double sum = b[i];
+                for (int j = 0; j < n; j++)
+                    sum -= (double)ai[j] * x[j];
+                residual[i] = sum;
+            }
+        });
+
+        double normR = 0;
+        double normX = 0;
+        for (int i = 0; i < n; i++) {
+            normR = std::max(normR, std::abs(residual[i]));
+            normX = std::max(normX, std::abs(x[i]));
+        }
+        if (normR <= tolerance * (normA * normX + normB)) {
+            steps = step;
+            break;
+        }
+        if (step == maxSteps)
+            break;
+
+        // x += inverse(A) * residual, with the float factors
+        for (int i = 0; i < n; i++)
+            correction->set(i, (float)residual[i]);
+        solveInPlace(correction);
+        for (int i = 0; i < n; i++)
+            x[i] += correction->get(i);
+    }
+
+    delete correction;
+    return steps;
+}
+
+Matrix* LUFactorization::inverse(int refinementSteps) const {
+    int n = size();
+    Matrix *identity = new Matrix(n, n);
+    for (int i = 0; i < n; i++)
+        identity->set(i, i, 1);
+
+    Matrix *inverse = solve(identity, refinementSteps);
+    delete identity;
+    return inverse;
+}
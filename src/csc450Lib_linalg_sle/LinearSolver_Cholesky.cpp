@@ -0,0 +1,138 @@
+//
+//  LinearSolver_Cholesky.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+#include <cmath>
+#include <cstring>
+
+#include "LinearSolver_Cholesky.h"
+#include "MatrixMultiplier.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_sle;
+using namespace csc450Lib_linalg_base;
+
+namespace {
+
+    // Diagonal blocks this small are factorized directly
+    const int CHOLESKY_LEAF = 32;
+
+    /**
+     * Factorizes the w x w diagonal block of a starting at (c0, c0), which
+     *  has been updated by every row above it
+     *
+     * Recursive: factorize the upper left half into U11, solve for the
+     *  block U12 = inverse(transpose(U11)) * A12 to its right, subtract
+     *  transpose(U12) * U12 from the lower right half with SYRK, then
+     *  factorize that half
+     */
+    bool factorizeBlock(Matrix *a, int c0, int w) {
+        float *d = a->getData();
+        int ld = a->stride();
+
+        if (w <= CHOLESKY_LEAF) {
+            int end = c0 + w;
+            for (int j = c0; j < end; j++) {
+                float *rj = d + (size_t)j * ld;
+                float ajj = rj[j];
+                if (!(ajj > 0))
+                    return false;
+
+                // Row j of U, and its update of the rows below
+                float ujj = sqrt(ajj);
+                float s = 1.0f / ujj;
+                rj[j] = ujj;
+                for (int k = j + 1; k < end; k++)
+                    rj[k] *= s;
+                for (int i = j + 1; i < end; i++) {
+                    float *ri = d + (size_t)i * ld;
+                    float uji = rj[i];
+                    for (int k = i; k < end; k++)
+                        ri[k] -= uji * rj[k];
+                }
+            }
+            return true;
+        }
+
+        int w1 = w / 2;
+        int w2 = w - w1;
+        int c1 = c0 + w1;
+        if (!factorizeBlock(a, c0, w1))
+            return false;
+
+        // U12 = inverse(transpose(U11)) * A12
+        MatrixMultiplier::trsm(true, true, false, w1, w2,
+                               d + (size_t)c0 * ld + c0, ld,
+                               d + (size_t)c0 * ld + c1, ld);
+
+        // A22 -= transpose(U12) * U12, upper triangle only
+        MatrixMultiplier::syrk(w2, w1, -1.0f,
+                               d + (size_t)c0 * ld + c1, ld,
+                               1.0f, d + (size_t)c1 * ld + c1, ld);
+
+        return factorizeBlock(a, c1, w2);
+    }
+}
+
+bool LinearSolver_Cholesky::factorizeInPlace(Matrix *a) {
+    if (a->rows() != a->cols())
+        throw "Matrix is not square";
+    int n = a->rows();
+    if (!factorizeBlock(a, 0, n))
+        return false;
+
+    // SYRK may leave partial sums below the diagonal
+    for (int i = 1; i < n; i++)
+        memset(a->getData() + (size_t)i * a->stride(), 0, i * sizeof(float));
+    return true;
+}
+
+void LinearSolver_Cholesky::solveInPlace(const Matrix *u, Matrix *b) {
+    int n = u->rows();
+    if (b->rows() != n)
+        throw "Matrices do not match";
+
+    // transpose(U) * y = b, then U * x = y
+    MatrixMultiplier::trsm(true, true, false, n, b->cols(),
+                           u->getData(), u->stride(),
+                           b->getData(), b->stride());
+    MatrixMultiplier::trsm(true, false, false, n, b->cols(),
+                           u->getData(), u->stride(),
+                           b->getData(), b->stride());
+}
+
+const LinearSystemRecord* LinearSolver_Cholesky::solve(void) const {
+    if (a->rows() < a->cols())
+        return new LinearSystemRecord(REGULAR_MATRIX, NULL);
+    if (a->rows() != a->cols() || a->rows() != b->rows())
+        return new LinearSystemRecord(LINEAR_SOLVER_FAILED, NULL);
+
+    // Don't alter a
+    Matrix *u = Matrix::copyOf(a);
+    if (!factorizeInPlace(u)) {
+        delete u;
+        return new LinearSystemRecord(LINEAR_SOLVER_FAILED, NULL);
+    }
+
+    ColumnVector *x = new ColumnVector(b->rows());
+    Matrix::copyInto(b, x);
+    solveInPlace(u, x);
+    delete u;
+
+    return new LinearSystemRecord(LINEAR_SOLVER_SUCCEEDED, x);
+}
+
+const LinearSystemRecord* LinearSolver_Cholesky::solve(const ColumnVector *b) {
+    setRightSideTerm(b);
+    return solve();
+}
+
+const LinearSystemRecord* LinearSolver_Cholesky::solve(const Matrix *a,
+                                                       const ColumnVector *b) {
+    setSLE(a, b);
+    return solve();
+}
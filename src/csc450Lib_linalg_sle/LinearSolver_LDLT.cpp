@@ -0,0 +1,285 @@
+//
+//  LinearSolver_LDLT.cpp
+//
+//
+//  Created on 10/17/26.
+//
+//
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "LinearSolver_LDLT.h"
+#include "MatrixMultiplier.h"
+
+using namespace std;
+using namespace csc450Lib_linalg_sle;
+using namespace csc450Lib_linalg_base;
+
+namespace {
+
+    // Bunch-Kaufman threshold, (1 + sqrt(17)) / 8, which bounds element
+    //  growth as tightly as complete pivoting would
+    const float BUNCH_KAUFMAN_ALPHA = 0.6403882f;
+
+    // Columns per panel. The trailing matrix is updated once per panel
+    const int LDLT_PANEL = 64;
+
+    // Rows of the trailing matrix per GEMM in the panel update
+    const int LDLT_UPDATE_ROWS = 256;
+
+    /**
+     * Factorizes up to nb columns of the n x n matrix at d, starting at
+     *  column k0, and returns how many were done (one less when a 2 x 2
+     *  block would not fit). Entry (i, j) of the lower triangle is read at
+     *  d[j * ld + i], so that columns of L are contiguous.
+     *
+     * The trailing matrix is not touched: each column is brought up to date
+     *  only when it is needed, from the columns of L already computed and
+     *  the matching columns of W = L D (rows of w, ldw apart), so that the
+     *  caller can then apply the whole panel with GEMM
+     */
+    int factorizePanel(float *d, int ld, int n, int k0, int nb,
+                       float *w, int ldw, int *pivots, float *offDiagonal,
+                       bool &regular) {
+        // Column j of the lower triangle, from row j down
+        auto col = [d, ld](int j) { return d + (size_t)j * ld; };
+        
+        // Column j of the trailing matrix, updated for the panel so far
+        auto update = [&](float *dst, int k, int j, int p1) {
+            for (int p = 0; p < p1; p++) {
+                float s = w[(size_t)p * ldw + j];
+                const float *lp = col(k0 + p);
+                for (int i = k; i < n; i++)
+                    dst[i] -= lp[i] * s;
+            }
+        };
+
+        bool last = n - k0 <= nb;
+        int k = k0;
+        while (k < n && (last || k - k0 < nb - 1)) {
+            int jj = k - k0;
+            float *wk = w + (size_t)jj * ldw;
+            float *wn = wk + ldw;
+            std::copy(col(k) + k, col(k) + n, wk + k);
+            update(wk, k, k, jj);
+
+            // Largest entry below the diagonal in column k
+            float absakk = std::abs(wk[k]);
+            int imax = k;
+            float colmax = 0;
+            for (int i = k + 1; i < n; i++) {
+                if (std::abs(wk[i]) > colmax) {
+                    colmax = std::abs(wk[i]);
+                    imax = i;
+                }
+            }
+
+            int step = 1;
+            int kp = k;
+            if (std::max(absakk, colmax) == 0) {
+                // Column k is already zero: nothing to eliminate
+                regular = false;
+            } else if (absakk < BUNCH_KAUFMAN_ALPHA * colmax) {
+                // Bring column imax up to date, and find its largest
+                //  off-diagonal entry
+                for (int i = k; i < imax; i++)
+                    wn[i] = col(i)[imax];
+                std::copy(col(imax) + imax, col(imax) + n, wn + imax);
+                update(wn, k, imax, jj);
+                float rowmax = 0;
+                for (int i = k; i < n; i++)
+                    if (i != imax)
+                        rowmax = std::max(rowmax, std::abs(wn[i]));
+
+                if (absakk * rowmax >= BUNCH_KAUFMAN_ALPHA * colmax * colmax) {
+                    kp = k;
+                } else if (std::abs(wn[imax]) >= BUNCH_KAUFMAN_ALPHA * rowmax) {
+                    kp = imax;
+                    std::copy(wn + k, wn + n, wk + k);
+                } else {
+                    kp = imax;
+                    step = 2;
+                }
+            }
+
+            int kk = k + step - 1;
+            if (kp != kk) {
+                // Move the column kk, not yet updated, to position kp of
+                //  the trailing matrix; the pivot column is in W already
+                col(kp)[kp] = col(kk)[kk];
+                for (int j = kk + 1; j < kp; j++)
+                    col(j)[kp] = col(kk)[j];
+                std::copy(col(kk) + kp + 1, col(kk) + n, col(kp) + kp + 1);
+
+                // Swap rows kk and kp of L and W, so that columns already
+                //  computed follow their rows
+                for (int j = 0; j < kk; j++)
+                    std::swap(col(j)[kk], col(j)[kp]);
+                for (int p = 0; p <= jj + step - 1; p++)
+                    std::swap(w[(size_t)p * ldw + kk], w[(size_t)p * ldw + kp]);
+            }
+            pivots[k] = k;
+            pivots[kk] = kp;
+
+            float *ck = col(k);
+            if (step == 1) {
+                float dkk = wk[k];
+                float s = dkk == 0 ? 0 : 1.0f / dkk;
+                ck[k] = dkk;
+                for (int i = k + 1; i < n; i++)
+                    ck[i] = wk[i] * s;
+                offDiagonal[k] = 0;
+            } else {
+                // L = W * inverse(D) for the 2 x 2 block D
+                float *ck1 = col(k + 1);
+                float d11 = wk[k];
+                float d21 = wk[k + 1];
+                float d22 = wn[k + 1];
+                float det = d11 * d22 - d21 * d21;
+                for (int i = k + 2; i < n; i++) {
+                    ck[i] = (wk[i] * d22 - wn[i] * d21) / det;
+                    ck1[i] = (wn[i] * d11 - wk[i] * d21) / det;
+                }
+                ck[k] = d11;
+                ck[k + 1] = 0;
+                ck1[k + 1] = d22;
+                offDiagonal[k] = d21;
+                offDiagonal[k + 1] = 0;
+            }
+            k += step;
+        }
+        return k - k0;
+    }
+}
+
+bool LinearSolver_LDLT::factorizeInPlace(Matrix *a, int *pivots,
+                                         float *offDiagonal) {
+    if (a->rows() != a->cols())
+        throw "Matrix is not square";
+    int n = a->rows();
+    float *d = a->getData();
+    int ld = a->stride();
+    bool regular = true;
+
+    // W = L D for the current panel, one row per column of the panel (a
+    //  2 x 2 block may need one more). Kept per thread, so that repeated
+    //  factorizations, as in Rayleigh iteration, do not allocate
+    static thread_local std::vector<float> w;
+    int ldw = std::max(n, 1);
+    if (w.size() < (size_t)(LDLT_PANEL + 1) * ldw)
+        w.resize((size_t)(LDLT_PANEL + 1) * ldw);
+
+    for (int k0 = 0; k0 < n; ) {
+        int kb = factorizePanel(d, ld, n, k0, LDLT_PANEL, w.data(), ldw,
+                                pivots, offDiagonal, regular);
+        int k = k0 + kb;
+
+        // A22 -= L21 * transpose(W21), over the lower triangle of A22
+        //  (held as an upper triangle, row by row)
+        for (int j0 = k; j0 < n; j0 += LDLT_UPDATE_ROWS) {
+            int jb = std::min(LDLT_UPDATE_ROWS, n - j0);
+            MatrixMultiplier::gemm(true, false, jb, n - j0, kb,
+                                   -1.0f, w.data() + j0, ldw,
+                                   d + (size_t)k0 * ld + j0, ld,
+                                   1.0f, d + (size_t)j0 * ld + j0, ld);
+        }
+        k0 = k;
+    }
+    return regular;
+}
+
+void LinearSolver_LDLT::solveInPlace(const Matrix *ldl, const int *pivots,
+                                     const float *offDiagonal, Matrix *b) {
+    int n = ldl->rows();
+    if (b->rows() != n)
+        throw "Matrices do not match";
+    const float *d = ldl->getData();
+    int ld = ldl->stride();
+    float *x = b->getData();
+    int ldx = b->stride();
+    int r = b->cols();
+
+    // P b
+    for (int i = 0; i < n; i++) {
+        if (pivots[i] != i)
+            std::swap_ranges(x + (size_t)i * ldx, x + (size_t)i * ldx + r,
+                             x + (size_t)pivots[i] * ldx);
+    }
+
+    // L z = P b, with transpose(L) stored in the upper triangle
+    MatrixMultiplier::trsm(true, true, true, n, r, d, ld, x, ldx);
+
+    // D y = z, one 1 x 1 or 2 x 2 block at a time
+    for (int i = 0; i < n; i++) {
+        float *xi = x + (size_t)i * ldx;
+        float d11 = d[(size_t)i * ld + i];
+        if (offDiagonal[i] == 0) {
+            float s = 1.0f / d11;
+            for (int c = 0; c < r; c++)
+                xi[c] *= s;
+        } else {
+            float *xj = xi + ldx;
+            float d21 = offDiagonal[i];
+            float d22 = d[(size_t)(i + 1) * ld + i + 1];
+            float det = d11 * d22 - d21 * d21;
+            for (int c = 0; c < r; c++) {
+                float y1 = (xi[c] * d22 - xj[c] * d21) / det;
+                float y2 = (xj[c] * d11 - xi[c] * d21) / det;
+                xi[c] = y1;
+                xj[c] = y2;
+            }
+            i++;
+        }
+    }
+
+    // transpose(L) (P x) = y
+    MatrixMultiplier::trsm(true, false, true, n, r, d, ld, x, ldx);
+
+    // x = transpose(P) (P x)
+    for (int i = n - 1; i >= 0; i--) {
+        if (pivots[i] != i)
+            std::swap_ranges(x + (size_t)i * ldx, x + (size_t)i * ldx + r,
+                             x + (size_t)pivots[i] * ldx);
+    }
+}
+
+const LinearSystemRecord* LinearSolver_LDLT::solve(void) const {
+    if (a->rows() < a->cols())
+        return new LinearSystemRecord(REGULAR_MATRIX, NULL);
+    if (a->rows() != a->cols() || a->rows() != b->rows())
+        return new LinearSystemRecord(LINEAR_SOLVER_FAILED, NULL);
+
+    // Don't alter a
+    int n = a->rows();
+    Matrix *ldl = Matrix::copyOf(a);
+    int *pivots = new int[n];
+    float *offDiagonal = new float[n];
+
+    const LinearSystemRecord *result;
+    if (!factorizeInPlace(ldl, pivots, offDiagonal)) {
+        result = new LinearSystemRecord(LINEAR_SOLVER_FAILED, NULL);
+    } else {
+        ColumnVector *x = new ColumnVector(n);
+        Matrix::copyInto(b, x);
+        solveInPlace(ldl, pivots, offDiagonal, x);
+        result = new LinearSystemRecord(LINEAR_SOLVER_SUCCEEDED, x);
+    }
+
+    delete ldl;
+    delete[] pivots;
+    delete[] offDiagonal;
+    return result;
+}
+
+const LinearSystemRecord* LinearSolver_LDLT::solve(const ColumnVector *b) {
+    setRightSideTerm(b);
+    return solve();
+}
+
+const LinearSystemRecord* LinearSolver_LDLT::solve(const Matrix *a,
+                                                   const ColumnVector *b) {
+    setSLE(a, b);
+    return solve();
+}
@@ -6,12 +6,112 @@
 //
 //
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "LinearSolver_LU.h"
+#include "LUFactorization.h"
+#include "MatrixMultiplier.h"
+#include "TaskScheduler.h"
 
 using namespace std;
 using namespace csc450Lib_linalg_sle;
 using namespace csc450Lib_linalg_base;
 
+namespace {
+    
+    // Column panels this narrow are factorized directly
+    const int LU_LEAF = 16;
+    
+    /**
+     * Factorizes columns [c0, c0 + w) of the n x n matrix a, rows c0 and
+     *  below, with partial pivoting. Pivot rows are swapped whole, which
+     *  also applies the swaps to L on the left and to the columns not
+     *  factorized yet on the right
+     *
+     * Recursive (Toledo): factorize the left half, solve for the block of
+     *  U to its right, update the lower right block with one GEMM, then
+     *  factorize the right half. Every level works on blocks that halve in
+     *  size, so the recursion adapts to any cache without tuning
+     */
+    bool factorizeColumns(Matrix *a, int c0, int w, int *pivots) {
+        int n = a->rows();
+        float *d = a->getData();
+        int ld = a->stride();
+        
+        if (w <= LU_LEAF) {
+            bool regular = true;
+            int end = c0 + w;
+            for (int j = c0; j < end; j++) {
+                // Find the largest pivot in column j
+                int p = j;
+                float max = std::abs(d[(size_t)j * ld + j]);
+                for (int i = j + 1; i < n; i++) {
+                    float v = std::abs(d[(size_t)i * ld + j]);
+                    if (v > max) {
+                        max = v;
+                        p = i;
+                    }
+                }
+                pivots[j] = p;
+                if (p != j)
+                    std::swap_ranges(d + (size_t)p * ld, d + (size_t)p * ld + n,
+                                     d + (size_t)j * ld);
+                
+                float ujj = d[(size_t)j * ld + j];
+                if (ujj == 0) {
+                    regular = false;
+                    continue;
+                }
+                
+                // Multipliers, and their update of the rest of the panel
+                float s = 1.0f / ujj;
+                const float *rj = d + (size_t)j * ld;
+                for (int i = j + 1; i < n; i++) {
+                    float *ri = d + (size_t)i * ld;
+                    float lij = ri[j] * s;
+                    ri[j] = lij;
+                    for (int k = j + 1; k < end; k++)
+                        ri[k] -= lij * rj[k];
+                }
+            }
+            return regular;
+        }
+        
+        int w1 = w / 2;
+        int w2 = w - w1;
+        int c1 = c0 + w1;
+        bool regular = factorizeColumns(a, c0, w1, pivots);
+        
+        // U12 = inverse(L11) * A12
+        MatrixMultiplier::trsm(false, false, true, w1, w2,
+                               d + (size_t)c0 * ld + c0, ld,
+                               d + (size_t)c0 * ld + c1, ld);
+        
+        // A22 -= L21 * U12
+        MatrixMultiplier::gemm(false, false, n - c1, w2, w1,
+                               -1.0f, d + (size_t)c1 * ld + c0, ld,
+                               d + (size_t)c0 * ld + c1, ld,
+                               1.0f, d + (size_t)c1 * ld + c1, ld);
+        
+        return factorizeColumns(a, c1, w2, pivots) && regular;
+    }
+}
+
+LinearSolver_LU::LinearSolver_LU(void) {
+    this->mixedPrecision = false;
+    this->tolerance = 0;
+    this->maxRefinements = 30;
+}
+
+void LinearSolver_LU::setMixedPrecision(bool enabled, double tolerance,
+                                        int maxRefinements) {
+    this->mixedPrecision = enabled;
+    this->tolerance = tolerance;
+    this->maxRefinements = maxRefinements;
+}
+
 const Matrix* LinearSolver_LU::factorize(const Matrix *a) const {
     // Upper triangular component
     Matrix *u = new Matrix(a->rows(), a->cols());
@@ -67,224 +167,67 @@ const Matrix* LinearSolver_LU::factorize(const Matrix *a) const {
     return ret;
 }
 
-const int* LinearSolver_LU::partPivot(Matrix *a) const {
-    int n = a->cols();
-    
-    ColumnVector *v = new ColumnVector(n);
-    
-    // Upper triangular component
-    Matrix *u = new Matrix(n, n);
-    
-    // Lower triangular component
-    Matrix *l = new Matrix(n, n);
-    
-    // Intermediary matrix
-    Matrix *lu = new Matrix(n, n);
-    
-    // Create array of row indices
-    int *pivoted = new int[n+1];
-    for (int i = 0; i < n; i++) {
-        pivoted[i] = i;
-    }
-    pivoted[n] = 1;
-    
-    // For all rows of matrix A
-    for (int i = 0; i < n; i++) {
-        float max = 0;
-        for (int j = 0; j < n; j++) {
-            if (abs(a->get(i, j)) > max) {
-                max = abs(a->get(i, j));
-            }
-        }
-        v->set(i, max);
-    }
-    
-    // For all columns of matrix A
-    for (int j = 0; j < n; j++) {
-        // For all elements above the diagonal
-        for (int i = 0; i < j; i++) {
-            float uij = a->get(i, j);
-            for (int k = 0; k <= i - 1; k++) {
-                uij -= l->get(i, k) * u->get(k, j);
-            }
-            u->set(i, j, uij);
-        }
-        
-        // For all elements on or below the diagonal
-        for (int i = j; i < n; i++) {
-            float luij = a->get(i, j);
-            for (int k = 0; k <= j - 1; k++) {
-                luij -= l->get(i, k) * u->get(k, j);
-            }
-            lu->set(i, j, luij);
-        }
-        
-        // Determine i*
-        int istar = j;
-        float abslu = 0;
-        for (int i = j; i < n; i++) {
-            if (abs(lu->get(i,j))/v->get(i) > abslu) {
-                abslu = abs(lu->get(i,j))/v->get(i);
-                istar = i;
-            }
-        }
-        
-        // Swap rows
-        if (istar != j) {
-            a->swapRows(istar, j);
-            l->swapRows(istar, j);
-            u->swapRows(istar, j);
-            lu->swapRows(istar, j);
-            
-            // Record swapping
-            int temp = pivoted[j];
-            pivoted[j] = pivoted[istar];
-            pivoted[istar] = temp;
-            
-            // For determinant
-            pivoted[n] *= -1;
-        }
-        
-        u->set(j, j, lu->get(j, j));
-        
-        float s = u->get(j, j) == 0 ? 0 : 1.0f / u->get(j, j);
-        
-        // For all elements below the (possibly new) diagonal
-        for (int i = j + 1; i < n; i++) {
-            l->set(i, j, s * lu->get(i, j));
-        }
-    }
-    
-    // Overwrite a with LU
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (i > j)
-                a->set(i, j, l->get(i, j));
-            else
-                a->set(i, j, u->get(i, j));
-        }
-    }
-    
-    return pivoted;
-}
-
 
-const ColumnVector*  LinearSolver_LU::backsubstitute(const Matrix *u, const ColumnVector *y) const {
-    ColumnVector *x = new ColumnVector(u->cols());
-    
-    int n = u->cols();
-    
-    x->set(n-1, y->get(n-1) / u->get(n-1, n-1));
-    
-    for (int i = n-2; i >= 0; i--) {
-        float val = y->get(i);
-        for (int j = i + 1; j < n; j++) {
-            val -= u->get(i, j) * x->get(j);
-        }
-        val /= u->get(i, i);
-        x->set(i, val);
-    }
-    
-    return x;
+bool LinearSolver_LU::factorizeInPlace(Matrix *a, int *pivots) {
+    if (a->rows() != a->cols())
+        throw "Matrix is not square";
+    if (a->rows() == 0)
+        return true;
+    return factorizeColumns(a, 0, a->cols(), pivots);
 }
 
-const ColumnVector* LinearSolver_LU::forwardsubstitute(const Matrix *l, const ColumnVector *b) const {
-    ColumnVector *y= new ColumnVector(l->cols());
-    
-    int n = l->cols();
+void LinearSolver_LU::solveInPlace(const Matrix *lu, const int *pivots,
+                                   ColumnVector *b) {
+    int n = lu->rows();
     
-    y->set(0, b->get(0));
-    
-    for (int i = 1; i < n; i++) {
-        float val = b->get(i);
-        for (int j = 0; j <= i-1; j++) {
-            if (i == j)
-                val -= y->get(j);
-            else
-                val -= l->get(i, j) * y->get(j);
+    // Apply the row swaps
+    for (int i = 0; i < n; i++) {
+        if (pivots[i] != i) {
+            float temp = b->get(i);
+            b->set(i, b->get(pivots[i]));
+            b->set(pivots[i], temp);
         }
-        y->set(i, val);
     }
     
-    return y;
-    
-}
-
-const ColumnVector* LinearSolver_LU::error(const Matrix *a,
-                                           const ColumnVector *x,
-                                           const ColumnVector *b) const {
-    ColumnVector *bhat = (ColumnVector*)Matrix::multiply(a, x);
-    ColumnVector *err = (ColumnVector*)Matrix::subtract(bhat, b);
-    
-    return err;
-}
-
-const ColumnVector* LinearSolver_LU::improve(const Matrix *lu,
-                                             const ColumnVector *x,
-                                             const ColumnVector *err) const {
-    
-    // Use forward and backsubstitution to produce delta x
-    const ColumnVector *y = forwardsubstitute(lu, err);
-    const ColumnVector *dx = backsubstitute(lu, y);
-    
-    return (ColumnVector*)Matrix::subtract(x, dx);
+    // L * y = b, L with unit diagonal, then U * x = y
+    MatrixMultiplier::trsm(false, false, true, n, 1,
+                           lu->getData(), lu->stride(),
+                           b->getData(), b->stride());
+    MatrixMultiplier::trsm(true, false, false, n, 1,
+                           lu->getData(), lu->stride(),
+                           b->getData(), b->stride());
 }
 
 const LinearSystemRecord* LinearSolver_LU::solve(void) const {
-    LinearSystemRecord *resultRecord = new LinearSystemRecord(UNKNOWN_STATUS, NULL);
-    
-    if (a->rows() < a->cols()) {
-        resultRecord = new LinearSystemRecord(REGULAR_MATRIX, NULL);
-    } else if (a->rows() != b->rows()) {
-        resultRecord = new LinearSystemRecord(LINEAR_SOLVER_FAILED, NULL);
-    } else {
-        // Don't alter a
-        Matrix *lu = Matrix::copyOf(a);
-        
-        // Pivoted b
-        const ColumnVector *pb = new ColumnVector(b->rows());
-        
-        // Step 1:
-        //  Factorize
-        const int *pivoted = partPivot(lu);
-        
-        // Swap rows of b
-        for (int i = 0; i < b->rows(); i++) {
-            pb->set(i, b->get(pivoted[i]));
-        }
-        
-        // Step 2:
-        //  Solve
-        //      L * y = b
-        //  Using forward stubstitution
-        const ColumnVector *y = forwardsubstitute(lu, pb);
-        
-        // Step 3:
-        //  Solve
-        //      U * x = y
-        //  Using backsubstitution
-        const ColumnVector *x = backsubstitute(lu, y);
-        
-        // Step 4:
-        //  Iterative improvement
-        for (int i = 0; i < 2; i++) {
-            // Error term
-            const ColumnVector *err = error(a, x, b);
-            
-            // Pivoted error term
-            const ColumnVector *perr = new ColumnVector(err->rows());
-            
-            // Swap rows of err
-            for (int j = 0; j < err->rows(); j++) {
-                perr->set(j, err->get(pivoted[j]));
-            }
-            x = improve(lu, x, perr);
-        }
-        
-        resultRecord = new LinearSystemRecord(LINEAR_SOLVER_SUCCEEDED, x);
+    if (a->rows() < a->cols())
+        return new LinearSystemRecord(REGULAR_MATRIX, NULL);
+    if (a->rows() != a->cols() || a->rows() != b->rows())
+        return new LinearSystemRecord(LINEAR_SOLVER_FAILED, NULL);
+    
+    LUFactorization lu(a);
+    if (lu.isSingular())
+        return new LinearSystemRecord(LINEAR_SOLVER_FAILED, NULL);
+    
+    if (!mixedPrecision) {
+        // Two steps of iterative improvement, in single precision
+        const ColumnVector *x = lu.solve(b, 2);
+        return new LinearSystemRecord(LINEAR_SOLVER_SUCCEEDED, x, 2);
     }
     
-    return resultRecord;
+    // Float factors, double residuals
+    int n = b->rows();
+    vector<double> bd(n);
+    vector<double> xd(n);
+    for (int i = 0; i < n; i++)
+        bd[i] = b->get(i);
+    int steps = lu.solveMixed(bd.data(), xd.data(), tolerance, maxRefinements);
+    
+    ColumnVector *x = new ColumnVector(n);
+    for (int i = 0; i < n; i++)
+        x->set(i, (float)xd[i]);
+    if (steps < 0)
+        return new LinearSystemRecord(ILL_CONDITIONED_MATRIX, x, maxRefinements);
+    return new LinearSystemRecord(LINEAR_SOLVER_SUCCEEDED, x, steps);
 }
 
 const LinearSystemRecord* LinearSolver_LU::solve(const ColumnVector *b)  {
@@ -298,23 +241,7 @@ const LinearSystemRecord* LinearSolver_LU::solve(const Matrix *a, const ColumnVe
 }
 
 float LinearSolver_LU::determinant(void) const {
-    
-    // Don't alter a
-    Matrix *lu = Matrix::copyOf(a);
-    
-    // Step 1:
-    //  Factorize
-    const int *pivoted = partPivot(lu);
-    
-    // Swapping rows changes sign of determinant
-    float det = pivoted[b->rows()];
-    
-    // Det(A) = det(L)*det(U) = sum of diagonal terms in U
-    for (int i = 0; i < lu->rows(); i++) {
-        det *= lu->get(i, i);
-    }
-    
-    return det;
+    return LUFactorization(a).determinant();
 }
 
 float LinearSolver_LU::determinant(const Matrix *a)  {
@@ -324,36 +251,15 @@ float LinearSolver_LU::determinant(const Matrix *a)  {
 
 
 const LinearSystemRecord* LinearSolver_LU::inversion(void) const {
-    LinearSystemRecord *resultRecord = new LinearSystemRecord(UNKNOWN_STATUS, NULL);
-    int n = a->rows();
+    if (a->rows() != a->cols())
+        return new LinearSystemRecord(LINEAR_SOLVER_FAILED, NULL);
     
-    Matrix *inversion = new Matrix(n, n);
-    ColumnVector *b = new ColumnVector(n);
-    
-    // Individual column solution
-    const Matrix *colSol;
-    
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            b->set(j, 0);
-        }
-        b->set(i,1);
-        
-        const LinearSystemRecord *r = solve();
-        if (r->getStatus() != LINEAR_SOLVER_SUCCEEDED) {
-            return r;
-        }
-        
-        colSol = r->getSolution();
-        
-        // Add column to inversion matrix
-        for (int j = 0; j < n; j++) {
-            inversion->set(i,j,colSol->get(j,0));
-        }
-    }
+    // One factorization, then every column of the identity at once
+    LUFactorization lu(a);
+    if (lu.isSingular())
+        return new LinearSystemRecord(LINEAR_SOLVER_FAILED, NULL);
     
-    resultRecord = new LinearSystemRecord(LINEAR_SOLVER_SUCCEEDED, inversion);
-    return resultRecord;
+    return new LinearSystemRecord(LINEAR_SOLVER_SUCCEEDED, lu.inverse());
 }
 
 const LinearSystemRecord* LinearSolver_LU::inversion(const Matrix *a) {
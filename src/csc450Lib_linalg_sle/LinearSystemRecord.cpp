@@ -11,9 +11,11 @@ using namespace csc450Lib_linalg_sle;
 using namespace csc450Lib_linalg_base;
 
 LinearSystemRecord::LinearSystemRecord(const LinearSystemStatus theStatus,
-                                       const Matrix *theSol) {
+                                       const Matrix *theSol,
+                                       int theRefinements) {
     this->theStatus = theStatus;
     this->theSol = theSol;
+    this->theRefinements = theRefinements;
 }
 
 const Matrix* LinearSystemRecord::getSolution() const {
@@ -22,4 +24,8 @@ const Matrix* LinearSystemRecord::getSolution() const {
 
 const LinearSystemStatus LinearSystemRecord::getStatus() const {
     return theStatus;
+}
+
+int LinearSystemRecord::getRefinements() const {
+    return theRefinements;
 }
\ No newline at end of file